@@ -150,6 +150,16 @@ uint8_t lan8720_basic_init(uint8_t addr)
         return 1;
     }
     
+    /* set default pause advertisement */
+    res = lan8720_set_auto_negotiation_advertisement_pause(&gs_handle, LAN8720_BASIC_DEFAULT_PAUSE);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: set auto negotiation advertisement pause failed.\n");
+        (void)lan8720_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
     /* set phy address */
     res = lan8720_set_phy_address(&gs_handle, addr);
     if (res != 0)
@@ -262,3 +272,276 @@ uint8_t lan8720_basic_auto_negotiation(lan8720_speed_indication_t *speed)
     
     return 0;
 }
+
+/**
+ * @brief      basic example poll the auto negotiation
+ * @param[out] *done pointer to a done buffer
+ * @param[out] *speed pointer to a speed indication buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 auto negotiation poll failed
+ * @note       it enables the auto negotiation and never waits, speed is only valid when done is true
+ */
+uint8_t lan8720_basic_auto_negotiation_poll(lan8720_bool_t *done, lan8720_speed_indication_t *speed)
+{
+    uint8_t res;
+    lan8720_bool_t enable;
+    
+    /* get auto negotiation */
+    res = lan8720_get_auto_negotiation(&gs_handle, &enable);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* enable auto negotiation once, writing it again would restart it */
+    if (enable != LAN8720_BOOL_TRUE)
+    {
+        res = lan8720_set_auto_negotiation(&gs_handle, LAN8720_BOOL_TRUE);
+        if (res != 0)
+        {
+            return 1;
+        }
+    }
+    
+    /* get auto negotiation done */
+    res = lan8720_get_auto_negotiation_done(&gs_handle, done);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* the speed indication is only valid once the negotiation is done */
+    if (*done == LAN8720_BOOL_TRUE)
+    {
+        res = lan8720_get_speed_indication(&gs_handle, speed);
+        if (res != 0)
+        {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      basic example resolve the negotiated pause
+ * @param[out] *tx_pause pointer to a transmit pause buffer
+ * @param[out] *rx_pause pointer to a receive pause buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 pause resolve failed
+ * @note       the result follows ieee 802.3 annex 28b and is only valid for a full duplex link,
+ *             it is no pause if the auto negotiation is off or the partner does not negotiate
+ */
+uint8_t lan8720_basic_pause_resolve(lan8720_bool_t *tx_pause, lan8720_bool_t *rx_pause)
+{
+    uint8_t res;
+    uint16_t ability;
+    lan8720_pause_t pause;
+    lan8720_bool_t enable;
+    lan8720_bool_t partner_able;
+    lan8720_bool_t partner_pause;
+    lan8720_bool_t partner_asymmetric;
+    
+    /* no pause without a negotiation, the partner ability register keeps the last one */
+    *tx_pause = LAN8720_BOOL_FALSE;
+    *rx_pause = LAN8720_BOOL_FALSE;
+    res = lan8720_get_auto_negotiation(&gs_handle, &enable);
+    if (res != 0)
+    {
+        return 1;
+    }
+    if (enable == LAN8720_BOOL_FALSE)
+    {
+        return 0;
+    }
+    
+    /* a partner without auto negotiation was found by parallel detection and sent no ability */
+    res = lan8720_get_auto_negotiation_expansion_link_partner_auto_negotiation_able(&gs_handle, &partner_able);
+    if (res != 0)
+    {
+        return 1;
+    }
+    if (partner_able == LAN8720_BOOL_FALSE)
+    {
+        return 0;
+    }
+    
+    /* get local pause advertisement */
+    res = lan8720_get_auto_negotiation_advertisement_pause(&gs_handle, &pause);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* get link partner pause */
+    res = lan8720_get_auto_negotiation_link_partner_ability_pause(&gs_handle, &partner_pause);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* the link partner asymmetric pause is bit 11 of the link partner ability register */
+    res = lan8720_get_reg(&gs_handle, 0x05, &ability);
+    if (res != 0)
+    {
+        return 1;
+    }
+    partner_asymmetric = (lan8720_bool_t)((ability >> 11) & 0x01);
+    
+    /* resolve, table 28b-3 */
+    if ((((uint8_t)pause & LAN8720_PAUSE_SYMMETRIC) != 0) && (partner_pause == LAN8720_BOOL_TRUE))
+    {
+        *tx_pause = LAN8720_BOOL_TRUE;
+        *rx_pause = LAN8720_BOOL_TRUE;
+    }
+    else if ((pause == LAN8720_PAUSE_ASYMMETRIC) && (partner_pause == LAN8720_BOOL_TRUE) &&
+             (partner_asymmetric == LAN8720_BOOL_TRUE))
+    {
+        *tx_pause = LAN8720_BOOL_TRUE;
+    }
+    else if ((pause == LAN8720_PAUSE_BOTH) && (partner_pause == LAN8720_BOOL_FALSE) &&
+             (partner_asymmetric == LAN8720_BOOL_TRUE))
+    {
+        *rx_pause = LAN8720_BOOL_TRUE;
+    }
+    else
+    {
+        /* no pause */
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      basic example get the parallel detection status
+ * @param[out] *fault pointer to a parallel detection fault buffer
+ * @param[out] *partner_auto_negotiation pointer to a link partner auto negotiation able buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get parallel detection failed
+ * @note       reading the fault clears the phy interrupt source flags,
+ *             a partner without auto negotiation is resolved by parallel detection as half duplex
+ */
+uint8_t lan8720_basic_parallel_detection(lan8720_bool_t *fault, lan8720_bool_t *partner_auto_negotiation)
+{
+    uint8_t res;
+    lan8720_bool_t expansion_fault;
+    lan8720_bool_t interrupt_fault;
+    
+    /* get parallel detection fault */
+    res = lan8720_get_auto_negotiation_expansion_parallel_detection_fault(&gs_handle, &expansion_fault);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* get latched parallel detection fault interrupt */
+    res = lan8720_get_interrupt_flag(&gs_handle, LAN8720_INTERRUPT_PARALLEL_DETECTION_FAULT, &interrupt_fault);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    /* get link partner auto negotiation able */
+    res = lan8720_get_auto_negotiation_expansion_link_partner_auto_negotiation_able(&gs_handle, partner_auto_negotiation);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    *fault = ((expansion_fault == LAN8720_BOOL_TRUE) || (interrupt_fault == LAN8720_BOOL_TRUE)) ?
+             LAN8720_BOOL_TRUE : LAN8720_BOOL_FALSE;
+    
+    return 0;
+}
+
+/**
+ * @brief     basic example force the speed and duplex mode
+ * @param[in] speed set speed
+ * @param[in] duplex set duplex mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 force mode failed
+ * @note      auto negotiation is disabled
+ */
+uint8_t lan8720_basic_force_mode(lan8720_speed_t speed, lan8720_duplex_t duplex)
+{
+    uint8_t res;
+    
+    /* disable auto negotiation */
+    res = lan8720_set_auto_negotiation(&gs_handle, LAN8720_BOOL_FALSE);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: set auto negotiation failed.\n");
+        
+        return 1;
+    }
+    
+    /* set speed */
+    res = lan8720_set_speed_select(&gs_handle, speed);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: set speed select failed.\n");
+        
+        return 1;
+    }
+    
+    /* set duplex mode */
+    res = lan8720_set_duplex_mode(&gs_handle, duplex);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: set duplex mode failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      basic example get the symbol error counter
+ * @param[out] *cnt pointer to a counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get symbol error counter failed
+ * @note       the 16 bits counter rolls over
+ */
+uint8_t lan8720_basic_symbol_error_counter(uint16_t *cnt)
+{
+    uint8_t res;
+    
+    /* get symbol error counter */
+    res = lan8720_get_symbol_error_counter(&gs_handle, cnt);
+    if (res != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     basic example set the near end loopback
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set loop back failed
+ * @note      the transmitted frames return to the mac and do not reach the line
+ */
+uint8_t lan8720_basic_loop_back(lan8720_bool_t enable)
+{
+    uint8_t res;
+    
+    /* set loop back */
+    res = lan8720_set_loop_back(&gs_handle, enable);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: set loop back failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
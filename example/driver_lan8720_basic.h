@@ -55,6 +55,7 @@ extern "C"{
  */
 #define LAN8720_BASIC_DEFAULT_SPEED              LAN8720_SPEED_100M        /**< 100Mbs */
 #define LAN8720_BASIC_DEFAULT_DUPLEX_MODE        LAN8720_DUPLEX_FULL       /**< duplex full mode */
+#define LAN8720_BASIC_DEFAULT_PAUSE              LAN8720_PAUSE_BOTH        /**< symmetric and asymmetric pause */
 
 /**
  * @brief     basic example init
@@ -99,6 +100,72 @@ uint8_t lan8720_basic_link_status(lan8720_link_t *status);
  */
 uint8_t lan8720_basic_auto_negotiation(lan8720_speed_indication_t *speed);
 
+/**
+ * @brief      basic example poll the auto negotiation
+ * @param[out] *done pointer to a done buffer
+ * @param[out] *speed pointer to a speed indication buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 auto negotiation poll failed
+ * @note       it enables the auto negotiation and never waits, speed is only valid when done is true
+ */
+uint8_t lan8720_basic_auto_negotiation_poll(lan8720_bool_t *done, lan8720_speed_indication_t *speed);
+
+/**
+ * @brief      basic example resolve the negotiated pause
+ * @param[out] *tx_pause pointer to a transmit pause buffer
+ * @param[out] *rx_pause pointer to a receive pause buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 pause resolve failed
+ * @note       the result follows ieee 802.3 annex 28b and is only valid for a full duplex link,
+ *             it is no pause if the auto negotiation is off or the partner does not negotiate
+ */
+uint8_t lan8720_basic_pause_resolve(lan8720_bool_t *tx_pause, lan8720_bool_t *rx_pause);
+
+/**
+ * @brief      basic example get the parallel detection status
+ * @param[out] *fault pointer to a parallel detection fault buffer
+ * @param[out] *partner_auto_negotiation pointer to a link partner auto negotiation able buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get parallel detection failed
+ * @note       reading the fault clears the phy interrupt source flags,
+ *             a partner without auto negotiation is resolved by parallel detection as half duplex
+ */
+uint8_t lan8720_basic_parallel_detection(lan8720_bool_t *fault, lan8720_bool_t *partner_auto_negotiation);
+
+/**
+ * @brief     basic example force the speed and duplex mode
+ * @param[in] speed set speed
+ * @param[in] duplex set duplex mode
+ * @return    status code
+ *            - 0 success
+ *            - 1 force mode failed
+ * @note      auto negotiation is disabled
+ */
+uint8_t lan8720_basic_force_mode(lan8720_speed_t speed, lan8720_duplex_t duplex);
+
+/**
+ * @brief      basic example get the symbol error counter
+ * @param[out] *cnt pointer to a counter buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get symbol error counter failed
+ * @note       the 16 bits counter rolls over
+ */
+uint8_t lan8720_basic_symbol_error_counter(uint16_t *cnt);
+
+/**
+ * @brief     basic example set the near end loopback
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 set loop back failed
+ * @note      the transmitted frames return to the mac and do not reach the line
+ */
+uint8_t lan8720_basic_loop_back(lan8720_bool_t enable);
+
 /**
  * @}
  */
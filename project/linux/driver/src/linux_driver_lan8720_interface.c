@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      linux_driver_lan8720_interface.c
+ * @brief     linux driver lan8720 interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_lan8720_interface.h"
+#include "delay.h"
+#include "eth.h"
+#include "trace.h"
+#include "vphy.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+/**
+ * @brief  interface smi bus init
+ * @return status code
+ *         - 0 success
+ *         - 1 smi init failed
+ * @note   none
+ */
+uint8_t lan8720_interface_smi_init(void)
+{
+    uint8_t mac[6] = {MAC_ADDR0, MAC_ADDR1, MAC_ADDR2, MAC_ADDR3, MAC_ADDR4, MAC_ADDR5};
+    
+    return eth_init(mac);
+}
+
+/**
+ * @brief  interface smi bus deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 smi deinit failed
+ * @note   none
+ */
+uint8_t lan8720_interface_smi_deinit(void)
+{
+    return eth_deinit();
+}
+
+/**
+ * @brief      interface smi bus read
+ * @param[in]  addr device address
+ * @param[in]  reg register address
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t lan8720_interface_smi_read(uint8_t addr, uint8_t reg, uint16_t *data)
+{
+    uint8_t res;
+    TRACE_BEGIN(TRACE_PROBE_SMI_READ);
+    
+    res = eth_read_phy(addr, reg, data);
+    TRACE_END(TRACE_PROBE_SMI_READ);
+    
+    return res;
+}
+
+/**
+ * @brief     interface smi bus write
+ * @param[in] addr device address
+ * @param[in] reg register address
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t lan8720_interface_smi_write(uint8_t addr, uint8_t reg, uint16_t data)
+{
+    uint8_t res;
+    TRACE_BEGIN(TRACE_PROBE_SMI_WRITE);
+    
+    res = eth_write_phy(addr, reg, data);
+    TRACE_END(TRACE_PROBE_SMI_WRITE);
+    
+    return res;
+}
+
+/**
+ * @brief  interface reset gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio init failed
+ * @note   none
+ */
+uint8_t lan8720_interface_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 reset gpio deinit failed
+ * @note   none
+ */
+uint8_t lan8720_interface_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface reset gpio write
+ * @param[in] level set level
+ * @return    status code
+ *            - 0 success
+ *            - 1 reset gpio write failed
+ * @note      none
+ */
+uint8_t lan8720_interface_reset_gpio_write(uint8_t level)
+{
+    return vphy_reset(level);
+}
+
+/**
+ * @brief     interface delay ms
+ * @param[in] ms time
+ * @note      none
+ */
+void lan8720_interface_delay_ms(uint32_t ms)
+{
+    delay_ms(ms);
+}
+
+/**
+ * @brief     interface print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void lan8720_interface_debug_print(const char *const fmt, ...)
+{
+    va_list args;
+    
+    va_start(args, fmt);
+    (void)vprintf(fmt, args);
+    va_end(args);
+    (void)fflush(stdout);
+}
@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      eth.h
+ * @brief     eth header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef ETH_H
+#define ETH_H
+
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @defgroup eth eth function
+ * @brief    eth function modules
+ * @{
+ */
+
+/**
+ * @brief eth perfect filter multicast address number
+ */
+#define ETH_MULTICAST_PERFECT_CNT        3        /**< MACA1 - MACA3 */
+
+/**
+ * @brief eth mmc counter structure definition
+ */
+typedef struct eth_mmc_s
+{
+    uint32_t tx_good;                    /**< good frames transmitted */
+    uint32_t tx_single_collision;        /**< good frames transmitted after a single collision */
+    uint32_t tx_multiple_collision;      /**< good frames transmitted after more than one collision */
+    uint32_t rx_good_unicast;            /**< good unicast frames received */
+    uint32_t rx_crc_error;               /**< frames received with a crc error */
+    uint32_t rx_alignment_error;         /**< frames received with an alignment error */
+} eth_mmc_t;
+
+/**
+ * @brief     eth init
+ * @param[in] *mac pointer to a mac buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      the virtual mac is wired to the backend opened by vmac.h
+ */
+uint8_t eth_init(uint8_t mac[6]);
+
+/**
+ * @brief  eth deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t eth_deinit(void);
+
+/**
+ * @brief     eth write
+ * @param[in] *tx_buffer pointer to ETH_BufferTypeDef structure
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len set length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 tx ring is full
+ * @note      the frame is sent in interrupt mode and this function doesn't wait for the dma,
+ *            data is given back by HAL_ETH_TxFreeCallback in eth_tx_reclaim
+ */
+uint8_t eth_write(ETH_BufferTypeDef *tx_buffer, void *data, uint32_t len);
+
+/**
+ * @brief  eth reclaim the transmitted tx descriptors
+ * @return status code
+ *         - 0 success
+ *         - 1 reclaim failed
+ * @note   HAL_ETH_TxFreeCallback is called for every transmitted frame
+ */
+uint8_t eth_tx_reclaim(void);
+
+/**
+ * @brief  eth get the tx descriptors in use
+ * @return number of the tx descriptors owned by the pending frames
+ * @note   none
+ */
+uint32_t eth_get_tx_in_use(void);
+
+/**
+ * @brief      eth phy read
+ * @param[in]  addr device address
+ * @param[in]  reg register address
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note
+ */
+uint8_t eth_read_phy(uint8_t addr, uint8_t reg, uint16_t *data);
+
+/**
+ * @brief     eth phy write
+ * @param[in] addr device waddress
+ * @param[in] reg register address
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t eth_write_phy(uint8_t addr, uint8_t reg, uint16_t data);
+
+/**
+ * @brief      eth get the rx missed frame counters
+ * @param[out] *no_buffer pointer to a frames missed with no rx descriptor buffer
+ * @param[out] *overflow pointer to a frames missed on the rx fifo overflow buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the hardware counters are cleared on read, so the results are the frames
+ *             missed since the last call
+ */
+uint8_t eth_get_rx_missed(uint32_t *no_buffer, uint32_t *overflow);
+
+/**
+ * @brief      eth get the mmc counters
+ * @param[out] *mmc pointer to an eth mmc structure
+ * @return     status code
+ *             - 0 success
+ * @note       the counters are free running, so the caller works on differences
+ */
+uint8_t eth_get_mmc(eth_mmc_t *mmc);
+
+/**
+ * @brief     eth send a pause frame
+ * @param[in] quanta pause time in 512 bit time slots
+ * @return    status code
+ *            - 0 success
+ *            - 2 pause frame busy
+ * @note      the quanta 0 resumes the link partner at once,
+ *            the transmit flow control must be enabled in the mac config
+ */
+uint8_t eth_send_pause(uint16_t quanta);
+
+/**
+ * @brief     eth set the multicast filter
+ * @param[in] **addr pointer to a multicast mac address table
+ * @param[in] len table length
+ * @param[in] pass_all pass all multicast frames
+ * @return    status code
+ *            - 0 success
+ *            - 1 set filter failed
+ * @note      the first ETH_MULTICAST_PERFECT_CNT addresses use the perfect filter registers,
+ *            the others use the 64 bin hash table, unicast frames always use the perfect filter
+ */
+uint8_t eth_set_multicast_filter(const uint8_t (*addr)[6], uint32_t len, uint8_t pass_all);
+
+/**
+ * @brief     eth set the wire pacing
+ * @param[in] enable 1 sends the frames at the link speed, 0 sends them at once
+ * @return    status code
+ *            - 0 success
+ * @note      the pacing is on by default
+ */
+uint8_t eth_set_pacing(uint8_t enable);
+
+/**
+ * @brief  eth run the virtual mac
+ * @return status code
+ *         - 0 success
+ * @note   moves the frames between the dma rings and the wire and raises the
+ *         pending interrupts through HAL_ETH_IRQHandler, the host main loop calls
+ *         it where the target takes the ETH_IRQHandler
+ */
+uint8_t eth_poll(void);
+
+/**
+ * @brief  eth get the time until the virtual mac has work to do
+ * @return milliseconds until the next frame leaves or arrives, 0xFFFFFFFF if there is none
+ * @note   a frame due within the millisecond gives 0, so the caller polls it out in time
+ */
+uint32_t eth_get_sleeptime(void);
+
+/**
+ * @brief  eth get the handle
+ * @return pointer to an eth handle
+ * @note   none
+ */
+ETH_HandleTypeDef* eth_get_handle(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      peer.h
+ * @brief     peer header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PEER_H
+#define PEER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup peer peer function
+ * @brief    link partner modules
+ * @{
+ */
+
+/**
+ * @brief peer address definition
+ * @note  the peer is the gateway, the dhcp server, the dns server and the lwiperf server of the network
+ */
+#define PEER_MAC        {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}        /**< peer mac address */
+#define PEER_IP         "192.168.1.1"                               /**< peer address */
+#define PEER_NETMASK    "255.255.255.0"                             /**< network mask */
+#define PEER_LEASE_IP   "192.168.1.100"                             /**< address leased by dhcp */
+
+/**
+ * @brief peer lease definition
+ */
+#ifndef PEER_LEASE_TIME
+    #define PEER_LEASE_TIME 3600U        /**< lease time in seconds */
+#endif
+
+/**
+ * @brief peer dns definition
+ */
+#ifndef PEER_DNS_TTL
+    #define PEER_DNS_TTL 60U             /**< ttl of the answers, every name is the peer address */
+#endif
+
+/**
+ * @brief     peer set the perf client
+ * @param[in] duration_ms send time of the lwiperf client, 0 runs no client
+ * @note      the client connects to PEER_LEASE_IP once the lease is acked,
+ *            the lwiperf server of the peer always listens on port 5001
+ */
+void peer_set_perf_client(uint32_t duration_ms);
+
+/**
+ * @brief  peer run the link partner
+ * @return exit code of the process
+ * @note   runs a second lwip instance on the other end of the vmac pair until the wire closes,
+ *         give it to vmac_open_pair before lwip_init is called
+ */
+int peer_run(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
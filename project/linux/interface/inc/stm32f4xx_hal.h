@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      stm32f4xx_hal.h
+ * @brief     host stm32f4xx hal header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @defgroup hal hal function
+ * @brief    host subset of the stm32f4xx hal used by the network port
+ * @{
+ */
+
+/**
+ * @brief hal status enumeration definition
+ */
+typedef enum
+{
+    HAL_OK      = 0x00U,        /**< ok */
+    HAL_ERROR   = 0x01U,        /**< error */
+    HAL_BUSY    = 0x02U,        /**< busy */
+    HAL_TIMEOUT = 0x03U,        /**< timeout */
+} HAL_StatusTypeDef;
+
+/**
+ * @brief functional state enumeration definition
+ */
+typedef enum
+{
+    DISABLE = 0U,               /**< disable */
+    ENABLE = !DISABLE,          /**< enable */
+} FunctionalState;
+
+/**
+ * @brief compiler definition
+ */
+#define __IO                   volatile
+#define __ALIGNED(x)           __attribute__((aligned(x)))
+
+/**
+ * @brief mac address definition, the same as stm32f4xx_hal_conf.h
+ */
+#define MAC_ADDR0              0
+#define MAC_ADDR1              1
+#define MAC_ADDR2              2
+#define MAC_ADDR3              3
+#define MAC_ADDR4              4
+#define MAC_ADDR5              5
+
+/**
+ * @brief eth buffer definition, the same as the target
+ */
+#define ETH_MAX_PACKET_SIZE    1528U                  /**< header + payload + vlan + crc */
+#define ETH_MAX_PAYLOAD        1500U                  /**< maximum ethernet payload size */
+#define ETH_RX_BUF_SIZE        ETH_MAX_PACKET_SIZE    /**< buffer size for receive */
+#define ETH_TX_BUF_SIZE        ETH_MAX_PACKET_SIZE    /**< buffer size for transmit */
+#define ETH_TX_DESC_CNT        4U                     /**< tx dma descriptors */
+#define ETH_RX_DESC_CNT        4U                     /**< rx dma descriptors */
+
+/**
+ * @brief eth mac config definition
+ */
+#define ETH_SPEED_10M          0x00000000U            /**< 10 Mbit/s */
+#define ETH_SPEED_100M         0x00004000U            /**< 100 Mbit/s */
+#define ETH_HALFDUPLEX_MODE    0x00000000U            /**< half duplex */
+#define ETH_FULLDUPLEX_MODE    0x00000800U            /**< full duplex */
+
+/**
+ * @brief eth dma status and interrupt enable definition, the same bits as the target
+ */
+#define ETH_DMASR_NIS          0x00010000U            /**< normal interrupt summary */
+#define ETH_DMASR_AIS          0x00008000U            /**< abnormal interrupt summary */
+#define ETH_DMASR_RBUS         0x00000080U            /**< receive buffer unavailable status */
+#define ETH_DMASR_RS           0x00000040U            /**< receive status */
+#define ETH_DMASR_TS           0x00000001U            /**< transmit status */
+#define ETH_DMAIER_NISE        0x00010000U            /**< normal interrupt summary enable */
+#define ETH_DMAIER_AISE        0x00008000U            /**< abnormal interrupt summary enable */
+#define ETH_DMAIER_RBUIE       0x00000080U            /**< receive buffer unavailable interrupt enable */
+#define ETH_DMAIER_RIE         0x00000040U            /**< receive interrupt enable */
+#define ETH_DMAIER_TIE         0x00000001U            /**< transmit interrupt enable */
+
+/**
+ * @brief eth state definition
+ */
+#define HAL_ETH_STATE_RESET    0x00000000U            /**< not initialized */
+#define HAL_ETH_STATE_READY    0x00000010U            /**< initialized and ready */
+#define HAL_ETH_STATE_STARTED  0x00000023U            /**< mac and dma started */
+
+/**
+ * @brief eth error definition
+ */
+#define HAL_ETH_ERROR_NONE     0x00000000U            /**< no error */
+#define HAL_ETH_ERROR_BUSY     0x00000002U            /**< busy error */
+
+/**
+ * @brief eth register structure definition
+ * @note  only the dma status and interrupt enable registers are emulated
+ */
+typedef struct
+{
+    __IO uint32_t DMASR;                              /**< dma status register */
+    __IO uint32_t DMAIER;                             /**< dma interrupt enable register */
+} ETH_TypeDef;
+
+/**
+ * @brief eth buffer structure definition
+ */
+typedef struct __ETH_BufferTypeDef
+{
+    uint8_t *buffer;                                  /**< buffer address */
+    uint32_t len;                                     /**< buffer length */
+    struct __ETH_BufferTypeDef *next;                 /**< next buffer in the list */
+} ETH_BufferTypeDef;
+
+/**
+ * @brief eth mac config structure definition
+ */
+typedef struct
+{
+    uint32_t Speed;                                   /**< ETH_SPEED_10M or ETH_SPEED_100M */
+    uint32_t DuplexMode;                              /**< ETH_HALFDUPLEX_MODE or ETH_FULLDUPLEX_MODE */
+    uint32_t PauseTime;                               /**< pause time in the sent pause frames */
+    FunctionalState ZeroQuantaPause;                  /**< zero quanta pause */
+    FunctionalState UnicastPausePacketDetect;         /**< unicast pause frame detection */
+    FunctionalState ReceiveFlowControl;               /**< honour the received pause frames */
+    FunctionalState TransmitFlowControl;              /**< send pause frames */
+} ETH_MACConfigTypeDef;
+
+/**
+ * @brief eth handle structure definition
+ */
+typedef struct __ETH_HandleTypeDef
+{
+    ETH_TypeDef *Instance;                            /**< register base address */
+    uint8_t *MACAddr;                                 /**< mac address */
+    __IO uint32_t gState;                             /**< eth state */
+    __IO uint32_t ErrorCode;                          /**< eth error code */
+    __IO uint32_t DMAErrorCode;                       /**< dma status of the last error interrupt */
+} ETH_HandleTypeDef;
+
+/**
+ * @brief eth dma interrupt definition
+ */
+#define __HAL_ETH_DMA_ENABLE_IT(__HANDLE__, __INTERRUPT__)     ((__HANDLE__)->Instance->DMAIER |= (__INTERRUPT__))
+#define __HAL_ETH_DMA_DISABLE_IT(__HANDLE__, __INTERRUPT__)    ((__HANDLE__)->Instance->DMAIER &= ~(__INTERRUPT__))
+#define __HAL_ETH_DMA_CLEAR_IT(__HANDLE__, __INTERRUPT__)      ((__HANDLE__)->Instance->DMASR &= ~(__INTERRUPT__))
+
+/**
+ * @brief  hal get the tick
+ * @return milliseconds since the start
+ * @note   CLOCK_MONOTONIC
+ */
+uint32_t HAL_GetTick(void);
+
+/**
+ * @brief     hal delay
+ * @param[in] delay time in ms
+ * @note      none
+ */
+void HAL_Delay(uint32_t delay);
+
+/**
+ * @brief     eth start the mac and the dma in interrupt mode
+ * @param[in] *heth pointer to an eth handle
+ * @return    hal status
+ * @note      the rx descriptors are given their buffers
+ */
+HAL_StatusTypeDef HAL_ETH_Start_IT(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief     eth stop the mac and the dma
+ * @param[in] *heth pointer to an eth handle
+ * @return    hal status
+ * @note      none
+ */
+HAL_StatusTypeDef HAL_ETH_Stop_IT(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief      eth read a received frame
+ * @param[in]  *heth pointer to an eth handle
+ * @param[out] **pAppBuff pointer to the frame built by HAL_ETH_RxLinkCallback
+ * @return     hal status
+ * @note       the read descriptors are given new buffers
+ */
+HAL_StatusTypeDef HAL_ETH_ReadData(ETH_HandleTypeDef *heth, void **pAppBuff);
+
+/**
+ * @brief      eth get the mac config
+ * @param[in]  *heth pointer to an eth handle
+ * @param[out] *macconf pointer to a mac config structure
+ * @return     hal status
+ * @note       none
+ */
+HAL_StatusTypeDef HAL_ETH_GetMACConfig(ETH_HandleTypeDef *heth, ETH_MACConfigTypeDef *macconf);
+
+/**
+ * @brief     eth set the mac config
+ * @param[in] *heth pointer to an eth handle
+ * @param[in] *macconf pointer to a mac config structure
+ * @return    hal status
+ * @note      none
+ */
+HAL_StatusTypeDef HAL_ETH_SetMACConfig(ETH_HandleTypeDef *heth, ETH_MACConfigTypeDef *macconf);
+
+/**
+ * @brief     eth irq handler
+ * @param[in] *heth pointer to an eth handle
+ * @note      dispatches the pending and enabled dma interrupts to the callbacks
+ */
+void HAL_ETH_IRQHandler(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief     eth rx complete callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief     eth tx complete callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief     eth error callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth);
+
+/**
+ * @brief      eth rx allocate callback
+ * @param[out] **buff pointer to a new rx buffer, NULL if there is none
+ * @note       none
+ */
+void HAL_ETH_RxAllocateCallback(uint8_t **buff);
+
+/**
+ * @brief         eth rx link callback
+ * @param[in,out] **pStart pointer to the first buffer of the frame
+ * @param[in,out] **pEnd pointer to the last buffer of the frame
+ * @param[in]     *buff pointer to the received buffer
+ * @param[in]     Length buffer length
+ * @note          none
+ */
+void HAL_ETH_RxLinkCallback(void **pStart, void **pEnd, uint8_t *buff, uint16_t Length);
+
+/**
+ * @brief     eth tx free callback
+ * @param[in] *buff pointer to the data given to eth_write
+ * @note      none
+ */
+void HAL_ETH_TxFreeCallback(uint32_t *buff);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      vmac.h
+ * @brief     virtual wire header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef VMAC_H
+#define VMAC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup vmac vmac function
+ * @brief    virtual wire modules of the virtual mac
+ * @{
+ */
+
+/**
+ * @brief vmac frame definition
+ */
+#define VMAC_FRAME_MAX        1522        /**< longest frame without the crc */
+
+/**
+ * @brief vmac peer function type definition
+ * @note  runs in the child process with the wire attached to the other end, returns the exit code
+ */
+typedef int (*vmac_peer_t)(void);
+
+/**
+ * @brief     vmac open a wire to a peer process
+ * @param[in] peer pointer to the function run by the peer process
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the peer is forked and gets the other end of a seqpacket socket pair,
+ *            it exits when this end is closed
+ */
+uint8_t vmac_open_pair(vmac_peer_t peer);
+
+/**
+ * @brief     vmac open a wire replaying a pcap file
+ * @param[in] *path pointer to a pcap file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the frames arrive with their recorded spacing from the first vmac_recv,
+ *            the sent frames are dropped
+ */
+uint8_t vmac_open_pcap(const char *path);
+
+/**
+ * @brief     vmac dump the wire
+ * @param[in] *path pointer to a pcap file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      every frame sent or received is written to the pcap file
+ */
+uint8_t vmac_open_dump(const char *path);
+
+/**
+ * @brief vmac close the wire, the peer and the dump
+ * @note  none
+ */
+void vmac_close(void);
+
+/**
+ * @brief     vmac send a frame
+ * @param[in] *frame pointer to a frame buffer
+ * @param[in] len frame length
+ * @return    status code
+ *            - 0 success
+ *            - 1 the frame is lost
+ * @note      none
+ */
+uint8_t vmac_send(const uint8_t *frame, uint32_t len);
+
+/**
+ * @brief      vmac receive a frame
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  len buffer length
+ * @return     frame length, 0 if no frame has arrived, -1 if the wire is closed
+ * @note       none
+ */
+int32_t vmac_recv(uint8_t *frame, uint32_t len);
+
+/**
+ * @brief     vmac wait for a frame
+ * @param[in] ms longest wait time
+ * @return    status code
+ *            - 0 timeout
+ *            - 1 a frame is ready
+ * @note      none
+ */
+uint8_t vmac_wait(uint32_t ms);
+
+/**
+ * @brief  vmac get the carrier
+ * @return 1 if the wire is open, 0 otherwise
+ * @note   none
+ */
+uint8_t vmac_get_carrier(void);
+
+/**
+ * @brief         vmac insert the checksums
+ * @param[in,out] *frame pointer to a frame buffer
+ * @param[in]     len frame length
+ * @note          the ipv4 header and the tcp, udp and icmp checksums, as the stm32 mac does
+ *                with ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC
+ */
+void vmac_checksum(uint8_t *frame, uint32_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      vphy.h
+ * @brief     virtual lan8720 phy header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef VPHY_H
+#define VPHY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup vphy vphy function
+ * @brief    virtual lan8720 phy modules
+ * @{
+ */
+
+/**
+ * @brief vphy strap definition
+ */
+#ifndef VPHY_ADDR
+    #define VPHY_ADDR 0x01        /**< phy address strap */
+#endif
+
+/**
+ * @brief vphy link partner definition
+ * @note  ability register of the link partner, 10/100 half/full duplex and symmetric pause
+ */
+#ifndef VPHY_PARTNER_ABILITY
+    #define VPHY_PARTNER_ABILITY 0x05E1U
+#endif
+
+/**
+ * @brief  vphy init
+ * @return status code
+ *         - 0 success
+ * @note   loads the power on register values, the cable is plugged
+ */
+uint8_t vphy_init(void);
+
+/**
+ * @brief     vphy write the reset pin
+ * @param[in] level pin level
+ * @return    status code
+ *            - 0 success
+ * @note      a low level holds the phy in reset, the registers restart from their default values
+ */
+uint8_t vphy_reset(uint8_t level);
+
+/**
+ * @brief      vphy read a register
+ * @param[in]  addr phy address
+ * @param[in]  reg register address
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       no phy answers on the other addresses and the bus reads 0xFFFF
+ */
+uint8_t vphy_read(uint8_t addr, uint8_t reg, uint16_t *data);
+
+/**
+ * @brief     vphy write a register
+ * @param[in] addr phy address
+ * @param[in] reg register address
+ * @param[in] data written data
+ * @return    status code
+ *            - 0 success
+ * @note      the read only bits are kept, soft reset and restart auto negotiation clear themselves
+ */
+uint8_t vphy_write(uint8_t addr, uint8_t reg, uint16_t data);
+
+/**
+ * @brief     vphy plug or unplug the cable
+ * @param[in] plugged 1 if the cable is plugged
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t vphy_set_cable(uint8_t plugged);
+
+/**
+ * @brief     vphy flap the cable
+ * @param[in] up_ms time with the cable plugged
+ * @param[in] down_ms time with the cable unplugged, 0 stops the flapping
+ * @return    status code
+ *            - 0 success
+ * @note      the cable follows the clock, so it also flaps while the caller blocks in a delay
+ */
+uint8_t vphy_set_flap(uint32_t up_ms, uint32_t down_ms);
+
+/**
+ * @brief  vphy get the link
+ * @return 1 if the frames pass the phy, 0 otherwise
+ * @note   none
+ */
+uint8_t vphy_get_link(void);
+
+/**
+ * @brief  vphy get the near end loopback
+ * @return 1 if the transmitted frames are looped back, 0 otherwise
+ * @note   none
+ */
+uint8_t vphy_get_loop_back(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      delay.c
+ * @brief     delay source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "delay.h"
+#include <time.h>
+
+/**
+ * @brief delay var definition
+ */
+static struct timespec gs_start;        /**< tick 0 */
+static uint8_t gs_inited = 0;           /**< start is set */
+
+/**
+ * @brief  delay clock init
+ * @return status code
+ *         - 0 success
+ * @note   starts HAL_GetTick from 0
+ */
+uint8_t delay_init(void)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, &gs_start);
+    gs_inited = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief     delay us
+ * @param[in] us time
+ * @note      none
+ */
+void delay_us(uint32_t us)
+{
+    struct timespec ts;
+    
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (long)(us % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        /* interrupted by a signal, sleep the rest */
+    }
+}
+
+/**
+ * @brief     delay ms
+ * @param[in] ms time
+ * @note      none
+ */
+void delay_ms(uint32_t ms)
+{
+    delay_us(ms * 1000);
+}
+
+/**
+ * @brief  hal get the tick
+ * @return milliseconds since the start
+ * @note   CLOCK_MONOTONIC
+ */
+uint32_t HAL_GetTick(void)
+{
+    struct timespec ts;
+    
+    if (gs_inited == 0)
+    {
+        (void)delay_init();
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint32_t)((int64_t)(ts.tv_sec - gs_start.tv_sec) * 1000 + (ts.tv_nsec - gs_start.tv_nsec) / 1000000);
+}
+
+/**
+ * @brief     hal delay
+ * @param[in] delay time in ms
+ * @note      none
+ */
+void HAL_Delay(uint32_t delay)
+{
+    delay_ms(delay);
+}
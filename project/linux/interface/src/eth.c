@@ -0,0 +1,906 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      eth.c
+ * @brief     eth source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "eth.h"
+#include "vmac.h"
+#include "vphy.h"
+#include "trace.h"
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief eth wire definition
+ */
+#define ETH_WIRE_OVERHEAD      24U        /**< crc, preamble and inter frame gap bytes */
+#define ETH_WIRE_MIN           64U        /**< shortest frame with the crc */
+#define ETH_TYPE_PAUSE         0x8808U    /**< mac control ethertype */
+
+/**
+ * @brief eth rx descriptor structure definition
+ */
+typedef struct eth_rx_desc_s
+{
+    uint8_t *buff;                        /**< buffer given by HAL_ETH_RxAllocateCallback */
+    uint16_t len;                         /**< received frame length */
+    uint8_t ready;                        /**< frame written by the dma */
+} eth_rx_desc_t;
+
+/**
+ * @brief eth tx frame structure definition
+ */
+typedef struct eth_tx_frame_s
+{
+    void *data;                           /**< data given back by HAL_ETH_TxFreeCallback */
+    uint32_t descs;                       /**< descriptors used by the frame */
+    uint32_t len;                         /**< frame length */
+    uint64_t done_ns;                     /**< time the last bit leaves, 0 if not started */
+    uint8_t sent;                         /**< frame is on the wire */
+    uint8_t frame[ETH_TX_BUF_SIZE];       /**< frame copied by the dma */
+} eth_tx_frame_t;
+
+/**
+ * @brief eth var definition
+ */
+ETH_HandleTypeDef g_eth_handle;                                  /**< eth handle */
+static ETH_TypeDef gs_eth_reg;                                   /**< emulated dma registers */
+static ETH_MACConfigTypeDef gs_mac_config;                       /**< mac config */
+static uint8_t gs_mac[6];                                        /**< mac address */
+static eth_rx_desc_t gs_rx_desc[ETH_RX_DESC_CNT];                /**< rx descriptors */
+static uint32_t gs_rx_dma;                                       /**< next descriptor written by the dma */
+static uint32_t gs_rx_app;                                       /**< next descriptor read by HAL_ETH_ReadData */
+static uint8_t gs_rx_suspended;                                  /**< rx dma found no buffer */
+static uint8_t gs_rx_frame[VMAC_FRAME_MAX];                      /**< frame on the wire */
+static uint32_t gs_rx_frame_len;                                 /**< frame length, 0 if the wire is idle */
+static uint64_t gs_rx_due_ns;                                    /**< time the last bit of the frame arrives */
+static uint64_t gs_rx_wire_free_ns;                              /**< time the rx wire is free */
+static eth_tx_frame_t gs_tx[ETH_TX_DESC_CNT];                    /**< tx frames, one descriptor at least */
+static uint32_t gs_tx_head;                                      /**< oldest tx frame */
+static uint32_t gs_tx_cnt;                                       /**< tx frames not reclaimed */
+static uint32_t gs_tx_in_use;                                    /**< tx descriptors in use */
+static uint64_t gs_wire_free_ns;                                 /**< time the wire is free */
+static uint64_t gs_pause_until_ns;                               /**< end of the pause asked by the partner */
+static uint8_t gs_pacing = 1;                                    /**< frames leave at the link speed */
+static eth_mmc_t gs_mmc;                                         /**< mmc counters */
+static uint32_t gs_missed_no_buffer;                             /**< frames missed with no rx buffer */
+static uint8_t gs_mcast[ETH_MULTICAST_PERFECT_CNT][6];           /**< perfect multicast filter */
+static uint32_t gs_mcast_cnt;                                    /**< perfect multicast addresses */
+static uint32_t gs_hash[2];                                      /**< hash table, hash[0] is MACHTHR */
+static uint8_t gs_hash_enable;                                   /**< multicast hash filter */
+static uint8_t gs_pass_all;                                      /**< pass all multicast */
+
+/**
+ * @brief  eth get the time
+ * @return nanoseconds of CLOCK_MONOTONIC
+ * @note   none
+ */
+static uint64_t a_eth_now_ns(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief  eth get the link speed
+ * @return speed in Mbit/s
+ * @note   none
+ */
+static uint32_t a_eth_mbps(void)
+{
+    return (gs_mac_config.Speed == ETH_SPEED_100M) ? 100U : 10U;
+}
+
+/**
+ * @brief     eth get the wire time of a frame
+ * @param[in] len frame length without the crc
+ * @return    wire time in ns
+ * @note      the preamble, the crc and the inter frame gap are included
+ */
+static uint64_t a_eth_wire_ns(uint32_t len)
+{
+    uint32_t bytes;
+    
+    bytes = ((len + 4U) < ETH_WIRE_MIN) ? (ETH_WIRE_MIN + 20U) : (len + ETH_WIRE_OVERHEAD);
+    
+    return ((uint64_t)bytes * 8000U) / a_eth_mbps();
+}
+
+/**
+ * @brief     eth calculate the multicast hash bin
+ * @param[in] *mac pointer to a mac address buffer
+ * @return    hash bin index in 0 - 63
+ * @note      the upper 6 bits of the bit reversed and inverted ethernet crc32
+ */
+static uint32_t a_eth_hash_bin(const uint8_t mac[6])
+{
+    uint32_t crc;
+    uint32_t rev;
+    uint8_t i;
+    uint8_t j;
+    
+    /* ethernet crc32 over the destination address */
+    crc = 0xFFFFFFFFU;
+    for (i = 0; i < 6; i++)
+    {
+        crc ^= mac[i];
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 1U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+        }
+    }
+    
+    /* __RBIT of the target */
+    crc = ~crc;
+    rev = 0;
+    for (i = 0; i < 32; i++)
+    {
+        rev = (rev << 1) | ((crc >> i) & 1U);
+    }
+    
+    return rev >> 26;
+}
+
+/**
+ * @brief     eth check the destination address
+ * @param[in] *frame pointer to a frame buffer
+ * @return    1 if the frame passes the filter
+ * @note      none
+ */
+static uint8_t a_eth_filter(const uint8_t *frame)
+{
+    static const uint8_t broadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint32_t bin;
+    uint32_t i;
+    
+    if ((frame[0] & 0x01U) == 0)
+    {
+        /* unicast always uses the perfect filter */
+        return (uint8_t)(memcmp(frame, gs_mac, 6) == 0);
+    }
+    if ((memcmp(frame, broadcast, 6) == 0) || (gs_pass_all != 0))
+    {
+        return 1;
+    }
+    for (i = 0; i < gs_mcast_cnt; i++)
+    {
+        if (memcmp(frame, gs_mcast[i], 6) == 0)
+        {
+            return 1;
+        }
+    }
+    if (gs_hash_enable != 0)
+    {
+        bin = a_eth_hash_bin(frame);
+        
+        return (uint8_t)((gs_hash[(bin >> 5) ^ 1U] >> (bin & 0x1FU)) & 1U);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief give the free rx descriptors new buffers
+ * @note  stops at the first failed allocation as ETH_UpdateDescriptor does
+ */
+static void a_eth_rx_refill(void)
+{
+    eth_rx_desc_t *desc;
+    uint8_t *buff;
+    uint32_t i;
+    
+    for (i = 0; i < ETH_RX_DESC_CNT; i++)
+    {
+        desc = &gs_rx_desc[(gs_rx_app + i) % ETH_RX_DESC_CNT];
+        if ((desc->ready != 0) || (desc->buff != NULL))
+        {
+            continue;
+        }
+        HAL_ETH_RxAllocateCallback(&buff);
+        if (buff == NULL)
+        {
+            break;
+        }
+        desc->buff = buff;
+    }
+    
+    /* the poll demand resumes a suspended dma */
+    if (gs_rx_desc[gs_rx_dma].buff != NULL)
+    {
+        gs_rx_suspended = 0;
+    }
+}
+
+/**
+ * @brief     eth receive a frame from the wire
+ * @param[in] *frame pointer to a frame buffer
+ * @param[in] len frame length
+ * @note      none
+ */
+static void a_eth_rx_frame(const uint8_t *frame, uint32_t len)
+{
+    eth_rx_desc_t *desc;
+    uint32_t quanta;
+    
+    if ((g_eth_handle.gState != HAL_ETH_STATE_STARTED) || (len < 14) || (len > ETH_RX_BUF_SIZE))
+    {
+        return;
+    }
+    
+    /* pause frames stop the transmitter and are never forwarded */
+    if ((((uint32_t)frame[12] << 8) | frame[13]) == ETH_TYPE_PAUSE)
+    {
+        if ((len >= 18) && (frame[15] == 0x01) && (gs_mac_config.ReceiveFlowControl == ENABLE))
+        {
+            quanta = ((uint32_t)frame[16] << 8) | frame[17];
+            gs_pause_until_ns = a_eth_now_ns() + ((uint64_t)quanta * 512000U) / a_eth_mbps();
+        }
+        
+        return;
+    }
+    if (a_eth_filter(frame) == 0)
+    {
+        return;
+    }
+    
+    /* the dma owns no descriptor, the frame is missed */
+    desc = &gs_rx_desc[gs_rx_dma];
+    if ((gs_rx_suspended != 0) || (desc->buff == NULL) || (desc->ready != 0))
+    {
+        gs_missed_no_buffer++;
+        if (gs_rx_suspended == 0)
+        {
+            gs_rx_suspended = 1;
+            gs_eth_reg.DMASR |= ETH_DMASR_RBUS | ETH_DMASR_AIS;
+        }
+        
+        return;
+    }
+    memcpy(desc->buff, frame, len);
+    desc->len = (uint16_t)len;
+    desc->ready = 1;
+    gs_rx_dma = (gs_rx_dma + 1) % ETH_RX_DESC_CNT;
+    if ((frame[0] & 0x01U) == 0)
+    {
+        gs_mmc.rx_good_unicast++;
+    }
+    gs_eth_reg.DMASR |= ETH_DMASR_RS | ETH_DMASR_NIS;
+}
+
+/**
+ * @brief     eth put a frame on the wire
+ * @param[in] *frame pointer to a frame buffer
+ * @param[in] len frame length
+ * @note      the near end loopback of the phy sends the frame back to the rx path
+ */
+static void a_eth_wire_out(const uint8_t *frame, uint32_t len)
+{
+    if (vphy_get_loop_back() != 0)
+    {
+        a_eth_rx_frame(frame, len);
+    }
+    else if (vphy_get_link() != 0)
+    {
+        (void)vmac_send(frame, len);
+    }
+    else
+    {
+        /* no link, the frame is lost */
+    }
+}
+
+/**
+ * @brief     eth send the tx frames whose time has come
+ * @param[in] now current time in ns
+ * @note      the frames keep their order and each one takes its wire time
+ */
+static void a_eth_tx_process(uint64_t now)
+{
+    eth_tx_frame_t *f;
+    uint32_t i;
+    
+    for (i = 0; i < gs_tx_cnt; i++)
+    {
+        f = &gs_tx[(gs_tx_head + i) % ETH_TX_DESC_CNT];
+        if (f->sent != 0)
+        {
+            continue;
+        }
+        if (f->done_ns == 0)
+        {
+            /* a pause only holds back the frames not started yet */
+            if (now < gs_pause_until_ns)
+            {
+                break;
+            }
+            if (gs_pacing != 0)
+            {
+                f->done_ns = ((gs_wire_free_ns > now) ? gs_wire_free_ns : now) + a_eth_wire_ns(f->len);
+                gs_wire_free_ns = f->done_ns;
+            }
+            else
+            {
+                f->done_ns = now;
+            }
+        }
+        if (now < f->done_ns)
+        {
+            break;
+        }
+        vmac_checksum(f->frame, f->len);
+        a_eth_wire_out(f->frame, f->len);
+        f->sent = 1;
+        gs_mmc.tx_good++;
+        gs_eth_reg.DMASR |= ETH_DMASR_TS | ETH_DMASR_NIS;
+    }
+}
+
+/**
+ * @brief     eth init
+ * @param[in] *mac pointer to a mac buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      the virtual mac is wired to the backend opened by vmac.h
+ */
+uint8_t eth_init(uint8_t mac[6])
+{
+    memcpy(gs_mac, mac, 6);
+    memset(&gs_eth_reg, 0, sizeof(gs_eth_reg));
+    g_eth_handle.Instance = &gs_eth_reg;
+    g_eth_handle.MACAddr = gs_mac;
+    g_eth_handle.gState = HAL_ETH_STATE_READY;
+    g_eth_handle.ErrorCode = HAL_ETH_ERROR_NONE;
+    g_eth_handle.DMAErrorCode = 0;
+    memset(&gs_mac_config, 0, sizeof(gs_mac_config));
+    gs_mac_config.Speed = ETH_SPEED_100M;
+    gs_mac_config.DuplexMode = ETH_FULLDUPLEX_MODE;
+    memset(gs_rx_desc, 0, sizeof(gs_rx_desc));
+    gs_rx_dma = 0;
+    gs_rx_app = 0;
+    gs_rx_suspended = 0;
+    gs_tx_head = 0;
+    gs_tx_cnt = 0;
+    gs_tx_in_use = 0;
+    gs_pause_until_ns = 0;
+    gs_mcast_cnt = 0;
+    gs_hash_enable = 0;
+    gs_pass_all = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief  eth deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t eth_deinit(void)
+{
+    g_eth_handle.gState = HAL_ETH_STATE_RESET;
+    
+    return 0;
+}
+
+/**
+ * @brief      eth phy read
+ * @param[in]  addr device address
+ * @param[in]  reg register address
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note
+ */
+uint8_t eth_read_phy(uint8_t addr, uint8_t reg, uint16_t *data)
+{
+    return vphy_read(addr, reg, data);
+}
+
+/**
+ * @brief     eth phy write
+ * @param[in] addr device waddress
+ * @param[in] reg register address
+ * @param[in] data set data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t eth_write_phy(uint8_t addr, uint8_t reg, uint16_t data)
+{
+    return vphy_write(addr, reg, data);
+}
+
+/**
+ * @brief     eth write
+ * @param[in] *tx_buffer pointer to ETH_BufferTypeDef structure
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len set length
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ *            - 2 tx ring is full
+ * @note      the frame is sent in interrupt mode and this function doesn't wait for the dma,
+ *            data is given back by HAL_ETH_TxFreeCallback in eth_tx_reclaim
+ */
+uint8_t eth_write(ETH_BufferTypeDef *tx_buffer, void *data, uint32_t len)
+{
+    ETH_BufferTypeDef *b;
+    eth_tx_frame_t *f;
+    uint32_t descs;
+    uint32_t pos;
+    uint8_t res = 0;
+    TRACE_BEGIN(TRACE_PROBE_ETH_WRITE);
+    
+    descs = 0;
+    for (b = tx_buffer; b != NULL; b = b->next)
+    {
+        descs++;
+    }
+    if ((g_eth_handle.gState != HAL_ETH_STATE_STARTED) || (len > ETH_TX_BUF_SIZE))
+    {
+        res = 1;
+    }
+    else if (descs > ETH_TX_DESC_CNT - gs_tx_in_use)
+    {
+        res = 2;
+    }
+    else
+    {
+        /* the dma reads the buffers, short frames are padded */
+        f = &gs_tx[(gs_tx_head + gs_tx_cnt) % ETH_TX_DESC_CNT];
+        pos = 0;
+        for (b = tx_buffer; b != NULL; b = b->next)
+        {
+            memcpy(f->frame + pos, b->buffer, b->len);
+            pos += b->len;
+        }
+        if (pos < ETH_WIRE_MIN - 4U)
+        {
+            memset(f->frame + pos, 0, ETH_WIRE_MIN - 4U - pos);
+            pos = ETH_WIRE_MIN - 4U;
+        }
+        f->data = data;
+        f->descs = descs;
+        f->len = pos;
+        f->done_ns = 0;
+        f->sent = 0;
+        gs_tx_cnt++;
+        gs_tx_in_use += descs;
+        a_eth_tx_process(a_eth_now_ns());
+    }
+    TRACE_END(TRACE_PROBE_ETH_WRITE);
+    
+    return res;
+}
+
+/**
+ * @brief  eth reclaim the transmitted tx descriptors
+ * @return status code
+ *         - 0 success
+ *         - 1 reclaim failed
+ * @note   HAL_ETH_TxFreeCallback is called for every transmitted frame
+ */
+uint8_t eth_tx_reclaim(void)
+{
+    eth_tx_frame_t *f;
+    
+    while ((gs_tx_cnt != 0) && (gs_tx[gs_tx_head].sent != 0))
+    {
+        f = &gs_tx[gs_tx_head];
+        gs_tx_head = (gs_tx_head + 1) % ETH_TX_DESC_CNT;
+        gs_tx_cnt--;
+        gs_tx_in_use -= f->descs;
+        HAL_ETH_TxFreeCallback((uint32_t *)f->data);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  eth get the tx descriptors in use
+ * @return number of the tx descriptors owned by the pending frames
+ * @note   none
+ */
+uint32_t eth_get_tx_in_use(void)
+{
+    return gs_tx_in_use;
+}
+
+/**
+ * @brief      eth get the rx missed frame counters
+ * @param[out] *no_buffer pointer to a frames missed with no rx descriptor buffer
+ * @param[out] *overflow pointer to a frames missed on the rx fifo overflow buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the hardware counters are cleared on read, so the results are the frames
+ *             missed since the last call
+ */
+uint8_t eth_get_rx_missed(uint32_t *no_buffer, uint32_t *overflow)
+{
+    *no_buffer = gs_missed_no_buffer;
+    *overflow = 0;
+    gs_missed_no_buffer = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief      eth get the mmc counters
+ * @param[out] *mmc pointer to an eth mmc structure
+ * @return     status code
+ *             - 0 success
+ * @note       the counters are free running, so the caller works on differences
+ */
+uint8_t eth_get_mmc(eth_mmc_t *mmc)
+{
+    *mmc = gs_mmc;
+    
+    return 0;
+}
+
+/**
+ * @brief     eth send a pause frame
+ * @param[in] quanta pause time in 512 bit time slots
+ * @return    status code
+ *            - 0 success
+ *            - 2 pause frame busy
+ * @note      the quanta 0 resumes the link partner at once,
+ *            the transmit flow control must be enabled in the mac config
+ */
+uint8_t eth_send_pause(uint16_t quanta)
+{
+    uint8_t frame[ETH_WIRE_MIN - 4U];
+    
+    if (g_eth_handle.gState != HAL_ETH_STATE_STARTED)
+    {
+        return 2;
+    }
+    
+    /* the mac sends it between two frames */
+    memset(frame, 0, sizeof(frame));
+    frame[0] = 0x01;
+    frame[1] = 0x80;
+    frame[2] = 0xC2;
+    frame[5] = 0x01;
+    memcpy(frame + 6, gs_mac, 6);
+    frame[12] = (uint8_t)(ETH_TYPE_PAUSE >> 8);
+    frame[13] = (uint8_t)ETH_TYPE_PAUSE;
+    frame[15] = 0x01;
+    frame[16] = (uint8_t)(quanta >> 8);
+    frame[17] = (uint8_t)quanta;
+    a_eth_wire_out(frame, sizeof(frame));
+    
+    return 0;
+}
+
+/**
+ * @brief     eth set the multicast filter
+ * @param[in] **addr pointer to a multicast mac address table
+ * @param[in] len table length
+ * @param[in] pass_all pass all multicast frames
+ * @return    status code
+ *            - 0 success
+ *            - 1 set filter failed
+ * @note      the first ETH_MULTICAST_PERFECT_CNT addresses use the perfect filter registers,
+ *            the others use the 64 bin hash table, unicast frames always use the perfect filter
+ */
+uint8_t eth_set_multicast_filter(const uint8_t (*addr)[6], uint32_t len, uint8_t pass_all)
+{
+    uint32_t bin;
+    uint32_t i;
+    
+    gs_mcast_cnt = (len < ETH_MULTICAST_PERFECT_CNT) ? len : ETH_MULTICAST_PERFECT_CNT;
+    for (i = 0; i < gs_mcast_cnt; i++)
+    {
+        memcpy(gs_mcast[i], addr[i], 6);
+    }
+    gs_hash[0] = 0;
+    gs_hash[1] = 0;
+    for (i = ETH_MULTICAST_PERFECT_CNT; i < len; i++)
+    {
+        bin = a_eth_hash_bin(addr[i]);
+        gs_hash[(bin >> 5) ^ 1U] |= 1UL << (bin & 0x1FU);
+    }
+    gs_hash_enable = (len > ETH_MULTICAST_PERFECT_CNT) ? 1 : 0;
+    gs_pass_all = (pass_all != 0) ? 1 : 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     eth set the wire pacing
+ * @param[in] enable 1 sends the frames at the link speed, 0 sends them at once
+ * @return    status code
+ *            - 0 success
+ * @note      the pacing is on by default
+ */
+uint8_t eth_set_pacing(uint8_t enable)
+{
+    gs_pacing = (enable != 0) ? 1 : 0;
+    
+    return 0;
+}
+
+/**
+ * @brief  eth run the virtual mac
+ * @return status code
+ *         - 0 success
+ * @note   moves the frames between the dma rings and the wire and raises the
+ *         pending interrupts through HAL_ETH_IRQHandler, the host main loop calls
+ *         it where the target takes the ETH_IRQHandler
+ */
+uint8_t eth_poll(void)
+{
+    int32_t len;
+    uint32_t pending;
+    uint64_t now;
+    
+    /* the frames on the wire reach the rx ring at the link speed, or are lost while the mac is stopped */
+    now = a_eth_now_ns();
+    while (1)
+    {
+        if (gs_rx_frame_len == 0)
+        {
+            len = vmac_recv(gs_rx_frame, sizeof(gs_rx_frame));
+            if (len < 0)
+            {
+                /* the wire has gone */
+                (void)vphy_set_cable(0);
+            }
+            if (len <= 0)
+            {
+                break;
+            }
+            gs_rx_frame_len = (uint32_t)len;
+            gs_rx_due_ns = now;
+            if (gs_pacing != 0)
+            {
+                gs_rx_due_ns = ((gs_rx_wire_free_ns > now) ? gs_rx_wire_free_ns : now) + a_eth_wire_ns(gs_rx_frame_len);
+                gs_rx_wire_free_ns = gs_rx_due_ns;
+            }
+        }
+        if (now < gs_rx_due_ns)
+        {
+            break;
+        }
+        a_eth_rx_frame(gs_rx_frame, gs_rx_frame_len);
+        gs_rx_frame_len = 0;
+    }
+    if (g_eth_handle.gState == HAL_ETH_STATE_STARTED)
+    {
+        a_eth_tx_process(now);
+    }
+    
+    /* the nvic takes the enabled interrupts */
+    pending = gs_eth_reg.DMASR & gs_eth_reg.DMAIER & (ETH_DMASR_RS | ETH_DMASR_TS | ETH_DMASR_AIS);
+    if (pending != 0)
+    {
+        TRACE_BEGIN(TRACE_PROBE_ETH_IRQ);
+        
+        HAL_ETH_IRQHandler(&g_eth_handle);
+        TRACE_END(TRACE_PROBE_ETH_IRQ);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  eth get the time until the virtual mac has work to do
+ * @return milliseconds until the next frame leaves or arrives, 0xFFFFFFFF if there is none
+ * @note   a frame due within the millisecond gives 0, so the caller polls it out in time
+ */
+uint32_t eth_get_sleeptime(void)
+{
+    eth_tx_frame_t *f;
+    uint64_t now;
+    uint64_t due;
+    uint32_t i;
+    
+    if ((gs_eth_reg.DMASR & gs_eth_reg.DMAIER & (ETH_DMASR_RS | ETH_DMASR_TS | ETH_DMASR_AIS)) != 0)
+    {
+        return 0;
+    }
+    due = 0xFFFFFFFFFFFFFFFFULL;
+    if (gs_rx_frame_len != 0)
+    {
+        due = gs_rx_due_ns;
+    }
+    if (g_eth_handle.gState == HAL_ETH_STATE_STARTED)
+    {
+        for (i = 0; i < gs_tx_cnt; i++)
+        {
+            f = &gs_tx[(gs_tx_head + i) % ETH_TX_DESC_CNT];
+            if (f->sent == 0)
+            {
+                if (((f->done_ns != 0) ? f->done_ns : gs_pause_until_ns) < due)
+                {
+                    due = (f->done_ns != 0) ? f->done_ns : gs_pause_until_ns;
+                }
+                
+                break;
+            }
+        }
+    }
+    if (due == 0xFFFFFFFFFFFFFFFFULL)
+    {
+        return 0xFFFFFFFFU;
+    }
+    now = a_eth_now_ns();
+    
+    return (due > now) ? (uint32_t)((due - now) / 1000000U) : 0;
+}
+
+/**
+ * @brief     eth start the mac and the dma in interrupt mode
+ * @param[in] *heth pointer to an eth handle
+ * @return    hal status
+ * @note      the rx descriptors are given their buffers
+ */
+HAL_StatusTypeDef HAL_ETH_Start_IT(ETH_HandleTypeDef *heth)
+{
+    if (heth->gState != HAL_ETH_STATE_READY)
+    {
+        return HAL_ERROR;
+    }
+    heth->gState = HAL_ETH_STATE_STARTED;
+    a_eth_rx_refill();
+    heth->Instance->DMAIER |= ETH_DMAIER_NISE | ETH_DMAIER_AISE | ETH_DMAIER_RBUIE |
+                              ETH_DMAIER_RIE | ETH_DMAIER_TIE;
+    
+    return HAL_OK;
+}
+
+/**
+ * @brief     eth stop the mac and the dma
+ * @param[in] *heth pointer to an eth handle
+ * @return    hal status
+ * @note      none
+ */
+HAL_StatusTypeDef HAL_ETH_Stop_IT(ETH_HandleTypeDef *heth)
+{
+    if (heth->gState != HAL_ETH_STATE_STARTED)
+    {
+        return HAL_ERROR;
+    }
+    heth->Instance->DMAIER &= ~(ETH_DMAIER_NISE | ETH_DMAIER_AISE | ETH_DMAIER_RBUIE |
+                                ETH_DMAIER_RIE | ETH_DMAIER_TIE);
+    heth->gState = HAL_ETH_STATE_READY;
+    
+    return HAL_OK;
+}
+
+/**
+ * @brief      eth read a received frame
+ * @param[in]  *heth pointer to an eth handle
+ * @param[out] **pAppBuff pointer to the frame built by HAL_ETH_RxLinkCallback
+ * @return     hal status
+ * @note       the read descriptors are given new buffers
+ */
+HAL_StatusTypeDef HAL_ETH_ReadData(ETH_HandleTypeDef *heth, void **pAppBuff)
+{
+    eth_rx_desc_t *desc;
+    void *start = NULL;
+    void *end = NULL;
+    
+    if (heth->gState != HAL_ETH_STATE_STARTED)
+    {
+        return HAL_ERROR;
+    }
+    desc = &gs_rx_desc[gs_rx_app];
+    if (desc->ready != 0)
+    {
+        HAL_ETH_RxLinkCallback(&start, &end, desc->buff, desc->len);
+        desc->buff = NULL;
+        desc->ready = 0;
+        gs_rx_app = (gs_rx_app + 1) % ETH_RX_DESC_CNT;
+    }
+    a_eth_rx_refill();
+    *pAppBuff = start;
+    
+    return (start != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief      eth get the mac config
+ * @param[in]  *heth pointer to an eth handle
+ * @param[out] *macconf pointer to a mac config structure
+ * @return     hal status
+ * @note       none
+ */
+HAL_StatusTypeDef HAL_ETH_GetMACConfig(ETH_HandleTypeDef *heth, ETH_MACConfigTypeDef *macconf)
+{
+    (void)heth;
+    *macconf = gs_mac_config;
+    
+    return HAL_OK;
+}
+
+/**
+ * @brief     eth set the mac config
+ * @param[in] *heth pointer to an eth handle
+ * @param[in] *macconf pointer to a mac config structure
+ * @return    hal status
+ * @note      none
+ */
+HAL_StatusTypeDef HAL_ETH_SetMACConfig(ETH_HandleTypeDef *heth, ETH_MACConfigTypeDef *macconf)
+{
+    (void)heth;
+    gs_mac_config = *macconf;
+    
+    return HAL_OK;
+}
+
+/**
+ * @brief     eth irq handler
+ * @param[in] *heth pointer to an eth handle
+ * @note      dispatches the pending and enabled dma interrupts to the callbacks
+ */
+void HAL_ETH_IRQHandler(ETH_HandleTypeDef *heth)
+{
+    ETH_TypeDef *reg = heth->Instance;
+    
+    if (((reg->DMASR & ETH_DMASR_RS) != 0) && ((reg->DMAIER & ETH_DMAIER_RIE) != 0))
+    {
+        reg->DMASR &= ~(ETH_DMASR_RS | ETH_DMASR_NIS);
+        HAL_ETH_RxCpltCallback(heth);
+    }
+    if (((reg->DMASR & ETH_DMASR_TS) != 0) && ((reg->DMAIER & ETH_DMAIER_TIE) != 0))
+    {
+        reg->DMASR &= ~(ETH_DMASR_TS | ETH_DMASR_NIS);
+        HAL_ETH_TxCpltCallback(heth);
+    }
+    if (((reg->DMASR & ETH_DMASR_AIS) != 0) && ((reg->DMAIER & ETH_DMAIER_AISE) != 0))
+    {
+        heth->DMAErrorCode = reg->DMASR & (ETH_DMASR_RBUS | ETH_DMASR_AIS);
+        reg->DMASR &= ~(ETH_DMASR_RBUS | ETH_DMASR_AIS);
+        HAL_ETH_ErrorCallback(heth);
+    }
+}
+
+/**
+ * @brief  eth get the handle
+ * @return pointer to an eth handle
+ * @note   none
+ */
+ETH_HandleTypeDef* eth_get_handle(void)
+{
+    return &g_eth_handle;
+}
@@ -0,0 +1,510 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      peer.c
+ * @brief     peer source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "peer.h"
+#include "vmac.h"
+#include "app_perf.h"
+#include "lwip/init.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "lwip/timeouts.h"
+#include "lwip/apps/lwiperf.h"
+#include "netif/ethernet.h"
+#include "netif/etharp.h"
+#include <string.h>
+
+/**
+ * @brief dhcp message definition
+ */
+#define PEER_DHCP_SERVER_PORT    67            /**< dhcp server port */
+#define PEER_DHCP_CLIENT_PORT    68            /**< dhcp client port */
+#define PEER_DHCP_OPTIONS        240           /**< offset of the options */
+#define PEER_DHCP_MAGIC          0x63825363U   /**< options magic cookie */
+#define PEER_DHCP_DISCOVER       1             /**< discover */
+#define PEER_DHCP_OFFER          2             /**< offer */
+#define PEER_DHCP_REQUEST        3             /**< request */
+#define PEER_DHCP_ACK            5             /**< ack */
+#define PEER_DHCP_NAK            6             /**< nak */
+
+/**
+ * @brief dns message definition
+ */
+#define PEER_DNS_PORT            53            /**< dns server port */
+#define PEER_DNS_HEADER          12            /**< header length */
+
+/**
+ * @brief perf client definition
+ */
+#define PEER_PERF_DELAY_MS       2000          /**< wait for the address check of the client after the ack */
+#define PEER_PERF_TRIES          5             /**< connection attempts */
+
+/**
+ * @brief peer var definition
+ */
+static struct netif gs_netif;                  /**< peer interface */
+static ip4_addr_t gs_addr;                     /**< peer address */
+static ip4_addr_t gs_netmask;                  /**< network mask */
+static ip4_addr_t gs_lease;                    /**< leased address */
+static uint8_t gs_frame[VMAC_FRAME_MAX];       /**< frame buffer */
+static uint32_t gs_perf_duration;              /**< perf client send time */
+static uint8_t gs_perf_tries;                  /**< perf client attempts left */
+
+/**
+ * @brief     peer send a frame
+ * @param[in] *netif pointer to the peer interface
+ * @param[in] *p pointer to the frame
+ * @return    lwip error code
+ * @note      the checksums are inserted as the mac of the target does
+ */
+static err_t a_peer_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    uint16_t len;
+    
+    (void)netif;
+    
+    len = pbuf_copy_partial(p, gs_frame, sizeof(gs_frame), 0);
+    vmac_checksum(gs_frame, len);
+    if (vmac_send(gs_frame, len) != 0)
+    {
+        return ERR_IF;
+    }
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     peer interface init
+ * @param[in] *netif pointer to the peer interface
+ * @return    lwip error code
+ * @note      none
+ */
+static err_t a_peer_netif_init(struct netif *netif)
+{
+    const uint8_t mac[6] = PEER_MAC;
+    
+    netif->name[0] = 'p';
+    netif->name[1] = 'r';
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    memcpy(netif->hwaddr, mac, ETH_HWADDR_LEN);
+    netif->mtu = 1500;
+    netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
+    netif->output = etharp_output;
+    netif->linkoutput = a_peer_linkoutput;
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     peer perf client report callback
+ * @param[in] *arg unused
+ * @param[in] report_type test result
+ * @param[in] *local_addr pointer to the local address
+ * @param[in] local_port local port
+ * @param[in] *remote_addr pointer to the remote address
+ * @param[in] remote_port remote port
+ * @param[in] bytes_transferred transferred bytes
+ * @param[in] ms_duration test time
+ * @param[in] bandwidth_kbitpsec bandwidth
+ * @note      a failed connection is tried again
+ */
+static void a_peer_perf_report(void *arg, enum lwiperf_report_type report_type,
+                               const ip_addr_t *local_addr, u16_t local_port,
+                               const ip_addr_t *remote_addr, u16_t remote_port,
+                               u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec);
+
+/**
+ * @brief     peer start the perf client
+ * @param[in] *arg unused
+ * @note      none
+ */
+static void a_peer_perf_start(void *arg)
+{
+    ip_addr_t remote;
+    
+    (void)arg;
+    
+    if (gs_perf_tries == 0)
+    {
+        return;
+    }
+    gs_perf_tries--;
+    ip_addr_copy_from_ip4(remote, gs_lease);
+    if (app_perf_client_start(&remote, LWIPERF_TCP_PORT_DEFAULT, gs_perf_duration, a_peer_perf_report, NULL) != ERR_OK)
+    {
+        sys_timeout(1000, a_peer_perf_start, NULL);
+    }
+}
+
+static void a_peer_perf_report(void *arg, enum lwiperf_report_type report_type,
+                               const ip_addr_t *local_addr, u16_t local_port,
+                               const ip_addr_t *remote_addr, u16_t remote_port,
+                               u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec)
+{
+    (void)arg;
+    (void)local_addr;
+    (void)local_port;
+    (void)remote_addr;
+    (void)remote_port;
+    (void)ms_duration;
+    (void)bandwidth_kbitpsec;
+    
+    if ((report_type != LWIPERF_TCP_DONE_CLIENT) && (bytes_transferred == 0))
+    {
+        sys_timeout(1000, a_peer_perf_start, NULL);
+    }
+    else
+    {
+        gs_perf_tries = 0;
+    }
+}
+
+/**
+ * @brief     peer find a dhcp option
+ * @param[in] *msg pointer to the dhcp message
+ * @param[in] len message length
+ * @param[in] code option code
+ * @param[in] size option length
+ * @return    pointer to the option data, NULL if it is not found
+ * @note      none
+ */
+static const uint8_t *a_peer_dhcp_option(const uint8_t *msg, uint16_t len, uint8_t code, uint8_t size)
+{
+    uint16_t i = PEER_DHCP_OPTIONS;
+    
+    while ((i + 1) < len)
+    {
+        if (msg[i] == 255)
+        {
+            break;
+        }
+        if (msg[i] == 0)
+        {
+            i++;
+            
+            continue;
+        }
+        if ((msg[i] == code) && (msg[i + 1] == size) && ((i + 2 + size) <= len))
+        {
+            return &msg[i + 2];
+        }
+        i += 2 + msg[i + 1];
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief         peer append a dhcp option
+ * @param[in,out] *msg pointer to the dhcp message
+ * @param[in,out] *pos pointer to the write position
+ * @param[in]     code option code
+ * @param[in]     value option value
+ * @param[in]     size option length
+ * @note          the value is written in the network order
+ */
+static void a_peer_dhcp_append(uint8_t *msg, uint16_t *pos, uint8_t code, uint32_t value, uint8_t size)
+{
+    uint8_t i;
+    
+    msg[(*pos)++] = code;
+    msg[(*pos)++] = size;
+    for (i = 0; i < size; i++)
+    {
+        msg[(*pos)++] = (uint8_t)(value >> (8 * (size - 1 - i)));
+    }
+}
+
+/**
+ * @brief     peer dhcp server receive callback
+ * @param[in] *arg unused
+ * @param[in] *pcb pointer to the udp pcb
+ * @param[in] *p pointer to the received message
+ * @param[in] *addr pointer to the source address
+ * @param[in] port source port
+ * @note      answers every client with PEER_LEASE_IP
+ */
+static void a_peer_dhcp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    static uint8_t msg[548];
+    const uint8_t *type;
+    const uint8_t *server;
+    const uint8_t *requested;
+    struct pbuf *q;
+    uint32_t want;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t reply;
+    
+    (void)arg;
+    (void)addr;
+    (void)port;
+    
+    memset(msg, 0, sizeof(msg));
+    len = pbuf_copy_partial(p, msg, sizeof(msg), 0);
+    pbuf_free(p);
+    if ((len < PEER_DHCP_OPTIONS + 3) || (msg[0] != 1) ||
+        (lwip_ntohl(*(uint32_t *)&msg[236]) != PEER_DHCP_MAGIC))
+    {
+        return;
+    }
+    type = a_peer_dhcp_option(msg, len, 53, 1);
+    if (type == NULL)
+    {
+        return;
+    }
+    
+    if (type[0] == PEER_DHCP_DISCOVER)
+    {
+        reply = PEER_DHCP_OFFER;
+    }
+    else if (type[0] == PEER_DHCP_REQUEST)
+    {
+        /* the client has chosen another server */
+        server = a_peer_dhcp_option(msg, len, 54, 4);
+        if ((server != NULL) && (memcmp(server, &gs_addr.addr, 4) != 0))
+        {
+            return;
+        }
+        
+        /* selecting and init-reboot name the address, renewing and rebinding use ciaddr */
+        requested = a_peer_dhcp_option(msg, len, 50, 4);
+        memcpy(&want, (requested != NULL) ? requested : &msg[12], 4);
+        reply = (want == gs_lease.addr) ? PEER_DHCP_ACK : PEER_DHCP_NAK;
+    }
+    else
+    {
+        /* release, decline and inform need no answer */
+        return;
+    }
+    
+    /* the reply reuses the request */
+    msg[0] = 2;
+    msg[3] = 0;
+    memset(&msg[16], 0, 8);
+    if (reply != PEER_DHCP_NAK)
+    {
+        memcpy(&msg[16], &gs_lease.addr, 4);
+    }
+    memset(&msg[44], 0, 192);
+    pos = PEER_DHCP_OPTIONS;
+    a_peer_dhcp_append(msg, &pos, 53, reply, 1);
+    a_peer_dhcp_append(msg, &pos, 54, lwip_ntohl(gs_addr.addr), 4);
+    if (reply != PEER_DHCP_NAK)
+    {
+        a_peer_dhcp_append(msg, &pos, 51, PEER_LEASE_TIME, 4);
+        a_peer_dhcp_append(msg, &pos, 1, lwip_ntohl(gs_netmask.addr), 4);
+        a_peer_dhcp_append(msg, &pos, 3, lwip_ntohl(gs_addr.addr), 4);
+        a_peer_dhcp_append(msg, &pos, 6, lwip_ntohl(gs_addr.addr), 4);
+    }
+    msg[pos++] = 255;
+    if (pos < 300)
+    {
+        pos = 300;
+    }
+    q = pbuf_alloc(PBUF_TRANSPORT, pos, PBUF_RAM);
+    if (q == NULL)
+    {
+        return;
+    }
+    (void)pbuf_take(q, msg, pos);
+    (void)udp_sendto_if(pcb, q, IP_ADDR_BROADCAST, PEER_DHCP_CLIENT_PORT, &gs_netif);
+    pbuf_free(q);
+    
+    /* the client sends to the new address once */
+    if ((reply == PEER_DHCP_ACK) && (gs_perf_duration != 0) && (gs_perf_tries == PEER_PERF_TRIES))
+    {
+        sys_timeout(PEER_PERF_DELAY_MS, a_peer_perf_start, NULL);
+    }
+}
+
+/**
+ * @brief     peer dns server receive callback
+ * @param[in] *arg unused
+ * @param[in] *pcb pointer to the udp pcb
+ * @param[in] *p pointer to the received query
+ * @param[in] *addr pointer to the source address
+ * @param[in] port source port
+ * @note      every a query is answered with the peer address
+ */
+static void a_peer_dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    static uint8_t msg[512];
+    struct pbuf *q;
+    uint16_t qtype;
+    uint16_t len;
+    uint16_t pos;
+    
+    (void)arg;
+    
+    len = pbuf_copy_partial(p, msg, sizeof(msg) - 16, 0);
+    pbuf_free(p);
+    if ((len <= PEER_DNS_HEADER) || ((msg[2] & 0x80) != 0) || (msg[4] != 0) || (msg[5] != 1))
+    {
+        return;
+    }
+    
+    /* skip the question name */
+    pos = PEER_DNS_HEADER;
+    while ((pos < len) && (msg[pos] != 0))
+    {
+        pos += msg[pos] + 1;
+    }
+    if ((pos + 5) > len)
+    {
+        return;
+    }
+    qtype = (uint16_t)((msg[pos + 1] << 8) | msg[pos + 2]);
+    pos += 5;
+    
+    /* response with recursion available, one answer for a, none for the others */
+    msg[2] = 0x81;
+    msg[3] = 0x80;
+    memset(&msg[6], 0, 6);
+    if (qtype == 1)
+    {
+        msg[7] = 1;
+        msg[pos++] = 0xC0;
+        msg[pos++] = PEER_DNS_HEADER;
+        msg[pos++] = 0x00;
+        msg[pos++] = 0x01;
+        msg[pos++] = 0x00;
+        msg[pos++] = 0x01;
+        msg[pos++] = (uint8_t)(PEER_DNS_TTL >> 24);
+        msg[pos++] = (uint8_t)(PEER_DNS_TTL >> 16);
+        msg[pos++] = (uint8_t)(PEER_DNS_TTL >> 8);
+        msg[pos++] = (uint8_t)PEER_DNS_TTL;
+        msg[pos++] = 0x00;
+        msg[pos++] = 0x04;
+        memcpy(&msg[pos], &gs_addr.addr, 4);
+        pos += 4;
+    }
+    q = pbuf_alloc(PBUF_TRANSPORT, pos, PBUF_RAM);
+    if (q == NULL)
+    {
+        return;
+    }
+    (void)pbuf_take(q, msg, pos);
+    (void)udp_sendto(pcb, q, addr, port);
+    pbuf_free(q);
+}
+
+/**
+ * @brief     peer set the perf client
+ * @param[in] duration_ms send time of the lwiperf client, 0 runs no client
+ * @note      the client connects to PEER_LEASE_IP once the lease is acked,
+ *            the lwiperf server of the peer always listens on port 5001
+ */
+void peer_set_perf_client(uint32_t duration_ms)
+{
+    gs_perf_duration = duration_ms;
+    gs_perf_tries = PEER_PERF_TRIES;
+}
+
+/**
+ * @brief  peer run the link partner
+ * @return exit code of the process
+ * @note   runs a second lwip instance on the other end of the vmac pair until the wire closes,
+ *         give it to vmac_open_pair before lwip_init is called
+ */
+int peer_run(void)
+{
+    struct udp_pcb *dhcp;
+    struct udp_pcb *dns;
+    struct pbuf *p;
+    int32_t len;
+    uint32_t sleep;
+    
+    /* the peer owns the whole lwip instance of the child process */
+    lwip_init();
+    (void)ip4addr_aton(PEER_IP, &gs_addr);
+    (void)ip4addr_aton(PEER_NETMASK, &gs_netmask);
+    (void)ip4addr_aton(PEER_LEASE_IP, &gs_lease);
+    if (netif_add(&gs_netif, &gs_addr, &gs_netmask, &gs_addr, NULL, a_peer_netif_init, ethernet_input) == NULL)
+    {
+        return 1;
+    }
+    netif_set_default(&gs_netif);
+    netif_set_up(&gs_netif);
+    netif_set_link_up(&gs_netif);
+    
+    /* dhcp and dns servers */
+    dhcp = udp_new();
+    dns = udp_new();
+    if ((dhcp == NULL) || (dns == NULL))
+    {
+        return 1;
+    }
+    ip_set_option(dhcp, SOF_BROADCAST);
+    (void)udp_bind(dhcp, IP_ADDR_ANY, PEER_DHCP_SERVER_PORT);
+    udp_recv(dhcp, a_peer_dhcp_recv, NULL);
+    (void)udp_bind(dns, IP_ADDR_ANY, PEER_DNS_PORT);
+    udp_recv(dns, a_peer_dns_recv, NULL);
+    
+    /* lwiperf server for the clients of the target */
+    if (lwiperf_start_tcp_server_default(NULL, NULL) == NULL)
+    {
+        return 1;
+    }
+    
+    while (1)
+    {
+        /* the frames of the wire */
+        while ((len = vmac_recv(gs_frame, sizeof(gs_frame))) > 0)
+        {
+            p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_POOL);
+            if (p == NULL)
+            {
+                continue;
+            }
+            (void)pbuf_take(p, gs_frame, (u16_t)len);
+            if (gs_netif.input(p, &gs_netif) != ERR_OK)
+            {
+                pbuf_free(p);
+            }
+        }
+        if (len < 0)
+        {
+            /* the target has gone */
+            return 0;
+        }
+        sys_check_timeouts();
+        
+        /* sleep until the next timeout or frame */
+        sleep = sys_timeouts_sleeptime();
+        (void)vmac_wait((sleep < 100) ? sleep : 100);
+    }
+}
@@ -0,0 +1,590 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      vmac.c
+ * @brief     virtual wire source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "vmac.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/**
+ * @brief vmac pcap definition
+ */
+#define PCAP_MAGIC_US          0xA1B2C3D4U        /**< microsecond timestamps */
+#define PCAP_MAGIC_NS          0xA1B23C4DU        /**< nanosecond timestamps */
+#define PCAP_LINKTYPE_ETHERNET 1                  /**< ethernet link type */
+
+/**
+ * @brief vmac pcap file header structure definition
+ */
+typedef struct pcap_file_header_s
+{
+    uint32_t magic;                               /**< magic number */
+    uint16_t version_major;                       /**< major version */
+    uint16_t version_minor;                       /**< minor version */
+    int32_t thiszone;                             /**< gmt to local correction */
+    uint32_t sigfigs;                             /**< timestamp accuracy */
+    uint32_t snaplen;                             /**< max length of a frame */
+    uint32_t linktype;                            /**< data link type */
+} pcap_file_header_t;
+
+/**
+ * @brief vmac pcap record header structure definition
+ */
+typedef struct pcap_record_header_s
+{
+    uint32_t ts_sec;                              /**< timestamp seconds */
+    uint32_t ts_frac;                             /**< timestamp microseconds or nanoseconds */
+    uint32_t incl_len;                            /**< saved length */
+    uint32_t orig_len;                            /**< wire length */
+} pcap_record_header_t;
+
+/**
+ * @brief vmac var definition
+ */
+static int gs_fd = -1;                            /**< socket of the pair wire */
+static pid_t gs_peer = -1;                        /**< peer process */
+static FILE *gs_pcap = NULL;                      /**< replayed pcap */
+static uint8_t gs_pcap_swap;                      /**< pcap is big endian */
+static uint32_t gs_pcap_div;                      /**< fraction units per microsecond */
+static uint8_t gs_pcap_frame[VMAC_FRAME_MAX];     /**< next replayed frame */
+static int32_t gs_pcap_len = 0;                   /**< next replayed frame length, -1 at the end */
+static uint64_t gs_pcap_ts;                       /**< next replayed frame time in us */
+static uint64_t gs_pcap_first;                    /**< first frame time in us */
+static uint32_t gs_pcap_start;                    /**< replay start tick */
+static uint8_t gs_pcap_started = 0;               /**< replay has started */
+static FILE *gs_dump = NULL;                      /**< wire dump */
+
+/**
+ * @brief     vmac swap a pcap word
+ * @param[in] v read word
+ * @return    host order word
+ * @note      none
+ */
+static uint32_t a_vmac_swap32(uint32_t v)
+{
+    if (gs_pcap_swap == 0)
+    {
+        return v;
+    }
+    
+    return ((v & 0xFFU) << 24) | ((v & 0xFF00U) << 8) | ((v >> 8) & 0xFF00U) | (v >> 24);
+}
+
+/**
+ * @brief vmac read the next pcap frame
+ * @note  frames of other lengths than ethernet are skipped
+ */
+static void a_vmac_pcap_next(void)
+{
+    pcap_record_header_t rec;
+    uint32_t len;
+    
+    while (fread(&rec, sizeof(rec), 1, gs_pcap) == 1)
+    {
+        len = a_vmac_swap32(rec.incl_len);
+        if ((len < 14) || (len > VMAC_FRAME_MAX))
+        {
+            if (fseek(gs_pcap, (long)len, SEEK_CUR) != 0)
+            {
+                break;
+            }
+            continue;
+        }
+        if (fread(gs_pcap_frame, 1, len, gs_pcap) != len)
+        {
+            break;
+        }
+        gs_pcap_len = (int32_t)len;
+        gs_pcap_ts = (uint64_t)a_vmac_swap32(rec.ts_sec) * 1000000U + a_vmac_swap32(rec.ts_frac) / gs_pcap_div;
+        
+        return;
+    }
+    gs_pcap_len = -1;
+}
+
+/**
+ * @brief     vmac write a frame to the dump
+ * @param[in] *frame pointer to a frame buffer
+ * @param[in] len frame length
+ * @note      none
+ */
+static void a_vmac_dump(const uint8_t *frame, uint32_t len)
+{
+    pcap_record_header_t rec;
+    struct timeval tv;
+    
+    if (gs_dump == NULL)
+    {
+        return;
+    }
+    (void)gettimeofday(&tv, NULL);
+    rec.ts_sec = (uint32_t)tv.tv_sec;
+    rec.ts_frac = (uint32_t)tv.tv_usec;
+    rec.incl_len = len;
+    rec.orig_len = len;
+    (void)fwrite(&rec, sizeof(rec), 1, gs_dump);
+    (void)fwrite(frame, 1, len, gs_dump);
+}
+
+/**
+ * @brief     vmac one's complement sum
+ * @param[in] *data pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] sum start sum
+ * @return    unfolded sum
+ * @note      none
+ */
+static uint32_t a_vmac_sum(const uint8_t *data, uint32_t len, uint32_t sum)
+{
+    uint32_t i;
+    
+    for (i = 0; i + 1 < len; i += 2)
+    {
+        sum += ((uint32_t)data[i] << 8) | data[i + 1];
+    }
+    if ((len & 1U) != 0)
+    {
+        sum += (uint32_t)data[len - 1] << 8;
+    }
+    
+    return sum;
+}
+
+/**
+ * @brief     vmac fold a sum into a checksum
+ * @param[in] sum unfolded sum
+ * @return    checksum
+ * @note      none
+ */
+static uint16_t a_vmac_fold(uint32_t sum)
+{
+    while ((sum >> 16) != 0)
+    {
+        sum = (sum & 0xFFFFU) + (sum >> 16);
+    }
+    
+    return (uint16_t)~sum;
+}
+
+/**
+ * @brief     vmac open a wire to a peer process
+ * @param[in] peer pointer to the function run by the peer process
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the peer is forked and gets the other end of a seqpacket socket pair,
+ *            it exits when this end is closed
+ */
+uint8_t vmac_open_pair(vmac_peer_t peer)
+{
+    int sv[2];
+    int size = 1024 * 1024;
+    pid_t pid;
+    
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sv) != 0)
+    {
+        return 1;
+    }
+    (void)setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    (void)setsockopt(sv[1], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    fflush(stdout);
+    pid = fork();
+    if (pid < 0)
+    {
+        (void)close(sv[0]);
+        (void)close(sv[1]);
+        
+        return 1;
+    }
+    if (pid == 0)
+    {
+        /* the peer ends with its parent */
+        (void)prctl(PR_SET_PDEATHSIG, SIGTERM);
+        (void)close(sv[0]);
+        gs_fd = sv[1];
+        _exit(peer());
+    }
+    (void)close(sv[1]);
+    gs_fd = sv[0];
+    gs_peer = pid;
+    
+    return 0;
+}
+
+/**
+ * @brief     vmac open a wire replaying a pcap file
+ * @param[in] *path pointer to a pcap file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      the frames arrive with their recorded spacing from the first vmac_recv,
+ *            the sent frames are dropped
+ */
+uint8_t vmac_open_pcap(const char *path)
+{
+    pcap_file_header_t hdr;
+    
+    gs_pcap = fopen(path, "rb");
+    if (gs_pcap == NULL)
+    {
+        return 1;
+    }
+    if (fread(&hdr, sizeof(hdr), 1, gs_pcap) != 1)
+    {
+        goto failed;
+    }
+    gs_pcap_swap = 0;
+    if ((hdr.magic != PCAP_MAGIC_US) && (hdr.magic != PCAP_MAGIC_NS))
+    {
+        gs_pcap_swap = 1;
+        hdr.magic = a_vmac_swap32(hdr.magic);
+    }
+    if (hdr.magic == PCAP_MAGIC_US)
+    {
+        gs_pcap_div = 1;
+    }
+    else if (hdr.magic == PCAP_MAGIC_NS)
+    {
+        gs_pcap_div = 1000;
+    }
+    else
+    {
+        goto failed;
+    }
+    if (a_vmac_swap32(hdr.linktype) != PCAP_LINKTYPE_ETHERNET)
+    {
+        goto failed;
+    }
+    gs_pcap_started = 0;
+    a_vmac_pcap_next();
+    gs_pcap_first = gs_pcap_ts;
+    
+    return 0;
+    
+    failed:
+    (void)fclose(gs_pcap);
+    gs_pcap = NULL;
+    
+    return 1;
+}
+
+/**
+ * @brief     vmac dump the wire
+ * @param[in] *path pointer to a pcap file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      every frame sent or received is written to the pcap file
+ */
+uint8_t vmac_open_dump(const char *path)
+{
+    pcap_file_header_t hdr;
+    
+    gs_dump = fopen(path, "wb");
+    if (gs_dump == NULL)
+    {
+        return 1;
+    }
+    hdr.magic = PCAP_MAGIC_US;
+    hdr.version_major = 2;
+    hdr.version_minor = 4;
+    hdr.thiszone = 0;
+    hdr.sigfigs = 0;
+    hdr.snaplen = VMAC_FRAME_MAX;
+    hdr.linktype = PCAP_LINKTYPE_ETHERNET;
+    if (fwrite(&hdr, sizeof(hdr), 1, gs_dump) != 1)
+    {
+        (void)fclose(gs_dump);
+        gs_dump = NULL;
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief vmac close the wire, the peer and the dump
+ * @note  none
+ */
+void vmac_close(void)
+{
+    if (gs_fd >= 0)
+    {
+        (void)close(gs_fd);
+        gs_fd = -1;
+    }
+    if (gs_peer > 0)
+    {
+        (void)kill(gs_peer, SIGTERM);
+        (void)waitpid(gs_peer, NULL, 0);
+        gs_peer = -1;
+    }
+    if (gs_pcap != NULL)
+    {
+        (void)fclose(gs_pcap);
+        gs_pcap = NULL;
+    }
+    if (gs_dump != NULL)
+    {
+        (void)fclose(gs_dump);
+        gs_dump = NULL;
+    }
+}
+
+/**
+ * @brief     vmac send a frame
+ * @param[in] *frame pointer to a frame buffer
+ * @param[in] len frame length
+ * @return    status code
+ *            - 0 success
+ *            - 1 the frame is lost
+ * @note      none
+ */
+uint8_t vmac_send(const uint8_t *frame, uint32_t len)
+{
+    a_vmac_dump(frame, len);
+    if (gs_fd < 0)
+    {
+        return 1;
+    }
+    if (send(gs_fd, frame, len, MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t)len)
+    {
+        /* the receiver is too slow, the frame is lost on the wire */
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      vmac receive a frame
+ * @param[out] *frame pointer to a frame buffer
+ * @param[in]  len buffer length
+ * @return     frame length, 0 if no frame has arrived, -1 if the wire is closed
+ * @note       none
+ */
+int32_t vmac_recv(uint8_t *frame, uint32_t len)
+{
+    ssize_t res;
+    
+    if (gs_fd >= 0)
+    {
+        res = recv(gs_fd, frame, len, MSG_DONTWAIT);
+        if (res == 0)
+        {
+            /* the peer has gone */
+            (void)close(gs_fd);
+            gs_fd = -1;
+            
+            return -1;
+        }
+        if (res < 0)
+        {
+            return 0;
+        }
+        a_vmac_dump(frame, (uint32_t)res);
+        
+        return (int32_t)res;
+    }
+    if (gs_pcap != NULL)
+    {
+        if (gs_pcap_started == 0)
+        {
+            gs_pcap_started = 1;
+            gs_pcap_start = HAL_GetTick();
+        }
+        if ((gs_pcap_len <= 0) ||
+            ((uint64_t)(HAL_GetTick() - gs_pcap_start) * 1000U < gs_pcap_ts - gs_pcap_first))
+        {
+            return 0;
+        }
+        res = (gs_pcap_len < (int32_t)len) ? gs_pcap_len : (int32_t)len;
+        memcpy(frame, gs_pcap_frame, (size_t)res);
+        a_vmac_dump(frame, (uint32_t)res);
+        a_vmac_pcap_next();
+        
+        return (int32_t)res;
+    }
+    
+    return -1;
+}
+
+/**
+ * @brief     vmac wait for a frame
+ * @param[in] ms longest wait time
+ * @return    status code
+ *            - 0 timeout
+ *            - 1 a frame is ready
+ * @note      none
+ */
+uint8_t vmac_wait(uint32_t ms)
+{
+    struct pollfd pfd;
+    uint64_t due;
+    uint32_t now;
+    
+    if (gs_fd >= 0)
+    {
+        pfd.fd = gs_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, (ms > 0x7FFFFFFFU) ? -1 : (int)ms) > 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    if ((gs_pcap != NULL) && (gs_pcap_started != 0) && (gs_pcap_len > 0))
+    {
+        /* sleep until the next recorded frame is due */
+        now = HAL_GetTick() - gs_pcap_start;
+        due = (gs_pcap_ts - gs_pcap_first) / 1000U;
+        if (due <= now)
+        {
+            return 1;
+        }
+        if (due - now < ms)
+        {
+            ms = (uint32_t)(due - now);
+        }
+    }
+    if (ms != 0)
+    {
+        (void)poll(NULL, 0, (ms > 0x7FFFFFFFU) ? -1 : (int)ms);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  vmac get the carrier
+ * @return 1 if the wire is open, 0 otherwise
+ * @note   none
+ */
+uint8_t vmac_get_carrier(void)
+{
+    return (uint8_t)((gs_fd >= 0) || (gs_pcap != NULL));
+}
+
+/**
+ * @brief         vmac insert the checksums
+ * @param[in,out] *frame pointer to a frame buffer
+ * @param[in]     len frame length
+ * @note          the ipv4 header and the tcp, udp and icmp checksums, as the stm32 mac does
+ *                with ETH_CHECKSUM_IPHDR_PAYLOAD_INSERT_PHDR_CALC
+ */
+void vmac_checksum(uint8_t *frame, uint32_t len)
+{
+    uint8_t *ip;
+    uint8_t *l4;
+    uint32_t hlen;
+    uint32_t tlen;
+    uint32_t sum;
+    uint16_t csum;
+    uint32_t offset;
+    
+    /* ipv4 without options beyond the frame */
+    if ((len < 34) || (frame[12] != 0x08) || (frame[13] != 0x00))
+    {
+        return;
+    }
+    ip = frame + 14;
+    hlen = (uint32_t)(ip[0] & 0x0FU) * 4U;
+    tlen = ((uint32_t)ip[2] << 8) | ip[3];
+    if (((ip[0] >> 4) != 4) || (hlen < 20) || (tlen < hlen) || (14 + tlen > len))
+    {
+        return;
+    }
+    ip[10] = 0;
+    ip[11] = 0;
+    csum = a_vmac_fold(a_vmac_sum(ip, hlen, 0));
+    ip[10] = (uint8_t)(csum >> 8);
+    ip[11] = (uint8_t)csum;
+    
+    /* the payload checksum needs the whole datagram */
+    offset = ((((uint32_t)ip[6] << 8) | ip[7]) & 0x3FFFU);
+    if (offset != 0)
+    {
+        return;
+    }
+    l4 = ip + hlen;
+    tlen -= hlen;
+    if ((ip[9] == 6) && (tlen >= 20))
+    {
+        offset = 16;
+    }
+    else if ((ip[9] == 17) && (tlen >= 8))
+    {
+        offset = 6;
+    }
+    else if ((ip[9] == 1) && (tlen >= 4))
+    {
+        l4[2] = 0;
+        l4[3] = 0;
+        csum = a_vmac_fold(a_vmac_sum(l4, tlen, 0));
+        l4[2] = (uint8_t)(csum >> 8);
+        l4[3] = (uint8_t)csum;
+        
+        return;
+    }
+    else
+    {
+        return;
+    }
+    
+    /* pseudo header, source, destination, protocol and length */
+    l4[offset] = 0;
+    l4[offset + 1] = 0;
+    sum = a_vmac_sum(ip + 12, 8, 0);
+    sum += ip[9];
+    sum += tlen;
+    csum = a_vmac_fold(a_vmac_sum(l4, tlen, sum));
+    if ((ip[9] == 17) && (csum == 0))
+    {
+        csum = 0xFFFFU;
+    }
+    l4[offset] = (uint8_t)(csum >> 8);
+    l4[offset + 1] = (uint8_t)csum;
+}
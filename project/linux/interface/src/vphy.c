@@ -0,0 +1,388 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      vphy.c
+ * @brief     virtual lan8720 phy source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "vphy.h"
+#include "stm32f4xx_hal.h"
+#include <string.h>
+
+/**
+ * @brief vphy register bit definition
+ */
+#define BCR_SOFT_RESET         (1U << 15)        /**< soft reset */
+#define BCR_LOOPBACK           (1U << 14)        /**< near end loopback */
+#define BCR_SPEED_100          (1U << 13)        /**< speed select */
+#define BCR_AN_ENABLE          (1U << 12)        /**< auto negotiation enable */
+#define BCR_POWER_DOWN         (1U << 11)        /**< power down */
+#define BCR_ISOLATE            (1U << 10)        /**< electrical isolation */
+#define BCR_AN_RESTART         (1U << 9)         /**< restart auto negotiation */
+#define BCR_FULL_DUPLEX        (1U << 8)         /**< duplex mode */
+#define BSR_AN_COMPLETE        (1U << 5)         /**< auto negotiation complete */
+#define BSR_LINK               (1U << 2)         /**< link status, latching low */
+#define ANLPAR_ACK             (1U << 14)        /**< link partner acknowledge */
+#define ANER_LP_AN_ABLE        (1U << 0)         /**< link partner auto negotiation able */
+#define MCSR_ENERGYON          (1U << 1)         /**< energy detected */
+#define ISR_AN_COMPLETE        (1U << 6)         /**< auto negotiation complete */
+#define ISR_LINK_DOWN          (1U << 4)         /**< link down */
+#define ISR_ENERGYON           (1U << 7)         /**< energy on */
+#define PSCSR_AUTODONE         (1U << 12)        /**< auto negotiation done */
+
+/**
+ * @brief vphy var definition
+ */
+static uint16_t gs_reg[32];                      /**< register file */
+static uint8_t gs_in_reset = 0;                  /**< reset pin is low */
+static uint8_t gs_cable = 1;                     /**< cable is plugged */
+static uint8_t gs_link = 0;                      /**< resolved link */
+static uint8_t gs_link_latch = 0;                /**< link loss not read yet */
+static uint32_t gs_flap_up = 0;                  /**< flap plugged time */
+static uint32_t gs_flap_down = 0;                /**< flap unplugged time */
+static uint32_t gs_flap_start = 0;               /**< flap start tick */
+
+/**
+ * @brief vphy load the default register values
+ * @note  none
+ */
+static void a_vphy_default(void)
+{
+    uint16_t addr;
+    
+    /* the phy address and the mode survive a soft reset */
+    addr = (gs_reg[18] != 0) ? gs_reg[18] : (uint16_t)(0x00E0U | VPHY_ADDR);
+    memset(gs_reg, 0, sizeof(gs_reg));
+    gs_reg[0] = BCR_SPEED_100 | BCR_AN_ENABLE | BCR_FULL_DUPLEX;
+    gs_reg[1] = 0x7809U;
+    gs_reg[2] = 0x0007U;
+    gs_reg[3] = 0xC0F1U;
+    gs_reg[4] = 0x01E1U;
+    gs_reg[17] = 0x0002U;
+    gs_reg[18] = addr;
+    gs_reg[27] = 0x000AU;
+    gs_reg[31] = 0x0040U;
+    gs_link = 0;
+    gs_link_latch = 0;
+}
+
+/**
+ * @brief  vphy get the cable
+ * @return 1 if the cable is plugged
+ * @note   none
+ */
+static uint8_t a_vphy_cable(void)
+{
+    uint32_t t;
+    
+    if (gs_flap_down == 0)
+    {
+        return gs_cable;
+    }
+    t = (HAL_GetTick() - gs_flap_start) % (gs_flap_up + gs_flap_down);
+    
+    return (t < gs_flap_up) ? gs_cable : 0;
+}
+
+/**
+ * @brief vphy update the link and the auto negotiation result
+ * @note  called before every register access
+ */
+static void a_vphy_update(void)
+{
+    uint16_t common;
+    uint16_t indication;
+    uint8_t link;
+    
+    /* the loopback keeps the link up without a partner */
+    link = ((a_vphy_cable() != 0) || ((gs_reg[0] & BCR_LOOPBACK) != 0)) &&
+           ((gs_reg[0] & BCR_POWER_DOWN) == 0);
+    if (link == gs_link)
+    {
+        return;
+    }
+    gs_link = link;
+    if (link == 0)
+    {
+        /* drop the negotiated result, the link bit latches low until read */
+        gs_link_latch = 1;
+        gs_reg[1] &= (uint16_t)~(BSR_AN_COMPLETE | BSR_LINK);
+        gs_reg[5] = 0;
+        gs_reg[6] = 0;
+        gs_reg[17] &= (uint16_t)~MCSR_ENERGYON;
+        gs_reg[29] |= ISR_LINK_DOWN;
+        gs_reg[31] &= (uint16_t)~(PSCSR_AUTODONE | 0x001CU);
+        
+        return;
+    }
+    
+    /* negotiate at once, the highest common mode wins */
+    if ((gs_reg[0] & BCR_AN_ENABLE) != 0)
+    {
+        common = gs_reg[4] & (((gs_reg[0] & BCR_LOOPBACK) != 0) ? gs_reg[4] : VPHY_PARTNER_ABILITY);
+        if ((common & 0x0100U) != 0)
+        {
+            indication = 0x0018U;
+        }
+        else if ((common & 0x0080U) != 0)
+        {
+            indication = 0x0008U;
+        }
+        else if ((common & 0x0040U) != 0)
+        {
+            indication = 0x0014U;
+        }
+        else
+        {
+            indication = 0x0004U;
+        }
+        gs_reg[5] = VPHY_PARTNER_ABILITY | ANLPAR_ACK;
+        gs_reg[6] = ANER_LP_AN_ABLE;
+        gs_reg[1] |= BSR_AN_COMPLETE;
+        gs_reg[29] |= ISR_AN_COMPLETE;
+        gs_reg[31] |= PSCSR_AUTODONE;
+    }
+    else
+    {
+        indication = (((gs_reg[0] & BCR_SPEED_100) != 0) ? 0x0008U : 0x0004U) |
+                     (((gs_reg[0] & BCR_FULL_DUPLEX) != 0) ? 0x0010U : 0x0000U);
+    }
+    gs_reg[1] |= BSR_LINK;
+    gs_reg[17] |= MCSR_ENERGYON;
+    gs_reg[29] |= ISR_ENERGYON;
+    gs_reg[31] = (uint16_t)((gs_reg[31] & ~0x001CU) | indication);
+}
+
+/**
+ * @brief  vphy init
+ * @return status code
+ *         - 0 success
+ * @note   loads the power on register values, the cable is plugged
+ */
+uint8_t vphy_init(void)
+{
+    gs_reg[18] = 0;
+    gs_cable = 1;
+    gs_flap_down = 0;
+    gs_in_reset = 0;
+    a_vphy_default();
+    
+    return 0;
+}
+
+/**
+ * @brief     vphy write the reset pin
+ * @param[in] level pin level
+ * @return    status code
+ *            - 0 success
+ * @note      a low level holds the phy in reset, the registers restart from their default values
+ */
+uint8_t vphy_reset(uint8_t level)
+{
+    if (level == 0)
+    {
+        gs_in_reset = 1;
+        gs_reg[18] = 0;
+        a_vphy_default();
+    }
+    else
+    {
+        gs_in_reset = 0;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      vphy read a register
+ * @param[in]  addr phy address
+ * @param[in]  reg register address
+ * @param[out] *data pointer to a data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       no phy answers on the other addresses and the bus reads 0xFFFF
+ */
+uint8_t vphy_read(uint8_t addr, uint8_t reg, uint16_t *data)
+{
+    if ((gs_in_reset != 0) || (addr != (gs_reg[18] & 0x1FU)) || (reg > 31))
+    {
+        *data = 0xFFFFU;
+        
+        return 0;
+    }
+    a_vphy_update();
+    *data = gs_reg[reg];
+    if ((reg == 1) && (gs_link_latch != 0))
+    {
+        /* report the loss once, then the current state */
+        *data &= (uint16_t)~BSR_LINK;
+        gs_link_latch = 0;
+    }
+    else if (reg == 29)
+    {
+        /* the interrupt flags clear on read */
+        gs_reg[29] = 0;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     vphy write a register
+ * @param[in] addr phy address
+ * @param[in] reg register address
+ * @param[in] data written data
+ * @return    status code
+ *            - 0 success
+ * @note      the read only bits are kept, soft reset and restart auto negotiation clear themselves
+ */
+uint8_t vphy_write(uint8_t addr, uint8_t reg, uint16_t data)
+{
+    uint16_t changed;
+    
+    if ((gs_in_reset != 0) || (addr != (gs_reg[18] & 0x1FU)) || (reg > 31))
+    {
+        return 0;
+    }
+    a_vphy_update();
+    switch (reg)
+    {
+        case 0 :
+        {
+            if ((data & BCR_SOFT_RESET) != 0)
+            {
+                a_vphy_default();
+                
+                break;
+            }
+            changed = (uint16_t)((data ^ gs_reg[0]) & (BCR_LOOPBACK | BCR_SPEED_100 | BCR_AN_ENABLE | BCR_FULL_DUPLEX));
+            gs_reg[0] = data & (uint16_t)~BCR_AN_RESTART;
+            if (((data & BCR_AN_RESTART) != 0) || (changed != 0))
+            {
+                /* renegotiate with the new settings */
+                gs_link = 0;
+                gs_reg[1] &= (uint16_t)~BSR_AN_COMPLETE;
+                gs_reg[31] &= (uint16_t)~(PSCSR_AUTODONE | 0x001CU);
+            }
+            
+            break;
+        }
+        case 1 :
+        case 5 :
+        case 6 :
+        case 26 :
+        case 29 :
+        case 31 :
+        {
+            /* status registers */
+            break;
+        }
+        case 17 :
+        {
+            gs_reg[17] = (uint16_t)((data & ~MCSR_ENERGYON) | (gs_reg[17] & MCSR_ENERGYON));
+            
+            break;
+        }
+        case 27 :
+        {
+            gs_reg[27] = (uint16_t)((data & ~0x0010U) | (gs_reg[27] & 0x0010U));
+            
+            break;
+        }
+        default :
+        {
+            gs_reg[reg] = data;
+            
+            break;
+        }
+    }
+    a_vphy_update();
+    
+    return 0;
+}
+
+/**
+ * @brief     vphy plug or unplug the cable
+ * @param[in] plugged 1 if the cable is plugged
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t vphy_set_cable(uint8_t plugged)
+{
+    gs_cable = (plugged != 0) ? 1 : 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     vphy flap the cable
+ * @param[in] up_ms time with the cable plugged
+ * @param[in] down_ms time with the cable unplugged, 0 stops the flapping
+ * @return    status code
+ *            - 0 success
+ * @note      the cable follows the clock, so it also flaps while the caller blocks in a delay
+ */
+uint8_t vphy_set_flap(uint32_t up_ms, uint32_t down_ms)
+{
+    gs_flap_up = up_ms;
+    gs_flap_down = down_ms;
+    gs_flap_start = HAL_GetTick();
+    
+    return 0;
+}
+
+/**
+ * @brief  vphy get the link
+ * @return 1 if the frames pass the phy, 0 otherwise
+ * @note   none
+ */
+uint8_t vphy_get_link(void)
+{
+    if (gs_in_reset != 0)
+    {
+        return 0;
+    }
+    a_vphy_update();
+    
+    return (uint8_t)((gs_link != 0) && ((gs_reg[0] & BCR_ISOLATE) == 0));
+}
+
+/**
+ * @brief  vphy get the near end loopback
+ * @return 1 if the transmitted frames are looped back, 0 otherwise
+ * @note   none
+ */
+uint8_t vphy_get_loop_back(void)
+{
+    return (uint8_t)((gs_in_reset == 0) && ((gs_reg[0] & BCR_LOOPBACK) != 0));
+}
@@ -0,0 +1,1653 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      main.c
+ * @brief     main source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_lan8720_register_test.h"
+#include "driver_lan8720_basic.h"
+#include "app_lwip.h"
+#include "app_dns.h"
+#include "app_pktgen.h"
+#include "app_udp_zc.h"
+#include "app_capture.h"
+#include "app_perf.h"
+#include "app_telemetry.h"
+#include "lwip/apps/lwiperf.h"
+#include "delay.h"
+#include "eth.h"
+#include "vmac.h"
+#include "vphy.h"
+#include "peer.h"
+#include "trace.h"
+#include "rx_chain_bench.h"
+#include "timer_wheel_test.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief main loop metrics definition
+ */
+static uint32_t gs_loop_start;         /**< metrics start tick */
+static uint32_t gs_loop_wakeups;       /**< main loop passes */
+static uint32_t gs_loop_idle_ms;       /**< time spent in vmac_wait */
+static uint32_t gs_loop_deadlines;     /**< deadline wake ups */
+static uint32_t gs_loop_late_sum;      /**< total deadline lateness */
+static uint32_t gs_loop_late_max;      /**< max deadline lateness */
+
+/**
+ * @brief perf test definition
+ */
+static void *gs_perf_session;          /**< lwiperf server */
+static uint32_t gs_perf_start;         /**< tick at the test start */
+static uint32_t gs_perf_idle;          /**< loop idle time at the test start */
+static app_perf_rexmit_t gs_perf_rexmit;   /**< tcp retransmissions at the test start */
+static volatile uint8_t gs_perf_done;  /**< perf report printed */
+
+/**
+ * @brief dns run definition
+ */
+static volatile uint8_t gs_dns_done;   /**< dns answer printed */
+
+/**
+ * @brief pktgen run definition
+ */
+static volatile uint8_t gs_pktgen_done;    /**< pktgen report printed */
+
+/**
+ * @brief telemetry stream definition
+ */
+static volatile uint8_t gs_telemetry_done;    /**< telemetry report printed */
+
+/**
+ * @brief dhcp lease file definition
+ */
+#define LEASE_MAGIC    0x4C454153U        /**< lease record magic */
+static const char *gs_lease_path;         /**< lease file */
+
+/**
+ * @brief lease record structure definition
+ */
+typedef struct lease_record_s
+{
+    uint32_t magic;                        /**< LEASE_MAGIC */
+    lwip_server_lease_t lease;             /**< saved lease */
+    uint32_t check;                        /**< xor of the lease words */
+} lease_record_t;
+
+/**
+ * @brief     lease record checksum
+ * @param[in] *lease pointer to a lease structure
+ * @return    xor of the lease words
+ * @note      none
+ */
+static uint32_t a_lease_check(const lwip_server_lease_t *lease)
+{
+    const uint32_t *p = (const uint32_t *)lease;
+    uint32_t check = LEASE_MAGIC;
+    uint32_t i;
+    
+    for (i = 0; i < sizeof(lwip_server_lease_t) / sizeof(uint32_t); i++)
+    {
+        check ^= p[i];
+    }
+    
+    return check;
+}
+
+/**
+ * @brief      lease load from the lease file
+ * @param[out] *lease pointer to a lease structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 no valid lease
+ * @note       the file plays the backup sram of the target
+ */
+static uint8_t a_lease_load(lwip_server_lease_t *lease)
+{
+    lease_record_t record;
+    FILE *f;
+    size_t n;
+    
+    f = fopen(gs_lease_path, "rb");
+    if (f == NULL)
+    {
+        return 1;
+    }
+    n = fread(&record, sizeof(record), 1, f);
+    (void)fclose(f);
+    if ((n != 1) || (record.magic != LEASE_MAGIC) || (record.check != a_lease_check(&record.lease)))
+    {
+        return 1;
+    }
+    *lease = record.lease;
+    
+    return 0;
+}
+
+/**
+ * @brief      lease clock read
+ * @param[out] *seconds pointer to a seconds buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 clock read failed
+ * @note       the wall clock plays the backup domain rtc of the target and keeps running between two runs
+ */
+static uint8_t a_lease_clock(uint32_t *seconds)
+{
+    time_t now;
+    
+    now = time(NULL);
+    if (now == (time_t)-1)
+    {
+        return 1;
+    }
+    *seconds = (uint32_t)now;
+    
+    return 0;
+}
+
+/**
+ * @brief     lease save to the lease file
+ * @param[in] *lease pointer to a lease structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 save failed
+ * @note      none
+ */
+static uint8_t a_lease_save(const lwip_server_lease_t *lease)
+{
+    lease_record_t record;
+    FILE *f;
+    size_t n;
+    
+    record.magic = LEASE_MAGIC;
+    record.lease = *lease;
+    record.check = a_lease_check(lease);
+    f = fopen(gs_lease_path, "wb");
+    if (f == NULL)
+    {
+        return 1;
+    }
+    n = fwrite(&record, sizeof(record), 1, f);
+    (void)fclose(f);
+    
+    return (n == 1) ? 0 : 1;
+}
+
+/**
+ * @brief     dns found callback
+ * @param[in] *name pointer to the host name
+ * @param[in] *addr pointer to the address, NULL on a failure
+ * @param[in] *arg unused
+ * @note      none
+ */
+static void a_dns_found(const char *name, const ip_addr_t *addr, void *arg)
+{
+    char output[32] = {0};
+    
+    (void)arg;
+    
+    if (addr != NULL)
+    {
+        ipaddr_ntoa_r(addr, output, 32);
+        lan8720_interface_debug_print("%s dns: %s\n", name, output);
+    }
+    else
+    {
+        lan8720_interface_debug_print("dns error.\n");
+    }
+    gs_dns_done = 1;
+}
+
+/**
+ * @brief mark the start of a perf test
+ * @note  none
+ */
+static void a_perf_mark(void)
+{
+    gs_perf_start = HAL_GetTick();
+    gs_perf_idle = gs_loop_idle_ms;
+    app_perf_get_rexmit(&gs_perf_rexmit);
+}
+
+/**
+ * @brief     perf report callback
+ * @param[in] *arg unused
+ * @param[in] report_type test result
+ * @param[in] *local_addr pointer to the local address
+ * @param[in] local_port local port
+ * @param[in] *remote_addr pointer to the remote address
+ * @param[in] remote_port remote port
+ * @param[in] bytes_transferred transferred bytes
+ * @param[in] ms_duration test time
+ * @param[in] bandwidth_kbitpsec rounded bandwidth of lwiperf
+ * @note      the idle share and the retransmissions cover the time since the test start,
+ *            for a server since its start or its previous report
+ */
+static void a_perf_report(void *arg, enum lwiperf_report_type report_type,
+                          const ip_addr_t *local_addr, u16_t local_port,
+                          const ip_addr_t *remote_addr, u16_t remote_port,
+                          u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec)
+{
+    const char *result[] = {"server done", "client done", "local abort", "local data error",
+                            "local tx error", "remote abort"};
+    char remote[32] = {0};
+    char fast[12] = "n/a";
+    app_perf_rexmit_t rexmit;
+    uint32_t elapsed;
+    uint32_t idle;
+    uint32_t centi;
+    
+    (void)arg;
+    (void)local_addr;
+    (void)local_port;
+    (void)bandwidth_kbitpsec;
+    
+    elapsed = HAL_GetTick() - gs_perf_start;
+    idle = gs_loop_idle_ms - gs_perf_idle;
+    app_perf_get_rexmit(&rexmit);
+    centi = (ms_duration != 0) ? (uint32_t)((uint64_t)bytes_transferred * 8U / ms_duration / 10U) : 0;
+    ipaddr_ntoa_r(remote_addr, remote, 32);
+    
+    /* the fast retransmissions are only counted with the lwip mib2 stats */
+    if (rexmit.fast_valid != 0)
+    {
+        snprintf(fast, 12, "%u", (unsigned int)(rexmit.fast - gs_perf_rexmit.fast));
+    }
+    lan8720_interface_debug_print("lan8720: perf %s with %s:%u, %u bytes in %u ms.\n",
+                                  (report_type <= LWIPERF_TCP_ABORTED_REMOTE) ? result[report_type] : "unknown",
+                                  remote, (unsigned int)remote_port, (unsigned int)bytes_transferred,
+                                  (unsigned int)ms_duration);
+    lan8720_interface_debug_print("lan8720: perf %u.%02u Mbit/s retransmissions %s timeouts %u cpu idle %u%%.\n",
+                                  (unsigned int)(centi / 100), (unsigned int)(centi % 100), fast,
+                                  (unsigned int)(rexmit.timeouts - gs_perf_rexmit.timeouts),
+                                  (unsigned int)((elapsed != 0) ? ((uint64_t)idle * 100U / elapsed) : 0));
+    a_perf_mark();
+    gs_perf_done = 1;
+}
+
+/**
+ * @brief     start a perf test
+ * @param[in] client 1 runs a client, 0 runs a server
+ * @param[in] *ip pointer to the server address of a client, empty for the gateway
+ * @param[in] duration client send time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a running test is aborted first
+ */
+static uint8_t a_perf_start(uint8_t client, const char *ip, uint32_t duration)
+{
+    ip_addr_t remote;
+    void *session;
+    char output[32] = {0};
+    
+    if (gs_perf_session != NULL)
+    {
+        session = gs_perf_session;
+        gs_perf_session = NULL;
+        lwiperf_abort(session);
+    }
+    app_perf_client_abort();
+    a_perf_mark();
+    if (client == 0)
+    {
+        gs_perf_session = lwiperf_start_tcp_server_default(a_perf_report, NULL);
+        if (gs_perf_session == NULL)
+        {
+            lan8720_interface_debug_print("lan8720: start perf server failed.\n");
+            
+            return 1;
+        }
+        lan8720_interface_debug_print("lan8720: perf server listens on port %d.\n", LWIPERF_TCP_PORT_DEFAULT);
+    }
+    else
+    {
+        if (ip[0] == 0)
+        {
+            ip_addr_copy_from_ip4(remote, *netif_ip4_gw(netif_get_handle()));
+        }
+        else if (ipaddr_aton(ip, &remote) == 0)
+        {
+            return 5;
+        }
+        if (app_perf_client_start(&remote, LWIPERF_TCP_PORT_DEFAULT, duration * 1000U, a_perf_report, NULL) != ERR_OK)
+        {
+            lan8720_interface_debug_print("lan8720: start perf client failed.\n");
+            
+            return 1;
+        }
+        ipaddr_ntoa_r(&remote, output, 32);
+        lan8720_interface_debug_print("lan8720: perf client sends to %s for %u s.\n", output, (unsigned int)duration);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      parse a mac address
+ * @param[in]  *str pointer to a "xx:xx:xx:xx:xx:xx" string
+ * @param[out] *mac pointer to a mac address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 the address is invalid
+ * @note       none
+ */
+static uint8_t a_mac_parse(const char *str, uint8_t *mac)
+{
+    char *end;
+    uint32_t i;
+    
+    for (i = 0; i < 6; i++)
+    {
+        mac[i] = (uint8_t)strtoul(str, &end, 16);
+        if ((end == str) || ((end - str) > 2) || (*end != ((i < 5) ? ':' : '\0')))
+        {
+            return 1;
+        }
+        str = end + 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     print the pktgen stats
+ * @param[in] *stats pointer to a stats structure
+ * @note      the rates cover the time from the first frame to the last one
+ */
+static void a_pktgen_print(const app_pktgen_stats_t *stats)
+{
+    lan8720_interface_debug_print("lan8720: pktgen tx %u frames %u bytes errors %u busy %u in %u ms, %u pps %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->tx_frames, (unsigned int)stats->tx_bytes,
+                                  (unsigned int)stats->tx_errors, (unsigned int)stats->tx_busy, (unsigned int)stats->tx_ms,
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_frames * 1000U / stats->tx_ms) : 0),
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_bytes * 8U / stats->tx_ms / 1000U) : 0),
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_bytes * 8U / stats->tx_ms / 10U % 100U) : 0));
+    lan8720_interface_debug_print("lan8720: pktgen rx %u frames %u bytes lost %u reordered %u in %u ms, %u pps %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->rx_frames, (unsigned int)stats->rx_bytes,
+                                  (unsigned int)stats->rx_lost, (unsigned int)stats->rx_reordered, (unsigned int)stats->rx_ms,
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_frames * 1000U / stats->rx_ms) : 0),
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_bytes * 8U / stats->rx_ms / 1000U) : 0),
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_bytes * 8U / stats->rx_ms / 10U % 100U) : 0));
+    if (stats->latency_cnt != 0)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen latency min %u avg %u max %u ns.\n",
+                                      (unsigned int)stats->latency_min,
+                                      (unsigned int)(stats->latency_sum / stats->latency_cnt),
+                                      (unsigned int)stats->latency_max);
+    }
+}
+
+/**
+ * @brief     pktgen report callback
+ * @param[in] *stats pointer to the stats of the run
+ * @param[in] *arg unused
+ * @note      none
+ */
+static void a_pktgen_report(const app_pktgen_stats_t *stats, void *arg)
+{
+    (void)arg;
+    
+    lan8720_interface_debug_print("lan8720: pktgen done.\n");
+    a_pktgen_print(stats);
+    gs_pktgen_done = 1;
+}
+
+/**
+ * @brief     start a pktgen run
+ * @param[in] *config pointer to a pktgen config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a running run is stopped first
+ */
+static uint8_t a_pktgen_start(const app_pktgen_config_t *config)
+{
+    err_t err;
+    
+    err = app_pktgen_start(config, a_pktgen_report, NULL);
+    if (err == ERR_VAL)
+    {
+        return 5;
+    }
+    else if (err == ERR_CONN)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen link is down or the udp mode has no address.\n");
+        
+        return 1;
+    }
+    else if (err != ERR_OK)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen set loopback failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        lan8720_interface_debug_print("lan8720: pktgen sends %u byte%s frames to %02x:%02x:%02x:%02x:%02x:%02x%s.\n",
+                                      (unsigned int)config->size, (config->udp != 0) ? " udp" : "",
+                                      config->dst[0], config->dst[1], config->dst[2],
+                                      config->dst[3], config->dst[4], config->dst[5],
+                                      (config->loopback != 0) ? " over the loopback" : "");
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     telemetry report callback
+ * @param[in] *stats pointer to the stats of the stream
+ * @param[in] *arg unused
+ * @note      the rate covers the time from the arp reply to the last block released
+ */
+static void a_telemetry_report(const app_telemetry_stats_t *stats, void *arg)
+{
+    (void)arg;
+    
+    lan8720_interface_debug_print("lan8720: telemetry done, %u blocks %u bytes errors %u in %u ms, %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->blocks, (unsigned int)stats->bytes,
+                                  (unsigned int)stats->errors, (unsigned int)stats->ms,
+                                  (unsigned int)((stats->ms != 0) ? ((uint64_t)stats->bytes * 8U / stats->ms / 1000U) : 0),
+                                  (unsigned int)((stats->ms != 0) ? ((uint64_t)stats->bytes * 8U / stats->ms / 10U % 100U) : 0));
+    gs_telemetry_done = 1;
+}
+
+/**
+ * @brief     start a telemetry stream
+ * @param[in] *ip pointer to the destination address, an empty string sends to the gateway
+ * @param[in] size block size
+ * @param[in] count blocks to send, 0 sends until the duration ends
+ * @param[in] duration send time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a unicast ipv4 destination is needed for the arp wait
+ */
+static uint8_t a_telemetry_start(const char *ip, uint16_t size, uint32_t count, uint32_t duration)
+{
+    ip_addr_t dst;
+    char output[32];
+    err_t err;
+    
+    if (ip[0] == 0)
+    {
+        ip_addr_copy_from_ip4(dst, *netif_ip4_gw(netif_get_handle()));
+    }
+    else if (ipaddr_aton(ip, &dst) == 0)
+    {
+        return 5;
+    }
+    gs_telemetry_done = 0;
+    err = app_telemetry_start(&dst, size, count, duration * 1000U, a_telemetry_report, NULL);
+    if (err == ERR_VAL)
+    {
+        return 5;
+    }
+    else if (err == ERR_CONN)
+    {
+        lan8720_interface_debug_print("lan8720: telemetry has no address.\n");
+        
+        return 1;
+    }
+    else if (err != ERR_OK)
+    {
+        lan8720_interface_debug_print("lan8720: telemetry udp_new failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        ipaddr_ntoa_r(&dst, output, 32);
+        lan8720_interface_debug_print("lan8720: telemetry sends %u byte blocks to %s:%u.\n",
+                                      (unsigned int)size, output, (unsigned int)APP_TELEMETRY_PORT);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief print the capture state
+ * @note  none
+ */
+static void a_capture_print(void)
+{
+    const char *state[] = {"idle", "armed", "triggered", "done"};
+    app_capture_stats_t stats;
+    
+    app_capture_get_stats(&stats);
+    lan8720_interface_debug_print("lan8720: capture %s frames %u overwritten %u ring %u frames %u bytes pre %u post %u trigger %s.\n",
+                                  state[stats.state], (unsigned int)stats.frames, (unsigned int)stats.overwritten,
+                                  (unsigned int)stats.ring_frames, (unsigned int)stats.ring_bytes,
+                                  (unsigned int)stats.pre, (unsigned int)stats.post,
+                                  (stats.reason == APP_CAPTURE_TRIGGER_LINK_DOWN) ? "link" :
+                                  (stats.reason == APP_CAPTURE_TRIGGER_CRC) ? "crc" :
+                                  (stats.reason == APP_CAPTURE_TRIGGER_MANUAL) ? "manual" : "none");
+}
+
+/**
+ * @brief     write the capture ring to a pcap file
+ * @param[in] *path pointer to a file name
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the capture is stopped first
+ */
+static uint8_t a_capture_write(const char *path)
+{
+    uint8_t buf[512];
+    uint32_t size;
+    uint32_t len;
+    FILE *fp;
+    
+    size = app_capture_open();
+    a_capture_print();
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    while ((len = app_capture_read(buf, 512)) != 0)
+    {
+        if (fwrite(buf, 1, len, fp) != len)
+        {
+            (void)fclose(fp);
+            
+            return 1;
+        }
+    }
+    if (fclose(fp) != 0)
+    {
+        return 1;
+    }
+    lan8720_interface_debug_print("lan8720: capture wrote %u bytes to %s.\n", (unsigned int)size, path);
+    
+    return 0;
+}
+
+/**
+ * @brief     run the network
+ * @param[in] ms run time
+ * @param[in] *name pointer to a domain resolved once the address is bound, NULL for none
+ * @param[in] perf 0 runs no perf test, 1 a server and 2 a client started once the address is bound
+ * @param[in] *ip pointer to the server address of a client
+ * @param[in] duration client send time in seconds
+ * @param[in] *pktgen pointer to a pktgen run started once the link is up, NULL for none
+ * @param[in] *telemetry pointer to the size and count of a telemetry stream started once the address is bound,
+ *                       NULL for none
+ * @note      eth_poll takes the place of the eth interrupt and vmac_wait the place of wfi, the run ends early
+ *            with the dns answer, the first perf report, the pktgen report or the telemetry report
+ */
+static void a_net_run(uint32_t ms, const char *name, uint8_t perf, const char *ip, uint32_t duration,
+                      const app_pktgen_config_t *pktgen, const app_pktgen_config_t *telemetry)
+{
+    ip_addr_t ip_addr;
+    uint32_t end;
+    uint32_t start;
+    uint32_t sleep;
+    uint32_t eth_sleep;
+    uint32_t late;
+    uint8_t asked = 0;
+    err_t err;
+    
+    gs_dns_done = 0;
+    gs_perf_done = 0;
+    gs_pktgen_done = 0;
+    gs_telemetry_done = 0;
+    if (perf == 1)
+    {
+        (void)a_perf_start(0, ip, duration);
+    }
+    end = HAL_GetTick() + ms;
+    while ((int32_t)(HAL_GetTick() - end) < 0)
+    {
+        (void)eth_poll();
+        lwip_server();
+        app_pktgen_poll();
+        app_telemetry_poll();
+        app_capture_poll();
+        gs_loop_wakeups++;
+        
+        /* run dns, a cached name is answered at once */
+        if ((name != NULL) && (asked == 0) && (dhcp_supplied_address(netif_get_handle()) != 0))
+        {
+            asked = 1;
+            err = app_dns_resolve(name, &ip_addr, a_dns_found, NULL);
+            if (err == ERR_OK)
+            {
+                a_dns_found(name, &ip_addr, NULL);
+            }
+            else if (err != ERR_INPROGRESS)
+            {
+                lan8720_interface_debug_print("dns error.\n");
+                gs_dns_done = 1;
+            }
+        }
+        
+        /* the client waits for the address as the shell user does */
+        if ((perf == 2) && (asked == 0) && (dhcp_supplied_address(netif_get_handle()) != 0))
+        {
+            asked = 1;
+            if (a_perf_start(1, ip, duration) != 0)
+            {
+                break;
+            }
+        }
+        
+        /* a loopback run needs no link, the udp mode needs the address */
+        if ((pktgen != NULL) && (asked == 0) &&
+            ((pktgen->udp != 0) ? (dhcp_supplied_address(netif_get_handle()) != 0) :
+             ((pktgen->loopback != 0) || netif_is_link_up(netif_get_handle()))))
+        {
+            asked = 1;
+            if (a_pktgen_start(pktgen) != 0)
+            {
+                break;
+            }
+        }
+        /* the telemetry stream needs the address */
+        if ((telemetry != NULL) && (asked == 0) && (dhcp_supplied_address(netif_get_handle()) != 0))
+        {
+            asked = 1;
+            if (a_telemetry_start(ip, telemetry->size, telemetry->count, duration) != 0)
+            {
+                break;
+            }
+        }
+        if ((gs_dns_done != 0) || (gs_perf_done != 0) || (gs_pktgen_done != 0) || (gs_telemetry_done != 0))
+        {
+            break;
+        }
+        
+        /* sleep until the next lwip or wire deadline, a received frame wakes up early */
+        start = HAL_GetTick();
+        sleep = lwip_server_sleeptime();
+        eth_sleep = eth_get_sleeptime();
+        if (eth_sleep < sleep)
+        {
+            sleep = eth_sleep;
+        }
+        eth_sleep = app_pktgen_sleeptime();
+        if (eth_sleep < sleep)
+        {
+            sleep = eth_sleep;
+        }
+        eth_sleep = app_telemetry_sleeptime();
+        if (eth_sleep < sleep)
+        {
+            sleep = eth_sleep;
+        }
+        eth_sleep = app_capture_sleeptime();
+        if (eth_sleep < sleep)
+        {
+            sleep = eth_sleep;
+        }
+        if ((end - start) < sleep)
+        {
+            sleep = end - start;
+        }
+        if ((ethernetif_pending() == 0) && (sleep != 0))
+        {
+            (void)vmac_wait(sleep);
+        }
+        gs_loop_idle_ms += HAL_GetTick() - start;
+        if ((HAL_GetTick() - start) >= sleep)
+        {
+            late = HAL_GetTick() - start - sleep;
+            gs_loop_deadlines++;
+            gs_loop_late_sum += late;
+            if (late > gs_loop_late_max)
+            {
+                gs_loop_late_max = late;
+            }
+        }
+    }
+}
+
+/**
+ * @brief print the interface statistics
+ * @note  none
+ */
+static void a_stats_print(void)
+{
+    const ethernetif_stats_t *stats = ethernetif_get_stats();
+    lwip_server_rate_t rate;
+    app_dns_stats_t dns;
+    lwip_server_arp_stats_t arp;
+    app_pktgen_stats_t pktgen;
+    app_udp_zc_stats_t zc;
+    uint32_t i;
+    
+    /* print the interface statistics */
+    lan8720_interface_debug_print("lan8720: rx frames %u bytes %u copybreak %u.\n",
+                                  (unsigned int)stats->rx_frames, (unsigned int)stats->rx_bytes,
+                                  (unsigned int)stats->rx_copybreak);
+    lan8720_interface_debug_print("lan8720: rx fast path frames %u bytes %u passed %u.\n",
+                                  (unsigned int)stats->rx_fastpath, (unsigned int)stats->rx_fastpath_bytes,
+                                  (unsigned int)stats->rx_fastpath_pass);
+    lan8720_interface_debug_print("lan8720: rx drop no buffer %u overflow %u stack %u.\n",
+                                  (unsigned int)stats->rx_drop_no_buffer, (unsigned int)stats->rx_drop_overflow,
+                                  (unsigned int)stats->rx_drop_stack);
+    lan8720_interface_debug_print("lan8720: rx pool in use %u max %u low %u empty %u refill %u stall %u.\n",
+                                  (unsigned int)stats->rx_pool_in_use, (unsigned int)stats->rx_pool_max,
+                                  (unsigned int)stats->rx_pool_low, (unsigned int)stats->rx_pool_empty,
+                                  (unsigned int)stats->rx_refill, (unsigned int)stats->rx_stall);
+    lan8720_interface_debug_print("lan8720: rx irq %u poll %u exhausted %u ring empty %u.\n",
+                                  (unsigned int)stats->rx_irq, (unsigned int)stats->rx_poll,
+                                  (unsigned int)stats->rx_poll_exhausted, (unsigned int)stats->rx_ring_empty);
+    lan8720_interface_debug_print("lan8720: tx frames %u bytes %u errors %u zero copy %u linearized %u.\n",
+                                  (unsigned int)stats->tx_frames, (unsigned int)stats->tx_bytes,
+                                  (unsigned int)stats->tx_errors, (unsigned int)stats->tx_zero_copy,
+                                  (unsigned int)stats->tx_linearized);
+    lan8720_interface_debug_print("lan8720: tx ring in use %u max %u full %u bounce busy %u.\n",
+                                  (unsigned int)stats->tx_ring_in_use, (unsigned int)stats->tx_ring_max,
+                                  (unsigned int)stats->tx_ring_full, (unsigned int)stats->tx_bounce_busy);
+    lan8720_interface_debug_print("lan8720: tx queue depth %u max %u queued %u full %u.\n",
+                                  (unsigned int)stats->tx_queue_depth, (unsigned int)stats->tx_queue_max,
+                                  (unsigned int)stats->tx_queued, (unsigned int)stats->tx_queue_full);
+    for (i = 0; i < ETH_TX_PRIO_CNT; i++)
+    {
+        lan8720_interface_debug_print("lan8720: tx prio %u frames %u depth %u max %u queued %u full %u wait avg %u max %u us.\n",
+                                      (unsigned int)i, (unsigned int)stats->tx_prio[i].frames,
+                                      (unsigned int)stats->tx_prio[i].depth, (unsigned int)stats->tx_prio[i].depth_max,
+                                      (unsigned int)stats->tx_prio[i].queued, (unsigned int)stats->tx_prio[i].full,
+                                      (unsigned int)((stats->tx_prio[i].queued != 0) ?
+                                                     (stats->tx_prio[i].wait_sum_us / stats->tx_prio[i].queued) : 0),
+                                      (unsigned int)stats->tx_prio[i].wait_max_us);
+    }
+    lan8720_interface_debug_print("lan8720: tx bulk ring bytes %u held %u.\n",
+                                  (unsigned int)stats->tx_bulk_ring_bytes, (unsigned int)stats->tx_bulk_held);
+    lan8720_interface_debug_print("lan8720: mmc tx good %u collisions %u rx good unicast %u crc %u alignment %u.\n",
+                                  (unsigned int)stats->mmc_tx_good, (unsigned int)stats->mmc_tx_collisions,
+                                  (unsigned int)stats->mmc_rx_good_unicast, (unsigned int)stats->mmc_rx_crc_errors,
+                                  (unsigned int)stats->mmc_rx_alignment_errors);
+    lan8720_interface_debug_print("lan8720: phy symbol errors %u link up %u down %u.\n",
+                                  (unsigned int)stats->phy_symbol_errors, (unsigned int)stats->link_up,
+                                  (unsigned int)stats->link_down);
+    lan8720_interface_debug_print("lan8720: link outage %u ms traffic %u ms flap penalty %u held %u suppressed %u.\n",
+                                  (unsigned int)stats->link_outage_ms, (unsigned int)stats->link_traffic_ms,
+                                  (unsigned int)stats->flap_penalty, (unsigned int)stats->flap_held,
+                                  (unsigned int)stats->flap_suppressed);
+    lan8720_interface_debug_print("lan8720: pause tx %u rx %u frames %u resume %u.\n",
+                                  (unsigned int)stats->pause_tx_enabled, (unsigned int)stats->pause_rx_enabled,
+                                  (unsigned int)stats->pause_frames, (unsigned int)stats->pause_resume_frames);
+    lan8720_interface_debug_print("lan8720: duplex half %u parallel %u fault %u collisions %u errors %u mismatch %u/%u forced %u.\n",
+                                  (unsigned int)stats->duplex_half, (unsigned int)stats->duplex_parallel_detect,
+                                  (unsigned int)stats->duplex_pd_fault, (unsigned int)stats->duplex_collisions,
+                                  (unsigned int)stats->duplex_rx_errors, (unsigned int)stats->duplex_mismatch,
+                                  (unsigned int)stats->duplex_mismatch_events, (unsigned int)stats->duplex_forced);
+    lan8720_interface_debug_print("lan8720: multicast groups %u overflow %u errors %u.\n",
+                                  (unsigned int)stats->mcast_groups, (unsigned int)stats->mcast_overflow,
+                                  (unsigned int)stats->mcast_filter_errors);
+    lwip_server_get_arp_stats(&arp);
+    lan8720_interface_debug_print("lan8720: arp announces %u prewarms %u gateway %u ms timeouts %u.\n",
+                                  (unsigned int)arp.announces, (unsigned int)arp.prewarms,
+                                  (unsigned int)arp.gateway_ms, (unsigned int)arp.gateway_timeouts);
+    app_dns_get_stats(&dns);
+    lan8720_interface_debug_print("lan8720: dns lookups %u hits %u misses %u prefetches %u failures %u evictions %u latency avg %u max %u ms.\n",
+                                  (unsigned int)dns.lookups, (unsigned int)dns.hits, (unsigned int)dns.misses,
+                                  (unsigned int)dns.prefetches, (unsigned int)dns.failures, (unsigned int)dns.evictions,
+                                  (unsigned int)((dns.answers != 0) ? (dns.latency_sum / dns.answers) : 0),
+                                  (unsigned int)dns.latency_max);
+    lwip_server_get_rate(&rate);
+    lan8720_interface_debug_print("lan8720: rate rx %u fps %u Bps tx %u fps %u Bps.\n",
+                                  (unsigned int)rate.rx_frames, (unsigned int)rate.rx_bytes,
+                                  (unsigned int)rate.tx_frames, (unsigned int)rate.tx_bytes);
+    app_pktgen_get_stats(&pktgen);
+    a_pktgen_print(&pktgen);
+    app_udp_zc_get_stats(&zc);
+    lan8720_interface_debug_print("lan8720: udp zc sent %u bytes %u busy %u errors %u in flight %u max %u release avg %u max %u us.\n",
+                                  (unsigned int)zc.sent, (unsigned int)zc.bytes, (unsigned int)zc.busy,
+                                  (unsigned int)zc.errors, (unsigned int)zc.in_flight, (unsigned int)zc.in_flight_max,
+                                  (unsigned int)((zc.release_cnt != 0) ? (zc.release_sum_us / zc.release_cnt) : 0),
+                                  (unsigned int)zc.release_max_us);
+    a_capture_print();
+    lan8720_interface_debug_print("lan8720: loop wakeups %u idle %u/%u ms deadline late avg %u max %u ms.\n",
+                                  (unsigned int)gs_loop_wakeups, (unsigned int)gs_loop_idle_ms,
+                                  (unsigned int)(HAL_GetTick() - gs_loop_start),
+                                  (unsigned int)((gs_loop_deadlines != 0) ? (gs_loop_late_sum / gs_loop_deadlines) : 0),
+                                  (unsigned int)gs_loop_late_max);
+}
+
+/**
+ * @brief print the trace probes
+ * @note  none
+ */
+static void a_trace_print(void)
+{
+#if TRACE_ENABLE
+    trace_stat_t stat;
+    uint32_t probe;
+
+    /* print the trace probes */
+    lan8720_interface_debug_print("lan8720: trace unit is %s, probe overhead is %u.\n",
+                                  trace_get_unit(), (unsigned int)trace_get_overhead());
+    for (probe = 0; probe < TRACE_PROBE_MAX; probe++)
+    {
+        (void)trace_get((trace_probe_t)probe, &stat);
+        lan8720_interface_debug_print("lan8720: %s count %u min %u avg %u max %u.\n",
+                                      trace_get_name((trace_probe_t)probe), (unsigned int)stat.count,
+                                      (unsigned int)stat.min,
+                                      (unsigned int)((stat.count != 0) ? (stat.sum / stat.count) : 0),
+                                      (unsigned int)stat.max);
+    }
+#else
+    lan8720_interface_debug_print("lan8720: trace is disabled, build with TRACE_ENABLE 1.\n");
+#endif
+}
+
+/**
+ * @brief     lan8720 full function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ *            - 5 param is invalid
+ * @note      none
+ */
+uint8_t lan8720(uint8_t argc, char **argv)
+{
+    int c;
+    int longindex = 0;
+    char short_options[] = "hipe:t:";
+    struct option long_options[] =
+    {
+        {"help", no_argument, NULL, 'h'},
+        {"information", no_argument, NULL, 'i'},
+        {"port", no_argument, NULL, 'p'},
+        {"example", required_argument, NULL, 'e'},
+        {"test", required_argument, NULL, 't'},
+        {"addr", required_argument, NULL, 1},
+        {"name", required_argument, NULL, 2},
+        {"operate", required_argument, NULL, 3},
+        {"stats", no_argument, NULL, 4},
+        {"trace", no_argument, NULL, 5},
+        {"mode", required_argument, NULL, 6},
+        {"ip", required_argument, NULL, 7},
+        {"duration", required_argument, NULL, 8},
+        {"size", required_argument, NULL, 9},
+        {"rate", required_argument, NULL, 10},
+        {"burst", required_argument, NULL, 11},
+        {"count", required_argument, NULL, 12},
+        {"dst", required_argument, NULL, 13},
+        {"loopback", no_argument, NULL, 14},
+        {"udp", no_argument, NULL, 15},
+        {"vmac", required_argument, NULL, 16},
+        {"pcap", required_argument, NULL, 17},
+        {"dump", required_argument, NULL, 18},
+        {"time", required_argument, NULL, 19},
+        {"flap", required_argument, NULL, 20},
+        {"lease", required_argument, NULL, 21},
+        {"wire", required_argument, NULL, 22},
+        {"capture", required_argument, NULL, 23},
+        {"snaplen", required_argument, NULL, 24},
+        {"pre", required_argument, NULL, 25},
+        {"post", required_argument, NULL, 26},
+        {"event", required_argument, NULL, 27},
+        {NULL, 0, NULL, 0},
+    };
+    char type[33] = "unknown";
+    char name[33] = "www.bing.com";
+    uint8_t addr = 0x01;
+    uint8_t operate = 0xFF;
+    char ip[17] = {0};
+    uint8_t client = 0;
+    uint32_t duration = 10;
+    app_pktgen_config_t pktgen = {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 64, 0, 1, 0, 0, 0, 0, 0};
+    uint8_t dst = 0;
+    app_capture_config_t capture = {APP_CAPTURE_SNAPLEN, 0, 0, 0};
+    uint8_t stats = 0;
+    uint8_t trace = 0;
+    uint8_t vmac = 0;
+    uint8_t pacing = 1;
+    char *pcap = NULL;
+    char *dump = NULL;
+    char *capture_file = NULL;
+    uint32_t time = 0;
+    unsigned int up_ms = 0;
+    unsigned int down_ms = 0;
+    
+    /* if no params */
+    if (argc == 1)
+    {
+        /* goto the help */
+        goto help;
+    }
+    
+    /* init 0 */
+    optind = 0;
+    
+    /* parse */
+    do
+    {
+        /* parse the args */
+        c = getopt_long(argc, argv, short_options, long_options, &longindex);
+        
+        /* judge the result */
+        switch (c)
+        {
+            /* help */
+            case 'h' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "h");
+                
+                break;
+            }
+            
+            /* information */
+            case 'i' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "i");
+                
+                break;
+            }
+            
+            /* port */
+            case 'p' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "p");
+                
+                break;
+            }
+            
+            /* example */
+            case 'e' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "e_%s", optarg);
+                
+                break;
+            }
+            
+            /* test */
+            case 't' :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                snprintf(type, 32, "t_%s", optarg);
+                
+                break;
+            }
+            
+            /* addr */
+            case 1 :
+            {
+                /* set the addr pin */
+                addr = atoi(optarg);
+                
+                break;
+            }
+            
+            /* name */
+            case 2 :
+            {
+                /* set the name */
+                memset(name, 0, sizeof(char) * 33);
+                snprintf(name, 32, "%s", optarg);
+                
+                break;
+            }
+            
+            /* operate */
+            case 3 :
+            {
+                if (strcmp(optarg, "init") == 0)
+                {
+                    operate = 0;
+                }
+                else if (strcmp(optarg, "dns") == 0)
+                {
+                    operate = 1;
+                }
+                else if (strcmp(optarg, "perf") == 0)
+                {
+                    operate = 2;
+                }
+                else if (strcmp(optarg, "pktgen") == 0)
+                {
+                    operate = 3;
+                }
+                else if (strcmp(optarg, "telemetry") == 0)
+                {
+                    operate = 4;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* stats */
+            case 4 :
+            {
+                /* print the statistics at the end of the run */
+                stats = 1;
+                
+                break;
+            }
+            
+            /* trace */
+            case 5 :
+            {
+                /* print the trace probes at the end of the run */
+                trace = 1;
+                
+                break;
+            }
+            
+            /* mode */
+            case 6 :
+            {
+                if (strcmp(optarg, "server") == 0)
+                {
+                    client = 0;
+                }
+                else if (strcmp(optarg, "client") == 0)
+                {
+                    client = 1;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* ip */
+            case 7 :
+            {
+                /* set the perf server address */
+                memset(ip, 0, sizeof(char) * 17);
+                snprintf(ip, 16, "%s", optarg);
+                
+                break;
+            }
+            
+            /* duration */
+            case 8 :
+            {
+                /* set the perf client or the pktgen time */
+                duration = atoi(optarg);
+                
+                break;
+            }
+            
+            /* size */
+            case 9 :
+            {
+                /* set the pktgen frame size */
+                pktgen.size = (uint16_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* rate */
+            case 10 :
+            {
+                /* set the pktgen frames per second */
+                pktgen.rate = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* burst */
+            case 11 :
+            {
+                /* set the pktgen frames sent back to back */
+                pktgen.burst = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* count */
+            case 12 :
+            {
+                /* set the pktgen frames to send */
+                pktgen.count = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* dst */
+            case 13 :
+            {
+                /* set the pktgen destination */
+                if (a_mac_parse(optarg, pktgen.dst) != 0)
+                {
+                    return 5;
+                }
+                dst = 1;
+                
+                break;
+            }
+            
+            /* loopback */
+            case 14 :
+            {
+                /* send over the phy near end loopback */
+                pktgen.loopback = 1;
+                
+                break;
+            }
+                
+            /* udp */
+            case 15 :
+            {
+                /* send udp datagrams to the stack receiver */
+                pktgen.udp = 1;
+                
+                break;
+            }
+            
+            /* vmac */
+            case 16 :
+            {
+                if (strcmp(optarg, "pair") == 0)
+                {
+                    vmac = 0;
+                }
+                else if (strcmp(optarg, "pcap") == 0)
+                {
+                    vmac = 1;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* pcap */
+            case 17 :
+            {
+                /* set the replayed file */
+                pcap = optarg;
+                
+                break;
+            }
+            
+            /* dump */
+            case 18 :
+            {
+                /* set the dump file */
+                dump = optarg;
+                
+                break;
+            }
+            
+            /* time */
+            case 19 :
+            {
+                /* set the run time */
+                time = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* flap */
+            case 20 :
+            {
+                if (sscanf(optarg, "%u,%u", &up_ms, &down_ms) != 2)
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* lease */
+            case 21 :
+            {
+                /* set the lease file */
+                gs_lease_path = optarg;
+                
+                break;
+            }
+            
+            /* wire */
+            case 22 :
+            {
+                if (strcmp(optarg, "paced") == 0)
+                {
+                    pacing = 1;
+                }
+                else if (strcmp(optarg, "free") == 0)
+                {
+                    pacing = 0;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* capture */
+            case 23 :
+            {
+                /* set the capture file */
+                capture_file = optarg;
+                
+                break;
+            }
+            
+            /* snaplen */
+            case 24 :
+            {
+                /* set the capture bytes kept of a frame */
+                capture.snaplen = (uint16_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* pre */
+            case 25 :
+            {
+                /* set the capture frames kept before the trigger */
+                capture.pre = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* post */
+            case 26 :
+            {
+                /* set the capture frames recorded after the trigger */
+                capture.post = (uint32_t)atoi(optarg);
+                
+                break;
+            }
+            
+            /* event */
+            case 27 :
+            {
+                /* set the capture trigger */
+                if (strcmp(optarg, "none") == 0)
+                {
+                    capture.trigger = 0;
+                }
+                else if (strcmp(optarg, "link") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_LINK_DOWN;
+                }
+                else if (strcmp(optarg, "crc") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_CRC;
+                }
+                else if (strcmp(optarg, "all") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_LINK_DOWN | APP_CAPTURE_TRIGGER_CRC;
+                }
+                else
+                {
+                    return 5;
+                }
+                
+                break;
+            }
+            
+            /* the end */
+            case -1 :
+            {
+                break;
+            }
+            
+            /* others */
+            default :
+            {
+                return 5;
+            }
+        }
+    } while (c != -1);
+    
+    /* run the function */
+    if (strcmp("t_reg", type) == 0)
+    {
+        /* run the reg test */
+        if (lan8720_register_test(addr) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_wheel", type) == 0)
+    {
+        /* run the timer wheel test */
+        if (timer_wheel_test() != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("t_rx", type) == 0)
+    {
+        /* run the rx chain benchmark */
+        if (rx_chain_bench((pktgen.count != 0) ? pktgen.count : 1000000U) != 0)
+        {
+            return 1;
+        }
+        
+        return 0;
+    }
+    else if (strcmp("e_net", type) == 0)
+    {
+        if (operate > 4)
+        {
+            lan8720_interface_debug_print("operate is invalid:\n");
+            
+            return 5;
+        }
+        
+        /* the peer process is forked before lwip_init, it runs the client of a perf server */
+        if (vmac == 0)
+        {
+            peer_set_perf_client(((operate == 2) && (client == 0)) ? (duration * 1000U) : 0);
+            if (vmac_open_pair(peer_run) != 0)
+            {
+                lan8720_interface_debug_print("lan8720: open pair failed.\n");
+                
+                return 1;
+            }
+        }
+        else
+        {
+            if ((pcap == NULL) || (vmac_open_pcap(pcap) != 0))
+            {
+                lan8720_interface_debug_print("lan8720: open pcap failed.\n");
+                
+                return 1;
+            }
+        }
+        if ((dump != NULL) && (vmac_open_dump(dump) != 0))
+        {
+            lan8720_interface_debug_print("lan8720: open dump failed.\n");
+            vmac_close();
+            
+            return 1;
+        }
+        (void)vphy_set_flap(up_ms, down_ms);
+        (void)eth_set_pacing(pacing);
+        
+        /* keep the dhcp lease in the lease file */
+        if (gs_lease_path != NULL)
+        {
+            lwip_server_set_lease_storage(a_lease_load, a_lease_save, a_lease_clock);
+        }
+        
+        /* initialize the lwip stack */
+        eth_set_address(addr);
+        lwip_init();
+        netif_config();
+        app_dns_init();
+        app_pktgen_init();
+        app_udp_zc_init();
+        app_capture_init();
+        
+        /* the ring records from the start and is written to the file after the run */
+        if ((capture_file != NULL) && (app_capture_arm(&capture) != ERR_OK))
+        {
+            vmac_close();
+            
+            return 5;
+        }
+        
+        lan8720_interface_debug_print("start dhcp.\n");
+        gs_loop_start = HAL_GetTick();
+        if (time == 0)
+        {
+            /* the default run covers the dhcp and a whole perf, pktgen or telemetry test */
+            time = (operate >= 2) ? (duration + 10U) : 10U;
+        }
+        
+        /* a loopback run sends to itself unless told otherwise */
+        if ((pktgen.loopback != 0) && (dst == 0))
+        {
+            memcpy(pktgen.dst, netif_get_handle()->hwaddr, 6);
+        }
+        pktgen.duration_ms = duration * 1000U;
+        if ((operate == 3) && (ip[0] != 0))
+        {
+            ip4_addr_t ip4;
+            
+            /* the udp destination, the own address by default */
+            if (ip4addr_aton(ip, &ip4) == 0)
+            {
+                return 5;
+            }
+            pktgen.ip = ip4_addr_get_u32(&ip4);
+        }
+        a_net_run(time * 1000U, (operate == 1) ? name : NULL, (operate == 2) ? (client + 1) : 0, ip, duration,
+                  (operate == 3) ? &pktgen : NULL, (operate == 4) ? &pktgen : NULL);
+        if ((capture_file != NULL) && (a_capture_write(capture_file) != 0))
+        {
+            lan8720_interface_debug_print("lan8720: write capture failed.\n");
+        }
+        if (stats != 0)
+        {
+            a_stats_print();
+        }
+        if (trace != 0)
+        {
+            a_trace_print();
+        }
+        vmac_close();
+        
+        return 0;
+    }
+    else if (strcmp("h", type) == 0)
+    {
+        help:
+        lan8720_interface_debug_print("Usage:\n");
+        lan8720_interface_debug_print("  lan8720 (-i | --information)\n");
+        lan8720_interface_debug_print("  lan8720 (-h | --help)\n");
+        lan8720_interface_debug_print("  lan8720 (-p | --port)\n");
+        lan8720_interface_debug_print("  lan8720 (-t reg | --test=reg) [--addr=<num>]\n");
+        lan8720_interface_debug_print("  lan8720 (-t rx | --test=rx) [--count=<num>]\n");
+        lan8720_interface_debug_print("  lan8720 (-t wheel | --test=wheel)\n");
+        lan8720_interface_debug_print("  lan8720 (-e net | --example=net) (--operate=<init | dns | perf | pktgen | telemetry>) [--addr=<num>] [--name=<domain>]\n");
+        lan8720_interface_debug_print("          [--mode=<server | client>] [--ip=<address>] [--duration=<s>]\n");
+        lan8720_interface_debug_print("          [--size=<64 - 1518>] [--rate=<pps>] [--burst=<num>] [--count=<num>] [--dst=<mac>] [--loopback] [--udp]\n");
+        lan8720_interface_debug_print("          [--vmac=<pair | pcap>] [--pcap=<file>] [--dump=<file>] [--time=<s>]\n");
+        lan8720_interface_debug_print("          [--flap=<up,down>] [--lease=<file>] [--wire=<paced | free>] [--stats] [--trace]\n");
+        lan8720_interface_debug_print("          [--capture=<file> [--snaplen=<14 - 1514>] [--pre=<num>] [--post=<num>] [--event=<none | link | crc | all>]]\n");
+        lan8720_interface_debug_print("\n");
+        lan8720_interface_debug_print("Options:\n");
+        lan8720_interface_debug_print("      --addr=<num>                  Set the chip address number.([default: 1])\n");
+        lan8720_interface_debug_print("      --burst=<num>                 Set the pktgen frames sent back to back at the rate.([default: 1])\n");
+        lan8720_interface_debug_print("      --capture=<file>              Record the frames in the capture ring and write it to a pcap file after the run.\n");
+        lan8720_interface_debug_print("      --count=<num>                 Set the pktgen frames or telemetry blocks to send, 0 sends until the duration ends.([default: 0])\n");
+        lan8720_interface_debug_print("                                    Set the frames per segment count of the rx benchmark.([default: 1000000])\n");
+        lan8720_interface_debug_print("      --dst=<mac>                   Set the pktgen destination.([default: ff:ff:ff:ff:ff:ff, the own address with --loopback])\n");
+        lan8720_interface_debug_print("      --dump=<file>                 Dump the wire to a pcap file.\n");
+        lan8720_interface_debug_print("      --duration=<s>                Set the perf client, pktgen or telemetry send time.([default: 10])\n");
+        lan8720_interface_debug_print("  -e <net>, --example=<net>         Run the driver example.\n");
+        lan8720_interface_debug_print("      --event=<none | link | crc | all>\n");
+        lan8720_interface_debug_print("                                    Set the capture trigger.([default: none])\n");
+        lan8720_interface_debug_print("      --flap=<up,down>              Flap the cable, up and down are in ms.\n");
+        lan8720_interface_debug_print("  -h, --help                        Show the help.\n");
+        lan8720_interface_debug_print("  -i, --information                 Show the chip information.\n");
+        lan8720_interface_debug_print("      --ip=<address>                Set the perf server address of the client or the pktgen or telemetry udp destination.\n");
+        lan8720_interface_debug_print("                                    ([default: the gateway, the own address for pktgen])\n");
+        lan8720_interface_debug_print("      --lease=<file>                Keep the dhcp lease in a file for the init-reboot.\n");
+        lan8720_interface_debug_print("      --loopback                    Send the pktgen frames over the phy near end loopback.\n");
+        lan8720_interface_debug_print("      --mode=<server | client>      Set the perf mode.([default: server])\n");
+        lan8720_interface_debug_print("      --name=<domain>               Set domain name.([default: www.bing.com])\n");
+        lan8720_interface_debug_print("      --operate=<init | dns | perf | pktgen | telemetry>\n");
+        lan8720_interface_debug_print("                                    Set operate, init is init the net, dns is running the dns, perf is running lwiperf\n");
+        lan8720_interface_debug_print("                                    pktgen is running the raw frame generator and telemetry is streaming udp blocks\n");
+        lan8720_interface_debug_print("                                    without a copy.\n");
+        lan8720_interface_debug_print("  -p, --port                        Display the pins used by this device to connect the chip.\n");
+        lan8720_interface_debug_print("      --pcap=<file>                 Set the pcap file replayed by --vmac=pcap.\n");
+        lan8720_interface_debug_print("      --post=<num>                  Set the capture frames recorded after the trigger.([default: 0])\n");
+        lan8720_interface_debug_print("      --pre=<num>                   Set the capture frames kept before the trigger, 0 keeps the whole ring.([default: 0])\n");
+        lan8720_interface_debug_print("      --rate=<pps>                  Set the pktgen frames per second, 0 sends at the line rate.([default: 0])\n");
+        lan8720_interface_debug_print("      --size=<64 - 1518>            Set the pktgen frame size with the fcs.([default: 64])\n");
+        lan8720_interface_debug_print("                                    The telemetry block size is 8 - 1472.\n");
+        lan8720_interface_debug_print("      --snaplen=<14 - 1514>         Set the capture bytes kept of a frame.([default: 128])\n");
+        lan8720_interface_debug_print("      --stats                       Show the interface statistics at the end of the run.\n");
+        lan8720_interface_debug_print("      --time=<s>                    Set the run time.([default: 10, perf, pktgen and telemetry duration + 10])\n");
+        lan8720_interface_debug_print("      --trace                       Show the hot path trace probes at the end of the run.\n");
+        lan8720_interface_debug_print("  -t <reg | rx | wheel>, --test=<reg | rx | wheel>\n");
+        lan8720_interface_debug_print("                                    Run the driver test, the rx chain benchmark or the timer wheel test.\n");
+        lan8720_interface_debug_print("      --udp                         Send the pktgen frames as udp datagrams through the lwip receiver.\n");
+        lan8720_interface_debug_print("      --vmac=<pair | pcap>          Set the wire, pair is a peer lwip and pcap replays a file.([default: pair])\n");
+        lan8720_interface_debug_print("      --wire=<paced | free>         Send the frames at the link speed or at once.([default: paced])\n");
+        
+        return 0;
+    }
+    else if (strcmp("i", type) == 0)
+    {
+        lan8720_info_t info;
+
+        /* print lan8720 info */
+        lan8720_info(&info);
+        lan8720_interface_debug_print("lan8720: chip is %s.\n", info.chip_name);
+        lan8720_interface_debug_print("lan8720: manufacturer is %s.\n", info.manufacturer_name);
+        lan8720_interface_debug_print("lan8720: interface is %s.\n", info.interface);
+        lan8720_interface_debug_print("lan8720: driver version is %d.%d.\n", info.driver_version / 1000, (info.driver_version % 1000) / 100);
+        lan8720_interface_debug_print("lan8720: min supply voltage is %0.1fV.\n", info.supply_voltage_min_v);
+        lan8720_interface_debug_print("lan8720: max supply voltage is %0.1fV.\n", info.supply_voltage_max_v);
+        lan8720_interface_debug_print("lan8720: max current is %0.2fmA.\n", info.max_current_ma);
+        lan8720_interface_debug_print("lan8720: max temperature is %0.1fC.\n", info.temperature_max);
+        lan8720_interface_debug_print("lan8720: min temperature is %0.1fC.\n", info.temperature_min);
+
+        return 0;
+    }
+    else if (strcmp("p", type) == 0)
+    {
+        /* print the virtual connection */
+        lan8720_interface_debug_print("lan8720: SMI connected to the virtual phy at address %d.\n", VPHY_ADDR);
+        lan8720_interface_debug_print("lan8720: RESET connected to the virtual phy reset.\n");
+        lan8720_interface_debug_print("lan8720: RMII connected to the virtual mac.\n");
+        
+        return 0;
+    }
+    else
+    {
+        return 5;
+    }
+}
+
+/**
+ * @brief     eth rx complete callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    ethernetif_rx_irq(netif_get_handle());
+}
+
+/**
+ * @brief     eth tx complete callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    ethernetif_tx_irq();
+}
+
+/**
+ * @brief     eth error callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth)
+{
+    ethernetif_error_irq(heth->DMAErrorCode);
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *             - 0 success
+ *             - !0 error
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    uint8_t res;
+    
+    /* delay init */
+    delay_init();
+    
+    /* trace init */
+    trace_init();
+    
+    /* the board has its phy and cable */
+    (void)vphy_init();
+    
+    res = lan8720((uint8_t)argc, argv);
+    if (res == 0)
+    {
+        /* run success */
+    }
+    else if (res == 1)
+    {
+        lan8720_interface_debug_print("lan8720: run failed.\n");
+    }
+    else if (res == 5)
+    {
+        lan8720_interface_debug_print("lan8720: param is invalid.\n");
+    }
+    else
+    {
+        lan8720_interface_debug_print("lan8720: unknown status code.\n");
+    }
+    
+    return res;
+}
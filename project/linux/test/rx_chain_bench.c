@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      rx_chain_bench.c
+ * @brief     rx chain benchmark source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "rx_chain_bench.h"
+#include "ethernetif.h"
+#include "driver_lan8720_interface.h"
+#include <time.h>
+
+/**
+ * @brief rx chain benchmark definition
+ */
+#define RX_CHAIN_BENCH_SEGMENT       8U            /**< max segments of a frame */
+#define RX_CHAIN_BENCH_FRAME         1514U         /**< frame length without the fcs */
+static struct pbuf gs_segment[RX_CHAIN_BENCH_SEGMENT];  /**< segments of the frame */
+
+/**
+ * @brief  rx chain benchmark get the time
+ * @return nanoseconds of CLOCK_MONOTONIC
+ * @note   none
+ */
+static uint64_t a_rx_chain_bench_ns(void)
+{
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief     rx chain benchmark append a buffer with the chain walk
+ * @param[in] **start pointer to the first pbuf of the frame
+ * @param[in] **end pointer to the last pbuf of the frame
+ * @param[in] *p pointer to the pbuf of the received buffer
+ * @param[in] len bytes in the buffer
+ * @note      the stock callback, every append adds its length to each tot_len of the chain
+ */
+static void a_rx_chain_walk_add(struct pbuf **start, struct pbuf **end, struct pbuf *p, uint16_t len)
+{
+    struct pbuf *q;
+    
+    p->next = NULL;
+    p->tot_len = 0;
+    p->len = len;
+    if (*start == NULL)
+    {
+        *start = p;
+    }
+    else
+    {
+        (*end)->next = p;
+    }
+    *end = p;
+    for (q = *start; q != NULL; q = q->next)
+    {
+        q->tot_len += len;
+    }
+}
+
+/**
+ * @brief     rx chain benchmark build a frame
+ * @param[in] segments segments of the frame
+ * @param[in] walk 1 uses the chain walk, 0 the port callback
+ * @return    first pbuf of the frame
+ * @note      the last segment takes the rest of the frame
+ */
+static struct pbuf *a_rx_chain_build(uint32_t segments, uint8_t walk)
+{
+    struct pbuf *start = NULL;
+    struct pbuf *end = NULL;
+    uint16_t len = (uint16_t)(RX_CHAIN_BENCH_FRAME / segments);
+    uint32_t i;
+    
+    for (i = 0; i < segments; i++)
+    {
+        if (i == (segments - 1))
+        {
+            len = (uint16_t)(RX_CHAIN_BENCH_FRAME - len * (segments - 1));
+        }
+        if (walk != 0)
+        {
+            a_rx_chain_walk_add(&start, &end, &gs_segment[i], len);
+        }
+        else
+        {
+            ethernetif_rx_chain_add(&start, &end, &gs_segment[i], len);
+        }
+    }
+    if (walk == 0)
+    {
+        ethernetif_rx_chain_end(start);
+    }
+    
+    return start;
+}
+
+/**
+ * @brief     rx chain benchmark check a frame
+ * @param[in] *p pointer to the first pbuf of the frame
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      every tot_len is its own length plus that of the following segments
+ */
+static uint8_t a_rx_chain_check(const struct pbuf *p)
+{
+    uint32_t rest = RX_CHAIN_BENCH_FRAME;
+    
+    for (; p != NULL; p = p->next)
+    {
+        if (p->tot_len != rest)
+        {
+            return 1;
+        }
+        rest -= p->len;
+    }
+    
+    return (rest == 0) ? 0 : 1;
+}
+
+/**
+ * @brief     rx chain benchmark
+ * @param[in] rounds frames built per segment count
+ * @return    status code
+ *            - 0 success
+ *            - 1 test failed
+ * @note      frames of 1 - 8 segments are built with the callback sequence of the port and with the chain walk of
+ *            the stock callback, both are checked and timed
+ */
+uint8_t rx_chain_bench(uint32_t rounds)
+{
+    volatile uint32_t sink = 0;
+    uint64_t start;
+    uint64_t port_ns;
+    uint64_t walk_ns;
+    uint32_t segments;
+    uint32_t i;
+    
+    lan8720_interface_debug_print("lan8720: rx chain benchmark of %u rounds with %u byte frames.\n",
+                                  (unsigned int)rounds, (unsigned int)RX_CHAIN_BENCH_FRAME);
+    for (segments = 1; segments <= RX_CHAIN_BENCH_SEGMENT; segments++)
+    {
+        /* both builds give the same chain */
+        if ((a_rx_chain_check(a_rx_chain_build(segments, 0)) != 0) ||
+            (a_rx_chain_check(a_rx_chain_build(segments, 1)) != 0))
+        {
+            lan8720_interface_debug_print("lan8720: rx chain of %u segments has a wrong tot_len.\n", (unsigned int)segments);
+            
+            return 1;
+        }
+        
+        start = a_rx_chain_bench_ns();
+        for (i = 0; i < rounds; i++)
+        {
+            sink += a_rx_chain_build(segments, 0)->tot_len;
+        }
+        port_ns = a_rx_chain_bench_ns() - start;
+        start = a_rx_chain_bench_ns();
+        for (i = 0; i < rounds; i++)
+        {
+            sink += a_rx_chain_build(segments, 1)->tot_len;
+        }
+        walk_ns = a_rx_chain_bench_ns() - start;
+        lan8720_interface_debug_print("lan8720: rx chain %u segments port %0.1f ns walk %0.1f ns per frame.\n",
+                                      (unsigned int)segments, (double)port_ns / rounds, (double)walk_ns / rounds);
+    }
+    (void)sink;
+    
+    return 0;
+}
@@ -0,0 +1,273 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      timer_wheel_test.c
+ * @brief     timer wheel test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "timer_wheel_test.h"
+#include "timer_wheel.h"
+#include "driver_lan8720_interface.h"
+#include <string.h>
+
+/**
+ * @brief timer wheel test record structure definition
+ */
+typedef struct timer_wheel_test_record_s
+{
+    timer_wheel_t *wheel;                 /**< wheel of the timer */
+    timer_wheel_timer_t *cancel;          /**< timer removed by the callback */
+    uint32_t fired;                       /**< callback count */
+    uint32_t last;                        /**< wheel tick of the last callback */
+} timer_wheel_test_record_t;
+
+/**
+ * @brief timer wheel test var definition
+ */
+static timer_wheel_t gs_wheel;                          /**< wheel under test */
+static timer_wheel_timer_t gs_timer[8];                 /**< timers */
+static timer_wheel_test_record_t gs_record[8];          /**< records of the timers */
+
+/**
+ * @brief     timer wheel test callback
+ * @param[in] *arg pointer to a record structure
+ * @note      none
+ */
+static void a_timer_wheel_test_callback(void *arg)
+{
+    timer_wheel_test_record_t *record = (timer_wheel_test_record_t *)arg;
+    
+    record->fired++;
+    record->last = record->wheel->now;
+    if (record->cancel != NULL)
+    {
+        timer_wheel_remove(record->wheel, record->cancel);
+    }
+}
+
+/**
+ * @brief     timer wheel test start a case
+ * @param[in] now tick of the wheel
+ * @note      none
+ */
+static void a_timer_wheel_test_reset(uint32_t now)
+{
+    uint32_t i;
+    
+    timer_wheel_init(&gs_wheel, now);
+    memset(gs_timer, 0, sizeof(gs_timer));
+    memset(gs_record, 0, sizeof(gs_record));
+    for (i = 0; i < 8; i++)
+    {
+        gs_record[i].wheel = &gs_wheel;
+    }
+}
+
+/**
+ * @brief     timer wheel test add a timer
+ * @param[in] i timer index
+ * @param[in] delay ticks until the first expiry
+ * @param[in] period reload period
+ * @note      none
+ */
+static void a_timer_wheel_test_add(uint32_t i, uint32_t delay, uint32_t period)
+{
+    timer_wheel_add(&gs_wheel, &gs_timer[i], delay, period, a_timer_wheel_test_callback, &gs_record[i]);
+}
+
+/**
+ * @brief     timer wheel test check a timer
+ * @param[in] i timer index
+ * @param[in] fired expected callback count
+ * @param[in] last expected tick of the last callback
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      none
+ */
+static uint8_t a_timer_wheel_test_check(uint32_t i, uint32_t fired, uint32_t last)
+{
+    if ((gs_record[i].fired != fired) || ((fired != 0) && (gs_record[i].last != last)))
+    {
+        lan8720_interface_debug_print("lan8720: timer %u fired %u times at 0x%08X, expect %u times at 0x%08X.\n",
+                                      (unsigned int)i, (unsigned int)gs_record[i].fired, (unsigned int)gs_record[i].last,
+                                      (unsigned int)fired, (unsigned int)last);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  timer wheel test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   covers the level 0 expiry, the cascade across the level boundaries, the cancel during a cascade
+ *         and the 32 bit tick wrap
+ */
+uint8_t timer_wheel_test(void)
+{
+    uint8_t res = 0;
+    uint32_t t;
+    
+    /* start timer wheel test */
+    lan8720_interface_debug_print("lan8720: start timer wheel test.\n");
+    
+    /* level 0 expiry, the wheel runs tick by tick */
+    lan8720_interface_debug_print("lan8720: timer wheel level 0 expiry test.\n");
+    a_timer_wheel_test_reset(0);
+    a_timer_wheel_test_add(0, 0, 0);
+    a_timer_wheel_test_add(1, 5, 0);
+    a_timer_wheel_test_add(2, 63, 0);
+    a_timer_wheel_test_add(3, 10, 10);
+    if (timer_wheel_sleeptime(&gs_wheel, 0) != 1)
+    {
+        lan8720_interface_debug_print("lan8720: sleeptime is %u, expect 1.\n", (unsigned int)timer_wheel_sleeptime(&gs_wheel, 0));
+        res = 1;
+    }
+    for (t = 1; t <= 62; t++)
+    {
+        timer_wheel_run(&gs_wheel, t);
+    }
+    res |= a_timer_wheel_test_check(0, 1, 1);
+    res |= a_timer_wheel_test_check(1, 1, 5);
+    res |= a_timer_wheel_test_check(2, 0, 0);
+    res |= a_timer_wheel_test_check(3, 6, 60);
+    timer_wheel_run(&gs_wheel, 63);
+    res |= a_timer_wheel_test_check(2, 1, 63);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: timer wheel level 0 expiry test failed.\n");
+        
+        return 1;
+    }
+    
+    /* cascade across the level boundaries, the wheel jumps */
+    lan8720_interface_debug_print("lan8720: timer wheel cascade test.\n");
+    a_timer_wheel_test_reset(0);
+    a_timer_wheel_test_add(0, 64, 0);
+    a_timer_wheel_test_add(1, 100, 0);
+    a_timer_wheel_test_add(2, 4095, 0);
+    a_timer_wheel_test_add(3, 4096, 0);
+    a_timer_wheel_test_add(4, 5000, 0);
+    a_timer_wheel_test_add(5, 300000, 0);
+    timer_wheel_run(&gs_wheel, 4095);
+    res |= a_timer_wheel_test_check(0, 1, 64);
+    res |= a_timer_wheel_test_check(1, 1, 100);
+    res |= a_timer_wheel_test_check(2, 1, 4095);
+    res |= a_timer_wheel_test_check(3, 0, 0);
+    if (timer_wheel_sleeptime(&gs_wheel, 4095) != 1)
+    {
+        lan8720_interface_debug_print("lan8720: sleeptime is %u, expect 1.\n", (unsigned int)timer_wheel_sleeptime(&gs_wheel, 4095));
+        res = 1;
+    }
+    timer_wheel_run(&gs_wheel, 400000);
+    res |= a_timer_wheel_test_check(3, 1, 4096);
+    res |= a_timer_wheel_test_check(4, 1, 5000);
+    res |= a_timer_wheel_test_check(5, 1, 300000);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: timer wheel cascade test failed.\n");
+        
+        return 1;
+    }
+    
+    /* cancel during a cascade, the first timer of the cascaded slot removes the others */
+    lan8720_interface_debug_print("lan8720: timer wheel cancel test.\n");
+    a_timer_wheel_test_reset(0);
+    a_timer_wheel_test_add(0, 64, 0);
+    a_timer_wheel_test_add(1, 64, 0);
+    a_timer_wheel_test_add(2, 100, 0);
+    a_timer_wheel_test_add(3, 5000, 0);
+    a_timer_wheel_test_add(4, 4096, 0);
+    a_timer_wheel_test_add(5, 4100, 0);
+    gs_record[0].cancel = &gs_timer[1];
+    gs_record[1].cancel = &gs_timer[0];
+    gs_record[2].cancel = &gs_timer[3];
+    gs_record[4].cancel = &gs_timer[5];
+    timer_wheel_run(&gs_wheel, 10000);
+    if ((gs_record[0].fired + gs_record[1].fired) != 1)
+    {
+        lan8720_interface_debug_print("lan8720: %u timers of the same tick fired, expect 1.\n",
+                                      (unsigned int)(gs_record[0].fired + gs_record[1].fired));
+        res = 1;
+    }
+    res |= a_timer_wheel_test_check(2, 1, 100);
+    res |= a_timer_wheel_test_check(3, 0, 0);
+    res |= a_timer_wheel_test_check(4, 1, 4096);
+    res |= a_timer_wheel_test_check(5, 0, 0);
+    if ((gs_timer[3].active != 0) || (gs_timer[5].active != 0) || (timer_wheel_sleeptime(&gs_wheel, 10000) != TIMER_WHEEL_NONE))
+    {
+        lan8720_interface_debug_print("lan8720: a removed timer is still in the wheel.\n");
+        res = 1;
+    }
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: timer wheel cancel test failed.\n");
+        
+        return 1;
+    }
+    
+    /* 32 bit tick wrap */
+    lan8720_interface_debug_print("lan8720: timer wheel tick wrap test.\n");
+    a_timer_wheel_test_reset(0xFFFFFF00U);
+    a_timer_wheel_test_add(0, 0x80, 0);
+    a_timer_wheel_test_add(1, 0x100, 0);
+    a_timer_wheel_test_add(2, 0x1005, 0);
+    a_timer_wheel_test_add(3, 100, 100);
+    a_timer_wheel_test_add(4, 0x40000, 0);
+    for (t = 0xFFFFFF00U + 0x40; t != 0x2000; t += 0x40)
+    {
+        timer_wheel_run(&gs_wheel, t);
+    }
+    timer_wheel_run(&gs_wheel, 0x2000);
+    res |= a_timer_wheel_test_check(0, 1, 0xFFFFFF80U);
+    res |= a_timer_wheel_test_check(1, 1, 0x00000000U);
+    res |= a_timer_wheel_test_check(2, 1, 0x00000F05U);
+    res |= a_timer_wheel_test_check(3, 84, 0x00001FD0U);
+    res |= a_timer_wheel_test_check(4, 0, 0);
+    timer_wheel_run(&gs_wheel, 0x0003FF00U);
+    res |= a_timer_wheel_test_check(4, 1, 0x0003FF00U);
+    if (res != 0)
+    {
+        lan8720_interface_debug_print("lan8720: timer wheel tick wrap test failed.\n");
+        
+        return 1;
+    }
+    
+    /* finish timer wheel test */
+    lan8720_interface_debug_print("lan8720: finish timer wheel test.\n");
+    
+    return 0;
+}
@@ -37,6 +37,7 @@
 #include "driver_lan8720_interface.h"
 #include "delay.h"
 #include "eth.h"
+#include "trace.h"
 #include "wire.h"
 #include "uart.h"
 #include <stdarg.h>
@@ -79,7 +80,13 @@ uint8_t lan8720_interface_smi_deinit(void)
  */
 uint8_t lan8720_interface_smi_read(uint8_t addr, uint8_t reg, uint16_t *data)
 {
-    return eth_read_phy(addr, reg, data);
+    uint8_t res;
+    TRACE_BEGIN(TRACE_PROBE_SMI_READ);
+    
+    res = eth_read_phy(addr, reg, data);
+    TRACE_END(TRACE_PROBE_SMI_READ);
+    
+    return res;
 }
 
 /**
@@ -94,7 +101,13 @@ uint8_t lan8720_interface_smi_read(uint8_t addr, uint8_t reg, uint16_t *data)
  */
 uint8_t lan8720_interface_smi_write(uint8_t addr, uint8_t reg, uint16_t data)
 {
-    return eth_write_phy(addr, reg, data);
+    uint8_t res;
+    TRACE_BEGIN(TRACE_PROBE_SMI_WRITE);
+    
+    res = eth_write_phy(addr, reg, data);
+    TRACE_END(TRACE_PROBE_SMI_WRITE);
+    
+    return res;
 }
 
 /**
@@ -147,7 +160,7 @@ void lan8720_interface_delay_ms(uint32_t ms)
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
- * @note      none
+ * @note      the line is queued in the uart tx ring and never waits for the uart outside the shell
  */
 void lan8720_interface_debug_print(const char *const fmt, ...)
 {
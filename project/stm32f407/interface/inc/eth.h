@@ -49,6 +49,24 @@
  * @{
  */
 
+/**
+ * @brief eth perfect filter multicast address number
+ */
+#define ETH_MULTICAST_PERFECT_CNT        3        /**< MACA1 - MACA3 */
+
+/**
+ * @brief eth mmc counter structure definition
+ */
+typedef struct eth_mmc_s
+{
+    uint32_t tx_good;                    /**< good frames transmitted */
+    uint32_t tx_single_collision;        /**< good frames transmitted after a single collision */
+    uint32_t tx_multiple_collision;      /**< good frames transmitted after more than one collision */
+    uint32_t rx_good_unicast;            /**< good unicast frames received */
+    uint32_t rx_crc_error;               /**< frames received with a crc error */
+    uint32_t rx_alignment_error;         /**< frames received with an alignment error */
+} eth_mmc_t;
+
 /**
  * @brief     eth init
  * @param[in] *mac pointer to a mac buffer
@@ -85,10 +103,28 @@ uint8_t eth_deinit(void);
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ *            - 2 tx ring is full
+ * @note      the frame is sent in interrupt mode and this function doesn't wait for the dma,
+ *            data is given back by HAL_ETH_TxFreeCallback in eth_tx_reclaim
  */
 uint8_t eth_write(ETH_BufferTypeDef *tx_buffer, void *data, uint32_t len);
 
+/**
+ * @brief  eth reclaim the transmitted tx descriptors
+ * @return status code
+ *         - 0 success
+ *         - 1 reclaim failed
+ * @note   HAL_ETH_TxFreeCallback is called for every transmitted frame
+ */
+uint8_t eth_tx_reclaim(void);
+
+/**
+ * @brief  eth get the tx descriptors in use
+ * @return number of the tx descriptors owned by the pending frames
+ * @note   none
+ */
+uint32_t eth_get_tx_in_use(void);
+
 /**
  * @brief      eth phy read
  * @param[in]  addr device address
@@ -113,6 +149,50 @@ uint8_t eth_read_phy(uint8_t addr, uint8_t reg, uint16_t *data);
  */
 uint8_t eth_write_phy(uint8_t addr, uint8_t reg, uint16_t data);
 
+/**
+ * @brief      eth get the rx missed frame counters
+ * @param[out] *no_buffer pointer to a frames missed with no rx descriptor buffer
+ * @param[out] *overflow pointer to a frames missed on the rx fifo overflow buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the hardware counters are cleared on read, so the results are the frames
+ *             missed since the last call
+ */
+uint8_t eth_get_rx_missed(uint32_t *no_buffer, uint32_t *overflow);
+
+/**
+ * @brief      eth get the mmc counters
+ * @param[out] *mmc pointer to an eth mmc structure
+ * @return     status code
+ *             - 0 success
+ * @note       the counters are free running, so the caller works on differences
+ */
+uint8_t eth_get_mmc(eth_mmc_t *mmc);
+
+/**
+ * @brief     eth send a pause frame
+ * @param[in] quanta pause time in 512 bit time slots
+ * @return    status code
+ *            - 0 success
+ *            - 2 pause frame busy
+ * @note      the quanta 0 resumes the link partner at once,
+ *            the transmit flow control must be enabled in the mac config
+ */
+uint8_t eth_send_pause(uint16_t quanta);
+
+/**
+ * @brief     eth set the multicast filter
+ * @param[in] **addr pointer to a multicast mac address table
+ * @param[in] len table length
+ * @param[in] pass_all pass all multicast frames
+ * @return    status code
+ *            - 0 success
+ *            - 1 set filter failed
+ * @note      the first ETH_MULTICAST_PERFECT_CNT addresses use the perfect filter registers,
+ *            the others use the 64 bin hash table, unicast frames always use the perfect filter
+ */
+uint8_t eth_set_multicast_filter(const uint8_t (*addr)[6], uint32_t len, uint8_t pass_all);
+
 /**
  * @brief  eth get the handle
  * @return pointer to an eth handle
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      trace.h
+ * @brief     trace header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/**
+ * @defgroup trace trace function
+ * @brief    trace function modules
+ * @{
+ */
+
+/**
+ * @brief trace enable definition, 0 removes all the probes at compile time
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        0
+#endif
+
+/**
+ * @brief trace probe enumeration definition
+ */
+typedef enum
+{
+    TRACE_PROBE_ETH_IRQ           = 0,        /**< ETH_IRQHandler */
+    TRACE_PROBE_RX_ALLOCATE       = 1,        /**< HAL_ETH_RxAllocateCallback */
+    TRACE_PROBE_RX_LINK           = 2,        /**< HAL_ETH_RxLinkCallback */
+    TRACE_PROBE_ETHERNETIF_INPUT  = 3,        /**< ethernetif_input */
+    TRACE_PROBE_LOW_LEVEL_OUTPUT  = 4,        /**< low_level_output */
+    TRACE_PROBE_ETH_WRITE         = 5,        /**< eth_write */
+    TRACE_PROBE_SMI_READ          = 6,        /**< lan8720_interface_smi_read */
+    TRACE_PROBE_SMI_WRITE         = 7,        /**< lan8720_interface_smi_write */
+    TRACE_PROBE_MAX               = 8,        /**< probe number */
+} trace_probe_t;
+
+/**
+ * @brief trace statistic structure definition
+ */
+typedef struct trace_stat_s
+{
+    uint32_t count;        /**< samples */
+    uint32_t min;          /**< min ticks */
+    uint32_t max;          /**< max ticks */
+    uint64_t sum;          /**< total ticks */
+} trace_stat_t;
+
+/**
+ * @brief trace probe definition
+ * @note  TRACE_BEGIN declares the start tick in the current block, TRACE_END records the sample
+ */
+#if TRACE_ENABLE
+#define TRACE_BEGIN(probe)        uint32_t trace_tick_##probe = trace_get_tick()
+#define TRACE_END(probe)          trace_record((probe), trace_get_tick() - trace_tick_##probe)
+#else
+#define TRACE_BEGIN(probe)
+#define TRACE_END(probe)
+#endif
+
+/**
+ * @brief  trace init
+ * @return status code
+ *         - 0 success
+ * @note   the target enables the dwt cycle counter
+ */
+uint8_t trace_init(void);
+
+/**
+ * @brief  trace get the tick
+ * @return current tick
+ * @note   the target returns dwt cycles, the host returns clock_gettime nanoseconds
+ */
+uint32_t trace_get_tick(void);
+
+/**
+ * @brief  trace get the tick unit name
+ * @return pointer to a unit name
+ * @note   none
+ */
+const char *trace_get_unit(void);
+
+/**
+ * @brief  trace get the ticks in a microsecond
+ * @return ticks per microsecond
+ * @note   none
+ */
+uint32_t trace_get_tick_per_us(void);
+
+/**
+ * @brief     trace record a sample
+ * @param[in] probe trace probe
+ * @param[in] ticks sample ticks
+ * @note      interrupt safe
+ */
+void trace_record(trace_probe_t probe, uint32_t ticks);
+
+/**
+ * @brief      trace get a probe statistic
+ * @param[in]  probe trace probe
+ * @param[out] *stat pointer to a trace statistic structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 probe is invalid
+ * @note       none
+ */
+uint8_t trace_get(trace_probe_t probe, trace_stat_t *stat);
+
+/**
+ * @brief     trace get a probe name
+ * @param[in] probe trace probe
+ * @return    pointer to a probe name
+ * @note      none
+ */
+const char *trace_get_name(trace_probe_t probe);
+
+/**
+ * @brief  trace get the probe overhead
+ * @return ticks of an empty TRACE_BEGIN and TRACE_END pair
+ * @note   the overhead is included in every sample
+ */
+uint32_t trace_get_overhead(void);
+
+/**
+ * @brief trace reset all the probes
+ * @note  none
+ */
+void trace_reset(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
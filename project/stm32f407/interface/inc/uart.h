@@ -55,6 +55,25 @@ extern "C"{
 #define UART_MAX_LEN        256        /**< uart max len */
 #define UART2_MAX_LEN       512        /**< uart2 max len */
 
+/**
+ * @brief uart tx ring length definition
+ */
+#ifndef UART_TX_RING_LEN
+    #define UART_TX_RING_LEN    2048       /**< uart tx ring len, a power of 2 */
+#endif
+
+/**
+ * @brief uart tx stats structure definition
+ */
+typedef struct uart_tx_stats_s
+{
+    uint32_t bytes;              /**< bytes queued */
+    uint32_t dropped;            /**< writes dropped with the ring full */
+    uint32_t dropped_bytes;      /**< bytes dropped with the ring full */
+    uint32_t level;              /**< bytes waiting in the ring */
+    uint32_t level_max;          /**< high-water mark of the ring */
+} uart_tx_stats_t;
+
 /**
  * @brief     uart init with 8 data bits, 1 stop bit and no parity
  * @param[in] baud baud rate
@@ -81,7 +100,8 @@ uint8_t uart_deinit(void);
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      the data is queued in the tx ring and sent by the tx interrupt, a write which does not fit is dropped
+ *            unless uart_set_tx_wait is enabled
  */
 uint8_t uart_write(uint8_t *buf, uint16_t len);
 
@@ -102,6 +122,13 @@ uint16_t uart_read(uint8_t *buf, uint16_t len);
  */
 uint16_t uart_flush(void);
 
+/**
+ * @brief  uart get the received length
+ * @return length of the received data
+ * @note   none
+ */
+uint16_t uart_get_rx_len(void);
+
 /**
  * @brief     uart print format data
  * @param[in] fmt format data
@@ -110,6 +137,26 @@ uint16_t uart_flush(void);
  */
 uint16_t uart_print(const char *const fmt, ...);
 
+/**
+ * @brief     uart set the tx wait
+ * @param[in] enable 1 waits for room in the tx ring, 0 drops the write
+ * @note      the wait is only done in thread mode, an interrupt never waits
+ */
+void uart_set_tx_wait(uint8_t enable);
+
+/**
+ * @brief      uart get the tx stats
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void uart_get_tx_stats(uart_tx_stats_t *stats);
+
+/**
+ * @brief uart reset the tx stats
+ * @note  the high-water mark restarts from the current level
+ */
+void uart_reset_tx_stats(void);
+
 /**
  * @brief  uart get the handle
  * @return pointer to a uart handle
@@ -119,7 +166,7 @@ UART_HandleTypeDef* uart_get_handle(void);
 
 /**
  * @brief uart set tx done
- * @note  none
+ * @note  called from the tx complete interrupt, it sends the next part of the tx ring
  */
 void uart_set_tx_done(void);
 
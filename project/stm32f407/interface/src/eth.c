@@ -35,6 +35,7 @@
  */
 
 #include "eth.h"
+#include "trace.h"
 #include <string.h>
 
 /**
@@ -152,16 +153,221 @@ uint8_t eth_write_phy(uint8_t addr, uint8_t reg, uint16_t data)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ *            - 2 tx ring is full
+ * @note      the frame is sent in interrupt mode and this function doesn't wait for the dma,
+ *            data is given back by HAL_ETH_TxFreeCallback in eth_tx_reclaim
  */
 uint8_t eth_write(ETH_BufferTypeDef *tx_buffer, void *data, uint32_t len)
 {
-    uint32_t timeout = 1000;
+    uint8_t res = 0;
+    TRACE_BEGIN(TRACE_PROBE_ETH_WRITE);
     
     g_tx_config.Length = len;
     g_tx_config.TxBuffer = tx_buffer;
     g_tx_config.pData = data;
-    if (HAL_ETH_Transmit(&g_eth_handle, &g_tx_config, timeout) != HAL_OK)
+    if (HAL_ETH_Transmit_IT(&g_eth_handle, &g_tx_config) != HAL_OK)
+    {
+        /* check the tx descriptors */
+        if ((g_eth_handle.ErrorCode & HAL_ETH_ERROR_BUSY) != 0)
+        {
+            g_eth_handle.ErrorCode &= ~HAL_ETH_ERROR_BUSY;
+            res = 2;
+        }
+        else
+        {
+            res = 1;
+        }
+    }
+    TRACE_END(TRACE_PROBE_ETH_WRITE);
+    
+    return res;
+}
+
+/**
+ * @brief  eth reclaim the transmitted tx descriptors
+ * @return status code
+ *         - 0 success
+ *         - 1 reclaim failed
+ * @note   HAL_ETH_TxFreeCallback is called for every transmitted frame
+ */
+uint8_t eth_tx_reclaim(void)
+{
+    if (HAL_ETH_ReleaseTxPacket(&g_eth_handle) != HAL_OK)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  eth get the tx descriptors in use
+ * @return number of the tx descriptors owned by the pending frames
+ * @note   none
+ */
+uint32_t eth_get_tx_in_use(void)
+{
+    return g_eth_handle.TxDescList.BuffersInUse;
+}
+
+/**
+ * @brief      eth get the rx missed frame counters
+ * @param[out] *no_buffer pointer to a frames missed with no rx descriptor buffer
+ * @param[out] *overflow pointer to a frames missed on the rx fifo overflow buffer
+ * @return     status code
+ *             - 0 success
+ * @note       the hardware counters are cleared on read, so the results are the frames
+ *             missed since the last call
+ */
+uint8_t eth_get_rx_missed(uint32_t *no_buffer, uint32_t *overflow)
+{
+    uint32_t reg;
+    
+    reg = g_eth_handle.Instance->DMAMFBOCR;
+    *no_buffer = reg & ETH_DMAMFBOCR_MFC;
+    *overflow = (reg & ETH_DMAMFBOCR_MFA) >> ETH_DMAMFBOCR_MFA_Pos;
+    
+    return 0;
+}
+
+/**
+ * @brief      eth get the mmc counters
+ * @param[out] *mmc pointer to an eth mmc structure
+ * @return     status code
+ *             - 0 success
+ * @note       the counters are free running, so the caller works on differences
+ */
+uint8_t eth_get_mmc(eth_mmc_t *mmc)
+{
+    ETH_TypeDef *eth = g_eth_handle.Instance;
+    
+    /* read the transmit counters */
+    mmc->tx_good = eth->MMCTGFCR;
+    mmc->tx_single_collision = eth->MMCTGFSCCR;
+    mmc->tx_multiple_collision = eth->MMCTGFMSCCR;
+    
+    /* read the receive counters */
+    mmc->rx_good_unicast = eth->MMCRGUFCR;
+    mmc->rx_crc_error = eth->MMCRFCECR;
+    mmc->rx_alignment_error = eth->MMCRFAECR;
+    
+    return 0;
+}
+
+/**
+ * @brief     eth send a pause frame
+ * @param[in] quanta pause time in 512 bit time slots
+ * @return    status code
+ *            - 0 success
+ *            - 2 pause frame busy
+ * @note      the quanta 0 resumes the link partner at once,
+ *            the transmit flow control must be enabled in the mac config
+ */
+uint8_t eth_send_pause(uint16_t quanta)
+{
+    uint32_t reg;
+    
+    /* the pause time must not change while a pause frame is pending */
+    reg = g_eth_handle.Instance->MACFCR;
+    if ((reg & ETH_MACFCR_FCBBPA) != 0)
+    {
+        return 2;
+    }
+    
+    /* load the pause time and trigger the pause frame */
+    reg &= ~ETH_MACFCR_PT;
+    reg |= ((uint32_t)quanta << ETH_MACFCR_PT_Pos) | ETH_MACFCR_FCBBPA;
+    g_eth_handle.Instance->MACFCR = reg;
+    
+    return 0;
+}
+
+/**
+ * @brief     eth calculate the multicast hash bin
+ * @param[in] *mac pointer to a mac address buffer
+ * @return    hash bin index in 0 - 63
+ * @note      the upper 6 bits of the bit reversed and inverted ethernet crc32
+ */
+static uint32_t a_eth_hash_bin(const uint8_t mac[6])
+{
+    uint32_t crc;
+    uint8_t i;
+    uint8_t j;
+    
+    /* ethernet crc32 over the destination address */
+    crc = 0xFFFFFFFFU;
+    for (i = 0; i < 6; i++)
+    {
+        crc ^= mac[i];
+        for (j = 0; j < 8; j++)
+        {
+            crc = (crc & 1U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+        }
+    }
+    
+    return __RBIT(~crc) >> 26;
+}
+
+/**
+ * @brief     eth set the multicast filter
+ * @param[in] **addr pointer to a multicast mac address table
+ * @param[in] len table length
+ * @param[in] pass_all pass all multicast frames
+ * @return    status code
+ *            - 0 success
+ *            - 1 set filter failed
+ * @note      the first ETH_MULTICAST_PERFECT_CNT addresses use the perfect filter registers,
+ *            the others use the 64 bin hash table, unicast frames always use the perfect filter
+ */
+uint8_t eth_set_multicast_filter(const uint8_t (*addr)[6], uint32_t len, uint8_t pass_all)
+{
+    ETH_MACFilterConfigTypeDef filter;
+    __IO uint32_t *reg;
+    uint32_t hash[2];
+    uint32_t bin;
+    uint32_t i;
+    
+    /* load the perfect filter registers MACA1 - MACA3 */
+    for (i = 0; i < ETH_MULTICAST_PERFECT_CNT; i++)
+    {
+        reg = &g_eth_handle.Instance->MACA1HR + (i * 2);
+        if (i < len)
+        {
+            reg[0] = ((uint32_t)addr[i][5] << 8) | (uint32_t)addr[i][4];
+            reg[1] = ((uint32_t)addr[i][3] << 24) | ((uint32_t)addr[i][2] << 16) |
+                     ((uint32_t)addr[i][1] << 8) | (uint32_t)addr[i][0];
+            reg[0] |= ETH_MACA1HR_AE;
+        }
+        else
+        {
+            reg[0] = 0x0000FFFFU;
+            reg[1] = 0xFFFFFFFFU;
+        }
+    }
+    
+    /* spill the other addresses into the hash table, hash[0] is MACHTHR */
+    hash[0] = 0;
+    hash[1] = 0;
+    for (i = ETH_MULTICAST_PERFECT_CNT; i < len; i++)
+    {
+        bin = a_eth_hash_bin(addr[i]);
+        hash[(bin >> 5) ^ 1U] |= 1UL << (bin & 0x1FU);
+    }
+    if (HAL_ETH_SetHashTable(&g_eth_handle, hash) != HAL_OK)
+    {
+        return 1;
+    }
+    
+    /* perfect or hash match for multicast, perfect match for unicast */
+    if (HAL_ETH_GetMACFilterConfig(&g_eth_handle, &filter) != HAL_OK)
+    {
+        return 1;
+    }
+    filter.HachOrPerfectFilter = ENABLE;
+    filter.HashUnicast = DISABLE;
+    filter.HashMulticast = (len > ETH_MULTICAST_PERFECT_CNT) ? ENABLE : DISABLE;
+    filter.PassAllMulticast = (pass_all != 0) ? ENABLE : DISABLE;
+    if (HAL_ETH_SetMACFilterConfig(&g_eth_handle, &filter) != HAL_OK)
     {
         return 1;
     }
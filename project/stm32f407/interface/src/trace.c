@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      trace.c
+ * @brief     trace source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "trace.h"
+#include <string.h>
+
+#if defined(__arm__) || defined(__ICCARM__) || defined(__CC_ARM)
+#include "stm32f4xx_hal.h"
+#define TRACE_TARGET        1
+#else
+#include <time.h>
+#define TRACE_TARGET        0
+#endif
+
+/**
+ * @brief trace var definition
+ */
+static trace_stat_t gs_trace[TRACE_PROBE_MAX];        /**< probe statistics */
+static uint32_t gs_overhead = 0;                      /**< probe overhead */
+
+/**
+ * @brief trace probe name definition
+ */
+static const char *const gs_name[TRACE_PROBE_MAX] =
+{
+    "eth_irq",
+    "rx_allocate",
+    "rx_link",
+    "ethernetif_input",
+    "low_level_output",
+    "eth_write",
+    "smi_read",
+    "smi_write",
+};
+
+/**
+ * @brief  trace init
+ * @return status code
+ *         - 0 success
+ * @note   the target enables the dwt cycle counter
+ */
+uint8_t trace_init(void)
+{
+    uint32_t start;
+    
+#if TRACE_TARGET
+    /* enable the dwt cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    
+    /* measure an empty probe */
+    start = trace_get_tick();
+    gs_overhead = trace_get_tick() - start;
+    trace_reset();
+    
+    return 0;
+}
+
+/**
+ * @brief  trace get the tick
+ * @return current tick
+ * @note   the target returns dwt cycles, the host returns clock_gettime nanoseconds
+ */
+uint32_t trace_get_tick(void)
+{
+#if TRACE_TARGET
+    return DWT->CYCCNT;
+#else
+    struct timespec ts;
+    
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/**
+ * @brief  trace get the tick unit name
+ * @return pointer to a unit name
+ * @note   none
+ */
+const char *trace_get_unit(void)
+{
+#if TRACE_TARGET
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+/**
+ * @brief  trace get the ticks in a microsecond
+ * @return ticks per microsecond
+ * @note   none
+ */
+uint32_t trace_get_tick_per_us(void)
+{
+#if TRACE_TARGET
+    return SystemCoreClock / 1000000U;
+#else
+    return 1000U;
+#endif
+}
+
+/**
+ * @brief     trace record a sample
+ * @param[in] probe trace probe
+ * @param[in] ticks sample ticks
+ * @note      interrupt safe
+ */
+void trace_record(trace_probe_t probe, uint32_t ticks)
+{
+    trace_stat_t *stat;
+#if TRACE_TARGET
+    uint32_t primask;
+    
+    /* the same probe may fire in the main loop and in an interrupt */
+    primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+    
+    stat = &gs_trace[probe];
+    if ((stat->count == 0) || (ticks < stat->min))
+    {
+        stat->min = ticks;
+    }
+    if (ticks > stat->max)
+    {
+        stat->max = ticks;
+    }
+    stat->sum += ticks;
+    stat->count++;
+    
+#if TRACE_TARGET
+    __set_PRIMASK(primask);
+#endif
+}
+
+/**
+ * @brief      trace get a probe statistic
+ * @param[in]  probe trace probe
+ * @param[out] *stat pointer to a trace statistic structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 probe is invalid
+ * @note       none
+ */
+uint8_t trace_get(trace_probe_t probe, trace_stat_t *stat)
+{
+    if (probe >= TRACE_PROBE_MAX)
+    {
+        return 1;
+    }
+    
+#if TRACE_TARGET
+    __disable_irq();
+    *stat = gs_trace[probe];
+    __enable_irq();
+#else
+    *stat = gs_trace[probe];
+#endif
+    
+    return 0;
+}
+
+/**
+ * @brief     trace get a probe name
+ * @param[in] probe trace probe
+ * @return    pointer to a probe name
+ * @note      none
+ */
+const char *trace_get_name(trace_probe_t probe)
+{
+    if (probe >= TRACE_PROBE_MAX)
+    {
+        return "unknown";
+    }
+    
+    return gs_name[probe];
+}
+
+/**
+ * @brief  trace get the probe overhead
+ * @return ticks of an empty TRACE_BEGIN and TRACE_END pair
+ * @note   the overhead is included in every sample
+ */
+uint32_t trace_get_overhead(void)
+{
+    return gs_overhead;
+}
+
+/**
+ * @brief trace reset all the probes
+ * @note  none
+ */
+void trace_reset(void)
+{
+#if TRACE_TARGET
+    __disable_irq();
+    memset(gs_trace, 0, sizeof(gs_trace));
+    __enable_irq();
+#else
+    memset(gs_trace, 0, sizeof(gs_trace));
+#endif
+}
@@ -48,6 +48,16 @@ uint8_t g_uart_buffer;                         /**< uart one buffer */
 volatile uint16_t g_uart_point;                /**< uart rx point */
 volatile uint8_t g_uart_tx_done;               /**< uart tx done flag */
 
+/**
+ * @brief uart1 tx ring definition
+ */
+static uint8_t gs_tx_ring[UART_TX_RING_LEN];   /**< uart tx ring */
+static volatile uint32_t gs_tx_head;           /**< bytes written, the ring offset is taken modulo the length */
+static volatile uint32_t gs_tx_tail;           /**< bytes sent */
+static volatile uint32_t gs_tx_busy;           /**< bytes given to the tx interrupt */
+static volatile uint8_t gs_tx_wait;            /**< writers in thread mode wait for room */
+static uart_tx_stats_t gs_tx_stats;            /**< tx stats */
+
 /**
  * @brief uart2 var definition
  */
@@ -105,10 +115,37 @@ uint8_t uart_deinit(void)
     {
         return 1;
     }
+    
+    /* the transfer in flight was stopped, so drop what is left in the tx ring */
+    gs_tx_tail = gs_tx_head;
+    gs_tx_busy = 0;
 
     return 0;
 }
 
+/**
+ * @brief uart send the next part of the tx ring
+ * @note  call it with the interrupts masked or from the tx interrupt
+ */
+static void a_uart_tx_start(void)
+{
+    uint32_t level = gs_tx_head - gs_tx_tail;
+    uint32_t offset = gs_tx_tail % UART_TX_RING_LEN;
+    uint32_t len;
+
+    if ((gs_tx_busy != 0) || (level == 0))
+    {
+        return;
+    }
+
+    /* send up to the end of the ring, the rest follows in the next interrupt */
+    len = ((UART_TX_RING_LEN - offset) < level) ? (UART_TX_RING_LEN - offset) : level;
+    if (HAL_UART_Transmit_IT(&g_uart_handle, &gs_tx_ring[offset], (uint16_t)len) == HAL_OK)
+    {
+        gs_tx_busy = len;
+    }
+}
+
 /**
  * @brief     uart write data
  * @param[in] *buf pointer to a data buffer
@@ -116,37 +153,50 @@ uint8_t uart_deinit(void)
  * @return    status code
  *            - 0 success
  *            - 1 write failed
- * @note      none
+ * @note      the data is queued in the tx ring and sent by the tx interrupt, a write which does not fit is dropped
+ *            unless uart_set_tx_wait is enabled
  */
 uint8_t uart_write(uint8_t *buf, uint16_t len)
 {
     uint16_t timeout = 1000;
+    uint32_t primask;
+    uint32_t offset;
+    uint32_t part;
 
-    /* set tx done 0 */
-    g_uart_tx_done = 0;
-
-    /* transmit */
-    if (HAL_UART_Transmit_IT(&g_uart_handle, (uint8_t *)buf, len) != HAL_OK)
-    {
-        return 1;
-    }
-
-    /* wait for events */
-    while ((g_uart_tx_done == 0) && (timeout != 0))
+    /* only the shell waits for room, the driver and the network paths never block on a log line */
+    while ((gs_tx_wait != 0) && (__get_IPSR() == 0) && (timeout != 0) &&
+           ((UART_TX_RING_LEN - (gs_tx_head - gs_tx_tail)) < len))
     {
         HAL_Delay(1);
         timeout--;
     }
 
-    /* check the timeout */
-    if (timeout != 0)
+    /* a write may come from an interrupt, keep it out while the ring changes */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if ((UART_TX_RING_LEN - (gs_tx_head - gs_tx_tail)) < len)
     {
-        return 0;
+        gs_tx_stats.dropped++;
+        gs_tx_stats.dropped_bytes += len;
+        __set_PRIMASK(primask);
+
+        return 1;
     }
-    else
+    offset = gs_tx_head % UART_TX_RING_LEN;
+    part = ((UART_TX_RING_LEN - offset) < len) ? (UART_TX_RING_LEN - offset) : len;
+    memcpy(&gs_tx_ring[offset], buf, part);
+    memcpy(gs_tx_ring, buf + part, len - part);
+    gs_tx_head += len;
+    gs_tx_stats.bytes += len;
+    if ((gs_tx_head - gs_tx_tail) > gs_tx_stats.level_max)
     {
-        return 1;
+        gs_tx_stats.level_max = gs_tx_head - gs_tx_tail;
     }
+    g_uart_tx_done = 0;
+    a_uart_tx_start();
+    __set_PRIMASK(primask);
+
+    return 0;
 }
 
 /**
@@ -194,6 +244,16 @@ uint16_t uart_flush(void)
     return 0;
 }
 
+/**
+ * @brief  uart get the received length
+ * @return length of the received data
+ * @note   none
+ */
+uint16_t uart_get_rx_len(void)
+{
+    return g_uart_point;
+}
+
 /**
  * @brief     uart print format data
  * @param[in] fmt format data
@@ -361,6 +421,37 @@ uint16_t uart2_flush(void)
     return 0;
 }
 
+/**
+ * @brief     uart set the tx wait
+ * @param[in] enable 1 waits for room in the tx ring, 0 drops the write
+ * @note      the wait is only done in thread mode, an interrupt never waits
+ */
+void uart_set_tx_wait(uint8_t enable)
+{
+    gs_tx_wait = enable;
+}
+
+/**
+ * @brief      uart get the tx stats
+ * @param[out] *stats pointer to a stats structure
+ * @note       none
+ */
+void uart_get_tx_stats(uart_tx_stats_t *stats)
+{
+    *stats = gs_tx_stats;
+    stats->level = gs_tx_head - gs_tx_tail;
+}
+
+/**
+ * @brief uart reset the tx stats
+ * @note  the high-water mark restarts from the current level
+ */
+void uart_reset_tx_stats(void)
+{
+    memset(&gs_tx_stats, 0, sizeof(uart_tx_stats_t));
+    gs_tx_stats.level_max = gs_tx_head - gs_tx_tail;
+}
+
 /**
  * @brief  uart get the handle
  * @return pointer to a uart handle
@@ -383,11 +474,17 @@ UART_HandleTypeDef* uart2_get_handle(void)
 
 /**
  * @brief uart set tx done
- * @note  none
+ * @note  called from the tx complete interrupt, it sends the next part of the tx ring
  */
 void uart_set_tx_done(void)
 {
-    g_uart_tx_done = 1;
+    gs_tx_tail += gs_tx_busy;
+    gs_tx_busy = 0;
+    a_uart_tx_start();
+    if (gs_tx_busy == 0)
+    {
+        g_uart_tx_done = 1;
+    }
 }
 
 /**
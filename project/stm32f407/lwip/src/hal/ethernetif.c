@@ -27,6 +27,7 @@
 #include "ethernetif.h"
 #undef __CC_ARM
 #include "driver_lan8720_basic.h"
+#include "trace.h"
 #include <string.h>
 
 /* Private typedef -----------------------------------------------------------*/
@@ -37,6 +38,7 @@
 
 #define ETH_RX_BUFFER_SIZE            ETH_RX_BUF_SIZE
 #define ETH_RX_BUFFER_CNT             10U
+#define ETH_TX_BUFFER_SIZE            ETH_TX_BUF_SIZE
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -52,158 +54,1497 @@ typedef struct
     uint8_t buff[(ETH_RX_BUFFER_SIZE + 31) & ~31] __ALIGNED(32);
 } RxBuff_t;
 
+typedef struct
+{
+    struct pbuf_custom pbuf_custom;
+    uint8_t buff[(ETH_TX_BUFFER_SIZE + 31) & ~31] __ALIGNED(32);
+} TxBuff_t;
+
 /* Memory Pool Declaration */
 LWIP_MEMPOOL_DECLARE(RX_POOL, ETH_RX_BUFFER_CNT, sizeof(RxBuff_t), "Zero-copy RX PBUF pool");
+LWIP_MEMPOOL_DECLARE(TX_POOL, ETH_TX_BOUNCE_CNT, sizeof(TxBuff_t), "TX bounce PBUF pool");
 static uint8_t RxAllocStatus;
 
-/* Private function prototypes -----------------------------------------------*/
-void ethernet_link_check_state(struct netif *netif);
-void pbuf_free_custom(struct pbuf *p);
+/* RX pool accounting and refill signalling */
+static uint32_t RxPoolInUse = 0U;
+static uint32_t RxAllocErrorTick = 0U;
+static volatile uint8_t RxRefill = 0U;
+
+/* RX interrupt mitigation */
+static volatile uint8_t RxPending = 0U;
+static uint8_t RxMitigation = ETH_RX_MITIGATION;
+static uint32_t RxPollBudget = ETH_RX_POLL_BUDGET;
+
+/* RX copy-break threshold */
+static uint32_t RxCopyBreak = ETH_RX_COPYBREAK;
+
+/* EtherType fast-path handlers, the type is kept in network order */
+typedef struct
+{
+    uint16_t type;
+    ethernetif_rx_handler_t handler;
+    void *arg;
+} RxHandler_t;
+
+static RxHandler_t RxHandler[ETH_RX_HANDLER_CNT];
+static volatile uint32_t RxHandlerCnt = 0U;
+
+/* Capture tap, NULL while no capture is armed */
+static volatile ethernetif_tap_t CaptureTap = NULL;
+
+/* Software TX queues, frames wait here while the TX descriptors are busy.
+   Queue 0 is served first, the last one is the bulk queue */
+#define ETH_TX_BULK                   (ETH_TX_PRIO_CNT - 1U)
+static struct pbuf *TxQueue[ETH_TX_PRIO_CNT][ETH_TX_QUEUE_LEN];
+static uint32_t TxQueueTick[ETH_TX_PRIO_CNT][ETH_TX_QUEUE_LEN];
+static uint32_t TxQueueHead[ETH_TX_PRIO_CNT];
+static uint32_t TxQueueLen[ETH_TX_PRIO_CNT];
+static uint32_t TxQueueCnt = 0U;
+static volatile uint8_t TxReclaim = 0U;
+static uint32_t TxTickPerUs = 1U;
+
+/* TX queues by EtherType, the type is kept in network order */
+typedef struct
+{
+    uint16_t type;
+    uint8_t queue;
+} TxClass_t;
+
+static TxClass_t TxClass[ETH_TX_CLASS_CNT];
+static uint32_t TxClassCnt = 0U;
+
+/* Bulk frames owned by the DMA, the byte limit keeps the ring short for the
+   higher queues. A frame takes at least one descriptor. */
+static struct pbuf *TxBulk[ETH_TX_DESC_CNT];
+static uint16_t TxBulkLen[ETH_TX_DESC_CNT];
+static uint32_t TxBulkCnt = 0U;
+static uint32_t TxBulkBytes = 0U;
+static uint32_t TxBulkLimit = ETH_TX_BULK_RING_BYTES;
+
+/* MAC flow control, PAUSE frames are sent while the RX pool is low */
+static uint8_t TxPauseEnable = 0U;
+static volatile uint8_t TxPauseActive = 0U;
+static uint32_t TxPauseTick = 0U;
+static uint32_t TxPauseRefreshMs = 0U;
+
+/* Duplex mismatch detector */
+static uint32_t LinkDuplex = ETH_FULLDUPLEX_MODE;
+static uint8_t DuplexForced = 0U;
+static uint32_t DuplexSuspect = 0U;
+static uint32_t DuplexCheckTick = 0U;
+static eth_mmc_t DuplexMmc;
+
+/* Link flap dampening and recovery timing */
+static uint32_t FlapPenalty = 0U;
+static uint32_t FlapTick = 0U;
+static uint8_t FlapHeld = 0U;
+static uint8_t LinkLost = 0U;
+static uint32_t LinkDownTick = 0U;
+static uint32_t LinkUpTick = 0U;
+static volatile uint8_t LinkTrafficWait = 0U;
+
+/* PHY near end loopback, the link check leaves the MAC alone while it runs */
+static uint8_t LoopBack = 0U;
+
+/* Multicast MAC addresses programmed into the hardware filter, one entry is
+   shared by all the groups mapping onto the same MAC address */
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+static uint8_t McastAddr[ETH_MCAST_FILTER_CNT][6];
+static uint8_t McastRef[ETH_MCAST_FILTER_CNT];
+static uint32_t McastCnt = 0U;
+static uint32_t McastOverflow = 0U;
+#endif
+
+/* Interface statistics, the MMC and PHY counters are free running */
+static ethernetif_stats_t EthStats;
+static eth_mmc_t StatsMmc;
+static uint16_t PhySymbolErrors = 0U;
+
+/* Private function prototypes -----------------------------------------------*/
+void ethernet_link_check_state(struct netif *netif);
+void pbuf_free_custom(struct pbuf *p);
+static void pbuf_free_tx_bounce(struct pbuf *p);
+
+static uint8_t gs_addr = 0x01;
+
+/**
+ * @brief     set phy address
+ * @param[in] addr device address
+ * @note      none
+ */
+void eth_set_address(uint8_t addr)
+{
+    gs_addr = addr;
+}
+
+/* Private functions ---------------------------------------------------------*/
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+/**
+  * @brief Add or remove one reference to a multicast MAC address and reload
+  * the hardware filter when the address set changes.
+  * The first addresses take the MAC perfect filter slots, the rest share
+  * the 64 bin hash table, all multicast passes once the table overflows.
+  *
+  * @param mac the multicast MAC address
+  * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+  * @return ERR_OK if the filter is updated, ERR_IF otherwise
+  */
+static err_t low_level_mcast_filter(const uint8_t *mac, enum netif_mac_filter_action action)
+{
+    uint32_t i;
+
+    for (i = 0U; i < McastCnt; i++)
+    {
+        if (memcmp(McastAddr[i], mac, 6) == 0)
+        {
+            break;
+        }
+    }
+
+    if (action == NETIF_ADD_MAC_FILTER)
+    {
+        if (i < McastCnt)
+        {
+            /* already in the filter */
+            McastRef[i]++;
+            return ERR_OK;
+        }
+        if (McastCnt < ETH_MCAST_FILTER_CNT)
+        {
+            memcpy(McastAddr[McastCnt], mac, 6);
+            McastRef[McastCnt] = 1U;
+            McastCnt++;
+        }
+        else
+        {
+            McastOverflow++;
+        }
+    }
+    else
+    {
+        if (i < McastCnt)
+        {
+            if (--McastRef[i] != 0U)
+            {
+                return ERR_OK;
+            }
+            /* keep the table packed, the order only decides the perfect slots */
+            McastCnt--;
+            memcpy(McastAddr[i], McastAddr[McastCnt], 6);
+            McastRef[i] = McastRef[McastCnt];
+        }
+        else if (McastOverflow > 0U)
+        {
+            McastOverflow--;
+        }
+        else
+        {
+            return ERR_OK;
+        }
+    }
+
+    EthStats.mcast_groups = McastCnt;
+    EthStats.mcast_overflow = McastOverflow;
+    if (eth_set_multicast_filter((const uint8_t (*)[6])McastAddr, McastCnt, (McastOverflow > 0U) ? 1 : 0) != 0)
+    {
+        EthStats.mcast_filter_errors++;
+        return ERR_IF;
+    }
+
+    return ERR_OK;
+}
+#endif
+
+#if LWIP_IGMP
+/**
+  * @brief IGMP MAC filter callback, maps the group onto 01:00:5e:xx:xx:xx.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param group the IPv4 multicast group
+  * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+  * @return ERR_OK if the filter is updated
+  */
+static err_t low_level_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group,
+                                       enum netif_mac_filter_action action)
+{
+    uint8_t mac[6];
+    uint32_t addr = lwip_ntohl(ip4_addr_get_u32(group));
+
+    LWIP_UNUSED_ARG(netif);
+
+    mac[0] = 0x01U;
+    mac[1] = 0x00U;
+    mac[2] = 0x5EU;
+    mac[3] = (uint8_t)((addr >> 16) & 0x7FU);
+    mac[4] = (uint8_t)(addr >> 8);
+    mac[5] = (uint8_t)addr;
+
+    return low_level_mcast_filter(mac, action);
+}
+#endif
+
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+/**
+  * @brief MLD MAC filter callback, maps the group onto 33:33:xx:xx:xx:xx.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param group the IPv6 multicast group
+  * @param action NETIF_ADD_MAC_FILTER or NETIF_DEL_MAC_FILTER
+  * @return ERR_OK if the filter is updated
+  */
+static err_t low_level_mld_mac_filter(struct netif *netif, const ip6_addr_t *group,
+                                      enum netif_mac_filter_action action)
+{
+    uint8_t mac[6];
+    uint32_t addr = lwip_ntohl(group->addr[3]);
+
+    LWIP_UNUSED_ARG(netif);
+
+    mac[0] = 0x33U;
+    mac[1] = 0x33U;
+    mac[2] = (uint8_t)(addr >> 24);
+    mac[3] = (uint8_t)(addr >> 16);
+    mac[4] = (uint8_t)(addr >> 8);
+    mac[5] = (uint8_t)addr;
+
+    return low_level_mcast_filter(mac, action);
+}
+#endif
+
+/**
+  * @brief Send a PAUSE frame to stop the link partner for ETH_PAUSE_TIME.
+  * Only used when transmit flow control was negotiated on the link.
+  */
+static void low_level_pause(void)
+{
+    if (eth_send_pause(ETH_PAUSE_TIME) == 0U)
+    {
+        TxPauseActive = 1U;
+        TxPauseTick = HAL_GetTick();
+        EthStats.pause_frames++;
+    }
+}
+
+/**
+  * @brief Accumulate the rolling PHY symbol error counter, it must be read
+  * at least once per 65536 errors.
+  */
+static void low_level_phy_stats(void)
+{
+    uint16_t cnt;
+
+    if (lan8720_basic_symbol_error_counter(&cnt) == 0)
+    {
+        EthStats.phy_symbol_errors += (uint16_t)(cnt - PhySymbolErrors);
+        PhySymbolErrors = cnt;
+    }
+}
+
+/**
+  * @brief Decay the flap dampening penalty, it halves every ETH_FLAP_HALF_LIFE_MS.
+  * @retval None
+  */
+static void low_level_flap_decay(void)
+{
+#if ETH_FLAP_HALF_LIFE_MS != 0U
+    uint32_t now = HAL_GetTick();
+
+    if ((FlapPenalty == 0U) || ((now - FlapTick) >= (32U * ETH_FLAP_HALF_LIFE_MS)))
+    {
+        FlapPenalty = 0U;
+        FlapTick = now;
+    }
+    while ((now - FlapTick) >= ETH_FLAP_HALF_LIFE_MS)
+    {
+        FlapPenalty >>= 1;
+        FlapTick += ETH_FLAP_HALF_LIFE_MS;
+    }
+    EthStats.flap_penalty = FlapPenalty;
+#endif
+}
+
+/**
+  * @brief Look for a duplex mismatch once per ETH_DUPLEX_CHECK_MS while the link is up.
+  * A half duplex link to a partner which does not negotiate (parallel detection)
+  * and shows a high TX collision rate, or a forced full duplex link which shows
+  * RX CRC errors, is suspicious. ETH_DUPLEX_MISMATCH_WINDOWS suspicious windows
+  * in a row flag a mismatch and apply ETH_DUPLEX_FORCE_MODE when it is set.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  */
+static void low_level_duplex_check(struct netif *netif)
+{
+    eth_mmc_t mmc;
+    lan8720_bool_t fault, partner_an;
+    uint32_t collisions, frames, errors;
+    uint8_t suspect = 0U;
+
+    if (HAL_GetTick() - DuplexCheckTick < ETH_DUPLEX_CHECK_MS)
+    {
+        return;
+    }
+    DuplexCheckTick = HAL_GetTick();
+    low_level_phy_stats();
+
+    if (lan8720_basic_parallel_detection(&fault, &partner_an) != 0)
+    {
+        return;
+    }
+    if (fault == LAN8720_BOOL_TRUE)
+    {
+        EthStats.duplex_pd_fault++;
+    }
+    EthStats.duplex_parallel_detect = (partner_an == LAN8720_BOOL_FALSE) ? 1U : 0U;
+
+    /* Counter differences over the window */
+    (void)eth_get_mmc(&mmc);
+    collisions = (mmc.tx_single_collision - DuplexMmc.tx_single_collision) +
+                 (mmc.tx_multiple_collision - DuplexMmc.tx_multiple_collision);
+    frames = mmc.tx_good - DuplexMmc.tx_good;
+    errors = (mmc.rx_crc_error - DuplexMmc.rx_crc_error) +
+             (mmc.rx_alignment_error - DuplexMmc.rx_alignment_error);
+    DuplexMmc = mmc;
+    EthStats.duplex_collisions += collisions;
+    EthStats.duplex_rx_errors += errors;
+
+    if (LinkDuplex == ETH_HALFDUPLEX_MODE)
+    {
+        /* A full duplex partner talks over our frames, collisions on a
+         * negotiated half duplex link are normal */
+        if (((partner_an == LAN8720_BOOL_FALSE) || (fault == LAN8720_BOOL_TRUE)) &&
+            (frames >= ETH_DUPLEX_MIN_FRAMES) && (collisions * 100U >= frames * ETH_DUPLEX_COLLISION_PCT))
+        {
+            suspect = 1U;
+        }
+    }
+    else
+    {
+        /* A half duplex partner of a forced link aborts on collisions and
+         * leaves runts and CRC errors */
+        if ((DuplexForced != 0U) && (errors >= ETH_DUPLEX_MIN_ERRORS))
+        {
+            suspect = 1U;
+        }
+    }
+
+    if (suspect == 0U)
+    {
+        DuplexSuspect = 0U;
+        EthStats.duplex_mismatch = 0U;
+        return;
+    }
+    if ((++DuplexSuspect < ETH_DUPLEX_MISMATCH_WINDOWS) || (EthStats.duplex_mismatch != 0U))
+    {
+        return;
+    }
+    EthStats.duplex_mismatch = 1U;
+    EthStats.duplex_mismatch_events++;
+
+#if ETH_DUPLEX_FORCE_MODE != 0U
+    /* Force the configured mode once, the link comes up again with it */
+    if (DuplexForced == 0U)
+    {
+        if (lan8720_basic_force_mode((ETH_DUPLEX_FORCE_MODE & 0x02U) ? LAN8720_SPEED_100M : LAN8720_SPEED_10M,
+                                     (ETH_DUPLEX_FORCE_MODE & 0x04U) ? LAN8720_DUPLEX_FULL : LAN8720_DUPLEX_HALF) == 0)
+        {
+            DuplexForced = 1U;
+            EthStats.duplex_forced = 1U;
+            HAL_ETH_Stop_IT(eth_get_handle());
+            netif_set_link_down(netif);
+        }
+    }
+#else
+    LWIP_UNUSED_ARG(netif);
+#endif
+}
+
+/*******************************************************************************
+                       LL Driver Interface ( LwIP stack --> ETH)
+*******************************************************************************/
+/**
+  * @brief In this function, the hardware should be initialized.
+  * Called from ethernetif_init().
+  *
+  * @param netif the already initialized lwip network interface structure
+  *        for this ethernetif
+  */
+static void low_level_init(struct netif *netif)
+{
+    uint8_t mac[6] = {MAC_ADDR0, MAC_ADDR1, MAC_ADDR2, MAC_ADDR3, MAC_ADDR4, MAC_ADDR5};
+    
+    eth_init(mac);
+    TxTickPerUs = trace_get_tick_per_us();
+
+    /* set MAC hardware address length */
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+
+    /* set MAC hardware address */
+    netif->hwaddr[0] =  MAC_ADDR0;
+    netif->hwaddr[1] =  MAC_ADDR1;
+    netif->hwaddr[2] =  MAC_ADDR2;
+    netif->hwaddr[3] =  MAC_ADDR3;
+    netif->hwaddr[4] =  MAC_ADDR4;
+    netif->hwaddr[5] =  MAC_ADDR5;
+
+    /* maximum transfer unit */
+    netif->mtu = ETH_MAX_PAYLOAD;
+
+    /* device capabilities */
+    /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
+    netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
+
+#if LWIP_IGMP
+    /* multicast frames are filtered in hardware, join the groups through IGMP */
+    netif->flags |= NETIF_FLAG_IGMP;
+    netif_set_igmp_mac_filter(netif, low_level_igmp_mac_filter);
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+    netif->flags |= NETIF_FLAG_MLD6;
+    netif_set_mld_mac_filter(netif, low_level_mld_mac_filter);
+#endif
+
+    /* Initialize the RX POOL */
+    LWIP_MEMPOOL_INIT(RX_POOL);
+
+    /* Statistics baseline */
+    (void)eth_get_mmc(&StatsMmc);
+
+    /* Initialize the TX bounce POOL */
+    LWIP_MEMPOOL_INIT(TX_POOL);
+    
+    (void)lan8720_basic_init(gs_addr);
+    
+    /* the link and the mac come up on the first ethernet_link_thread check, so
+     * the clients started after netif_add() send nothing before the link up */
+}
+
+/**
+ * Hand a descriptor list to the TX DMA without waiting for the transfer.
+ * The pbuf is referenced until HAL_ETH_TxFreeCallback releases it.
+ *
+ * @param Txbuffer the buffer list describing the frame
+ * @param p the pbuf owning the buffers
+ * @param queue the TX queue of the frame
+ * @return ERR_OK if the frame is owned by the DMA, ERR_WOULDBLOCK if the
+ *         descriptors are busy, ERR_IF on a DMA error
+ */
+static err_t low_level_send(ETH_BufferTypeDef *Txbuffer, struct pbuf *p, uint32_t queue)
+{
+    uint8_t res;
+
+    pbuf_ref(p);
+    res = eth_write(Txbuffer, p, p->tot_len);
+    if (res != 0)
+    {
+        pbuf_free(p);
+        if (res == 2)
+        {
+            EthStats.tx_ring_full++;
+
+            return ERR_WOULDBLOCK;
+        }
+        EthStats.tx_errors++;
+
+        return ERR_IF;
+    }
+    EthStats.tx_frames++;
+    EthStats.tx_bytes += p->tot_len;
+    EthStats.tx_prio[queue].frames++;
+    EthStats.tx_prio[queue].bytes += p->tot_len;
+    if ((ETH_TX_PRIO_CNT > 1U) && (queue == ETH_TX_BULK) && (TxBulkCnt < ETH_TX_DESC_CNT))
+    {
+        /* Counted until HAL_ETH_TxFreeCallback gives it back */
+        TxBulk[TxBulkCnt] = p;
+        TxBulkLen[TxBulkCnt] = p->tot_len;
+        TxBulkCnt++;
+        TxBulkBytes += p->tot_len;
+    }
+    if (eth_get_tx_in_use() > EthStats.tx_ring_max)
+    {
+        EthStats.tx_ring_max = eth_get_tx_in_use();
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * Copy a chain with more segments than TX descriptors into a bounce buffer
+ * and send it as a single segment. The bounce buffer goes back to its pool
+ * once the DMA has released it.
+ *
+ * @param p the MAC packet to send
+ * @param queue the TX queue of the frame
+ * @return ERR_OK if the frame is owned by the DMA, ERR_WOULDBLOCK if the
+ *         descriptors or bounce buffers are busy, ERR_IF otherwise
+ */
+static err_t low_level_transmit_copy(struct pbuf *p, uint32_t queue)
+{
+    struct pbuf_custom *c;
+    struct pbuf *b;
+    ETH_BufferTypeDef Txbuffer;
+    err_t errval;
+
+    if (p->tot_len > ETH_TX_BUFFER_SIZE)
+    {
+        EthStats.tx_errors++;
+
+        return ERR_IF;
+    }
+    c = LWIP_MEMPOOL_ALLOC(TX_POOL);
+    if (c == NULL)
+    {
+        /* All bounce buffers are still owned by the DMA */
+        EthStats.tx_bounce_busy++;
+
+        return ERR_WOULDBLOCK;
+    }
+    c->custom_free_function = pbuf_free_tx_bounce;
+    b = pbuf_alloced_custom(PBUF_RAW, p->tot_len, PBUF_REF, c,
+                            (uint8_t *)c + offsetof(TxBuff_t, buff), ETH_TX_BUFFER_SIZE);
+    (void)pbuf_copy_partial(p, b->payload, p->tot_len, 0);
+
+    Txbuffer.buffer = b->payload;
+    Txbuffer.len = b->len;
+    Txbuffer.next = NULL;
+    errval = low_level_send(&Txbuffer, b, queue);
+    if (errval == ERR_OK)
+    {
+        EthStats.tx_linearized++;
+    }
+
+    /* Drop the allocation reference, the DMA keeps its own */
+    pbuf_free(b);
+
+    return errval;
+}
+
+/**
+ * Hand a frame to the TX DMA without waiting for the transfer. Chains which
+ * fit in the TX descriptors are sent zero-copy, longer ones are linearized.
+ *
+ * @param p the MAC packet to send
+ * @param queue the TX queue of the frame
+ * @return ERR_OK if the frame is owned by the DMA, ERR_WOULDBLOCK if the
+ *         descriptors are busy, ERR_IF on a DMA error
+ */
+static err_t low_level_transmit(struct pbuf *p, uint32_t queue)
+{
+    uint32_t i = 0U;
+    struct pbuf *q = NULL;
+    err_t errval;
+    ETH_BufferTypeDef Txbuffer[ETH_TX_DESC_CNT];
+
+    /* Only the used entries are filled in, the list ends with next == NULL */
+    for(q = p; q != NULL; q = q->next)
+    {
+        if(i >= ETH_TX_DESC_CNT)
+        {
+            return low_level_transmit_copy(p, queue);
+        }
+        Txbuffer[i].buffer = q->payload;
+        Txbuffer[i].len = q->len;
+        Txbuffer[i].next = NULL;
+        if (i > 0)
+        {
+            Txbuffer[i-1].next = &Txbuffer[i];
+        }
+
+        i++;
+    }
+    errval = low_level_send(Txbuffer, p, queue);
+    if (errval == ERR_OK)
+    {
+        EthStats.tx_zero_copy++;
+    }
+
+    return errval;
+}
+
+/**
+ * Pick the TX queue of a frame. A tagged frame goes by its PCP, an untagged
+ * one by its EtherType class, then by the DSCP of IPv4 and IPv6. The upper
+ * half of the PCP or DSCP range takes the higher queues, spread evenly.
+ * ARP goes first, everything else is bulk.
+ *
+ * @param p the MAC packet to send
+ * @return the TX queue, 0 is served first
+ */
+static uint32_t low_level_tx_class(struct pbuf *p)
+{
+    const uint8_t *frame = (const uint8_t *)p->payload;
+    uint16_t type;
+    uint32_t dscp;
+    uint32_t i;
+
+    if ((ETH_TX_PRIO_CNT == 1U) || (p->len < SIZEOF_ETH_HDR + 2U))
+    {
+        return ETH_TX_BULK;
+    }
+    type = *(const uint16_t *)&frame[12];
+    if (type == PP_HTONS(ETHTYPE_VLAN))
+    {
+        /* PCP 7 is the highest */
+        return ((7U - (frame[14] >> 5)) * ETH_TX_PRIO_CNT) / 8U;
+    }
+    for (i = 0U; i < TxClassCnt; i++)
+    {
+        if (TxClass[i].type == type)
+        {
+            return TxClass[i].queue;
+        }
+    }
+    if (type == PP_HTONS(ETHTYPE_IP))
+    {
+        dscp = frame[SIZEOF_ETH_HDR + 1U] >> 2;
+    }
+    else if (type == PP_HTONS(ETHTYPE_IPV6))
+    {
+        dscp = ((frame[SIZEOF_ETH_HDR] & 0x0FU) << 2) | (frame[SIZEOF_ETH_HDR + 1U] >> 6);
+    }
+    else if (type == PP_HTONS(ETHTYPE_ARP))
+    {
+        return 0U;
+    }
+    else
+    {
+        return ETH_TX_BULK;
+    }
+
+    return ((63U - dscp) * ETH_TX_PRIO_CNT) / 64U;
+}
+
+/**
+ * Check if a frame of the bulk queue fits under the ring byte limit. The
+ * first bulk frame always goes, so a frame longer than the limit still does.
+ *
+ * @param len the frame length
+ * @return 1 if the frame may go to the DMA, 0 if it has to wait
+ */
+static uint8_t low_level_tx_bulk_room(uint32_t len)
+{
+    if ((ETH_TX_PRIO_CNT == 1U) || (TxBulkLimit == 0U) || (TxBulkBytes == 0U))
+    {
+        return 1U;
+    }
+
+    return (uint8_t)((TxBulkBytes + len) <= TxBulkLimit);
+}
+
+/**
+ * Reclaim the transmitted descriptors and move the queued frames to the
+ * DMA until the descriptors are busy again. The queues are served in
+ * strict priority, a lower queue only goes once the higher ones are empty.
+ */
+static void low_level_tx_flush(void)
+{
+    struct pbuf *p;
+    uint32_t q;
+    uint32_t head;
+    uint32_t wait;
+    err_t err;
+
+    (void)eth_tx_reclaim();
+    for (q = 0U; (q < ETH_TX_PRIO_CNT) && (TxQueueCnt != 0U); q++)
+    {
+        while (TxQueueLen[q] != 0U)
+        {
+            head = TxQueueHead[q];
+            p = TxQueue[q][head];
+            if ((q == ETH_TX_BULK) && (low_level_tx_bulk_room(p->tot_len) == 0U))
+            {
+                /* The TX complete of a bulk frame makes room */
+                return;
+            }
+            err = low_level_transmit(p, q);
+            if (err == ERR_WOULDBLOCK)
+            {
+                /* The lower queues wait for the descriptors as well */
+                return;
+            }
+            if (err == ERR_OK)
+            {
+                wait = (trace_get_tick() - TxQueueTick[q][head]) / TxTickPerUs;
+                EthStats.tx_prio[q].wait_sum_us += wait;
+                if (wait > EthStats.tx_prio[q].wait_max_us)
+                {
+                    EthStats.tx_prio[q].wait_max_us = wait;
+                }
+            }
+
+            /* The DMA holds its own reference, drop the queue one */
+            pbuf_free(p);
+            TxQueue[q][head] = NULL;
+            TxQueueHead[q] = (head + 1U) % ETH_TX_QUEUE_LEN;
+            TxQueueLen[q]--;
+            TxQueueCnt--;
+        }
+    }
+}
+
+/**
+ * Send a frame, or queue it behind the frames of its priority waiting for
+ * the TX descriptors.
+ *
+ * @param p the MAC packet to send
+ * @return ERR_OK if the packet was sent or queued, ERR_MEM if its TX queue is full,
+ *         or ERR_IF if the packet was unable to be sent
+ */
+static err_t low_level_output_frame(struct pbuf *p)
+{
+    err_t errval;
+    uint32_t queue;
+    uint32_t idx;
+    uint32_t q;
+
+    low_level_tx_flush();
+    queue = low_level_tx_class(p);
+
+    /* Keep the frame order of the queue, only bypass it when it and the
+     * higher queues are empty */
+    for (q = 0U; q <= queue; q++)
+    {
+        if (TxQueueLen[q] != 0U)
+        {
+            break;
+        }
+    }
+    if (q > queue)
+    {
+        if ((queue == ETH_TX_BULK) && (low_level_tx_bulk_room(p->tot_len) == 0U))
+        {
+            EthStats.tx_bulk_held++;
+        }
+        else
+        {
+            errval = low_level_transmit(p, queue);
+            if (errval != ERR_WOULDBLOCK)
+            {
+                return errval;
+            }
+        }
+    }
+    if (TxQueueLen[queue] >= ETH_TX_QUEUE_LEN)
+    {
+        EthStats.tx_queue_full++;
+        EthStats.tx_prio[queue].full++;
+
+        return ERR_MEM;
+    }
+    pbuf_ref(p);
+    idx = (TxQueueHead[queue] + TxQueueLen[queue]) % ETH_TX_QUEUE_LEN;
+    TxQueue[queue][idx] = p;
+    TxQueueTick[queue][idx] = trace_get_tick();
+    TxQueueLen[queue]++;
+    TxQueueCnt++;
+    EthStats.tx_queued++;
+    EthStats.tx_prio[queue].queued++;
+    if (TxQueueCnt > EthStats.tx_queue_max)
+    {
+        EthStats.tx_queue_max = TxQueueCnt;
+    }
+    if (TxQueueLen[queue] > EthStats.tx_prio[queue].depth_max)
+    {
+        EthStats.tx_prio[queue].depth_max = TxQueueLen[queue];
+    }
+
+    return ERR_OK;
+}
+
+/**
+ * This function should do the actual transmission of the packet. The packet is
+ * contained in the pbuf that is passed to the function. This pbuf
+ * might be chained.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
+ * @return ERR_OK if the packet was sent or queued, ERR_MEM if the TX queue is full,
+ *         or ERR_IF if the packet was unable to be sent
+ *
+ * @note ERR_OK means the packet was sent (but not necessarily transmit complete),
+ * and ERR_IF means the packet has more chained buffers than what the interface supports.
+ * The frames are queued while the TX descriptors are busy and ERR_MEM tells lwIP
+ * to back off when the queue is full.
+ */
+static err_t low_level_output(struct netif *netif, struct pbuf *p)
+{
+    err_t errval;
+    TRACE_BEGIN(TRACE_PROBE_LOW_LEVEL_OUTPUT);
+
+    LWIP_UNUSED_ARG(netif);
+    if (CaptureTap != NULL)
+    {
+        CaptureTap(p, ETH_TAP_TX);
+    }
+    errval = low_level_output_frame(p);
+    TRACE_END(TRACE_PROBE_LOW_LEVEL_OUTPUT);
+
+    return errval;
+}
+
+/**
+  * @brief Should allocate a pbuf and transfer the bytes of the incoming
+  * packet from the interface into the pbuf.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @return a pbuf filled with the received packet (including MAC header)
+  *         NULL on memory error
+  */
+static struct pbuf *low_level_input(struct netif *netif)
+{
+    struct pbuf *p = NULL;
+
+    if(RxAllocStatus == RX_ALLOC_OK)
+    {
+        HAL_ETH_ReadData(eth_get_handle(), (void **)&p);
+    }
+
+    /* HAL_ETH_RxLinkCallback() only keeps the frame length in the head */
+    ethernetif_rx_chain_end(p);
+    
+    return p;
+}
+
+/**
+  * @brief Give a received frame to the fast-path handler of its EtherType.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param p the received frame
+  * @return ERR_OK if a handler took the frame, ERR_VAL if it goes to the stack
+  */
+static err_t low_level_rx_handler(struct netif *netif, struct pbuf *p)
+{
+    const uint16_t *type = (const uint16_t *)((const uint8_t *)p->payload + 12U);
+    uint16_t len = p->tot_len;
+    uint32_t i;
+
+    if (p->len < SIZEOF_ETH_HDR)
+    {
+        return ERR_VAL;
+    }
+    if ((*type == PP_HTONS(ETHTYPE_VLAN)) && (p->len >= SIZEOF_ETH_HDR + SIZEOF_VLAN_HDR))
+    {
+        /* the inner EtherType follows the tag */
+        type += 2;
+    }
+    for (i = 0U; i < RxHandlerCnt; i++)
+    {
+        if (RxHandler[i].type == *type)
+        {
+            if (RxHandler[i].handler(p, netif, RxHandler[i].arg) == ERR_OK)
+            {
+                EthStats.rx_fastpath++;
+                EthStats.rx_fastpath_bytes += len;
+
+                return ERR_OK;
+            }
+            EthStats.rx_fastpath_pass++;
+            break;
+        }
+    }
+
+    return ERR_VAL;
+}
+
+/**
+  * @brief Hand a received frame to the stack. Frames shorter than the
+  * copy-break threshold are copied into a PBUF_RAM pbuf so the RX pool
+  * buffer goes back to the descriptor ring at once. Frames of an EtherType
+  * with a fast-path handler go to the handler instead, without a copy.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param p the received frame
+  */
+static void low_level_deliver(struct netif *netif, struct pbuf *p)
+{
+    struct pbuf *q;
+
+    if (CaptureTap != NULL)
+    {
+        CaptureTap(p, ETH_TAP_RX);
+    }
+    if (LinkTrafficWait != 0U)
+    {
+        /* First frame since the link came up */
+        LinkTrafficWait = 0U;
+        EthStats.link_traffic_ms = HAL_GetTick() - LinkUpTick;
+    }
+    if ((RxHandlerCnt != 0U) && (low_level_rx_handler(netif, p) == ERR_OK))
+    {
+        return;
+    }
+    if (p->tot_len < RxCopyBreak)
+    {
+        q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+        if (q != NULL)
+        {
+            (void)pbuf_copy(q, p);
+            pbuf_free(p);
+            p = q;
+            EthStats.rx_copybreak++;
+        }
+        else
+        {
+            /* Keep the zero-copy buffer when the heap is short */
+            EthStats.rx_copybreak_fail++;
+        }
+    }
+    EthStats.rx_frames++;
+    EthStats.rx_bytes += p->tot_len;
+    if (netif->input(p, netif) != ERR_OK)
+    {
+        EthStats.rx_drop_stack++;
+        pbuf_free(p);
+    }
+}
+
+/**
+ * This task should be signaled when a receive packet is ready to be read
+ * from the interface.
+ *
+ * @param argument the lwip network interface structure for this ethernetif
+ */
+void ethernetif_input(struct netif *netif)
+{
+  struct pbuf *p = NULL;
+    TRACE_BEGIN(TRACE_PROBE_ETHERNETIF_INPUT);
+
+    do
+    {
+        p = low_level_input(netif);
+        if (p != NULL)
+        {
+            low_level_deliver(netif, p);
+        }
+    } while(p!=NULL);
+    TRACE_END(TRACE_PROBE_ETHERNETIF_INPUT);
+}
+
+/**
+  * @brief This function should be called from the ETH RX complete interrupt.
+  * With mitigation enabled the RX interrupt is masked and the frames are left
+  * in the descriptor ring for ethernetif_poll(), otherwise the ring is drained
+  * at once by ethernetif_input().
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  */
+void ethernetif_rx_irq(struct netif *netif)
+{
+    EthStats.rx_irq++;
+    if (RxMitigation != 0U)
+    {
+        /* Mask the RX interrupt until the ring has been drained */
+        __HAL_ETH_DMA_DISABLE_IT(eth_get_handle(), ETH_DMAIER_RIE);
+        RxPending = 1U;
+    }
+    else
+    {
+        ethernetif_input(netif);
+    }
+}
+
+/**
+  * @brief Read at most the poll budget of frames from the RX descriptor ring.
+  * The RX interrupt is unmasked again once the ring is found empty.
+  * Should be called from the main loop.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @return 1 if frames are still pending, 0 if the ring is empty
+  */
+uint8_t ethernetif_poll(struct netif *netif)
+{
+    struct pbuf *p = NULL;
+    uint32_t cnt;
+
+    /* Give the transmitted frames back and send the queued ones */
+    if ((TxReclaim != 0U) || (TxQueueCnt != 0U))
+    {
+        TxReclaim = 0U;
+        low_level_tx_flush();
+    }
+
+    /* Stall detector: the pool stays empty because lwIP holds the buffers */
+    if ((RxAllocStatus == RX_ALLOC_ERROR) && (HAL_GetTick() - RxAllocErrorTick >= ETH_RX_STALL_MS))
+    {
+        RxAllocErrorTick = HAL_GetTick();
+        EthStats.rx_stall++;
+    }
+
+    /* Buffers came back to an exhausted pool or the DMA ran out of
+     * descriptors, read the ring in polling mode to rebuild them */
+    if (RxRefill != 0U)
+    {
+        RxRefill = 0U;
+        EthStats.rx_refill++;
+        __HAL_ETH_DMA_DISABLE_IT(eth_get_handle(), ETH_DMAIER_RIE);
+        RxPending = 1U;
+    }
+
+    /* Keep the link partner paused while the RX pool is low, resume it
+     * with a zero quanta PAUSE frame once enough buffers came back */
+    if (TxPauseActive != 0U)
+    {
+        if ((ETH_RX_BUFFER_CNT - RxPoolInUse) >= ETH_RX_RESUME_WATER)
+        {
+            if (eth_send_pause(0U) == 0U)
+            {
+                TxPauseActive = 0U;
+                EthStats.pause_resume_frames++;
+            }
+        }
+        else if (HAL_GetTick() - TxPauseTick >= TxPauseRefreshMs)
+        {
+            low_level_pause();
+        }
+    }
+
+    if (RxPending == 0U)
+    {
+        return 0;
+    }
+    EthStats.rx_poll++;
+
+    /* Clear the RX status before reading, frames received from now on
+     * raise the interrupt again once it is unmasked */
+    __HAL_ETH_DMA_CLEAR_IT(eth_get_handle(), ETH_DMASR_RS | ETH_DMASR_NIS);
+    for (cnt = 0U; cnt < RxPollBudget; cnt++)
+    {
+        p = low_level_input(netif);
+        if (p == NULL)
+        {
+            break;
+        }
+        low_level_deliver(netif, p);
+    }
+    if (cnt < RxPollBudget)
+    {
+        /* Ring is empty, back to interrupt mode */
+        RxPending = 0U;
+        __HAL_ETH_DMA_ENABLE_IT(eth_get_handle(), ETH_DMAIER_RIE);
+
+        return 0;
+    }
+    EthStats.rx_poll_exhausted++;
+
+    return 1;
+}
+
+/**
+  * @brief This function should be called from the ETH TX complete interrupt.
+  * The descriptors are reclaimed by the next ethernetif_poll() pass.
+  */
+void ethernetif_tx_irq(void)
+{
+    TxReclaim = 1U;
+}
+
+/**
+  * @brief This function should be called from the ETH DMA error interrupt.
+  * A receive buffer unavailable error means the DMA owns no RX descriptor,
+  * the next ethernetif_poll() pass tries to rebuild them.
+  *
+  * @param dma_error the DMA error code of the ETH handle
+  */
+void ethernetif_error_irq(uint32_t dma_error)
+{
+    if ((dma_error & ETH_DMASR_RBUS) != 0U)
+    {
+        EthStats.rx_ring_empty++;
+        RxRefill = 1U;
+    }
+}
+
+/**
+  * @brief Check if RX frames or TX completions are waiting for ethernetif_poll().
+  * @retval 1 if work is pending, 0 otherwise
+  */
+uint8_t ethernetif_pending(void)
+{
+    return (uint8_t)((RxPending != 0U) || (TxReclaim != 0U) || (RxRefill != 0U));
+}
+
+/**
+  * @brief Get the time until ethernetif_poll() has timed work to do, a PAUSE
+  * refresh or the RX stall check.
+  * @retval milliseconds until the next deadline, 0xFFFFFFFF if there is none
+  */
+uint32_t ethernetif_sleeptime(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t sleep = 0xFFFFFFFFU;
+    uint32_t elapsed;
+
+    if (TxPauseActive != 0U)
+    {
+        elapsed = now - TxPauseTick;
+        sleep = (elapsed < TxPauseRefreshMs) ? (TxPauseRefreshMs - elapsed) : 0U;
+    }
+    if (RxAllocStatus == RX_ALLOC_ERROR)
+    {
+        elapsed = now - RxAllocErrorTick;
+        elapsed = (elapsed < ETH_RX_STALL_MS) ? (ETH_RX_STALL_MS - elapsed) : 0U;
+        if (elapsed < sleep)
+        {
+            sleep = elapsed;
+        }
+    }
+
+    return sleep;
+}
+
+/**
+  * @brief Enable or disable the PHY near end loopback. The PHY is forced to
+  * 100Mbps full duplex and the MAC is started even without a link, so the
+  * transmitted frames come back to the RX path of this interface. Disabling
+  * it takes the link down, the link check negotiates the line again.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param enable 1 to loop the frames back, 0 to use the line
+  * @retval ERR_OK on success, ERR_IF if the PHY refused the setting
+  */
+err_t ethernetif_set_loopback(struct netif *netif, uint8_t enable)
+{
+    ETH_MACConfigTypeDef MACConf = {0};
+
+    if (enable == LoopBack)
+    {
+        return ERR_OK;
+    }
+    if (enable != 0U)
+    {
+        if ((lan8720_basic_force_mode(LAN8720_SPEED_100M, LAN8720_DUPLEX_FULL) != 0) ||
+            (lan8720_basic_loop_back(LAN8720_BOOL_TRUE) != 0))
+        {
+            return ERR_IF;
+        }
+        LoopBack = 1U;
+
+        /* No flow control, a PAUSE frame would only stop this MAC */
+        TxPauseEnable = 0U;
+        TxPauseActive = 0U;
+        HAL_ETH_GetMACConfig(eth_get_handle(), &MACConf);
+        MACConf.DuplexMode = ETH_FULLDUPLEX_MODE;
+        MACConf.Speed = ETH_SPEED_100M;
+        MACConf.TransmitFlowControl = DISABLE;
+        MACConf.ReceiveFlowControl = DISABLE;
+        HAL_ETH_SetMACConfig(eth_get_handle(), &MACConf);
+        if (!netif_is_link_up(netif))
+        {
+            HAL_ETH_Start_IT(eth_get_handle());
+        }
+
+        return ERR_OK;
+    }
 
-static uint8_t gs_addr = 0x01;
+    (void)lan8720_basic_loop_back(LAN8720_BOOL_FALSE);
+    LoopBack = 0U;
+#if ETH_DUPLEX_FORCE_MODE != 0U
+    if (DuplexForced != 0U)
+    {
+        /* Put the forced mode back, the link check only waits for the link */
+        (void)lan8720_basic_force_mode((ETH_DUPLEX_FORCE_MODE & 0x02U) ? LAN8720_SPEED_100M : LAN8720_SPEED_10M,
+                                       (ETH_DUPLEX_FORCE_MODE & 0x04U) ? LAN8720_DUPLEX_FULL : LAN8720_DUPLEX_HALF);
+    }
+#endif
+    HAL_ETH_Stop_IT(eth_get_handle());
+    if (netif_is_link_up(netif))
+    {
+        netif_set_link_down(netif);
+    }
 
-/**
- * @brief     set phy address
- * @param[in] addr device address
- * @note      none
- */
-void eth_set_address(uint8_t addr)
-{
-    gs_addr = addr;
+    return ERR_OK;
 }
 
-/* Private functions ---------------------------------------------------------*/
-/*******************************************************************************
-                       LL Driver Interface ( LwIP stack --> ETH)
-*******************************************************************************/
 /**
-  * @brief In this function, the hardware should be initialized.
-  * Called from ethernetif_init().
+  * @brief Register a fast-path handler for an EtherType. Its frames skip the
+  * copy-break and netif->input and go straight from the RX drain loop to the
+  * handler, in ethernetif_poll() or, with the mitigation off, in the RX
+  * interrupt. A 802.1Q tagged frame is matched on its inner EtherType.
+  * Registering a type again replaces its handler.
   *
-  * @param netif the already initialized lwip network interface structure
-  *        for this ethernetif
+  * @param type the EtherType in host order
+  * @param handler the handler
+  * @param arg the handler argument
+  * @retval ERR_OK on success, ERR_ARG on a NULL handler, ERR_MEM if the table is full
   */
-static void low_level_init(struct netif *netif)
+err_t ethernetif_add_rx_handler(uint16_t type, ethernetif_rx_handler_t handler, void *arg)
 {
-    uint8_t mac[6] = {MAC_ADDR0, MAC_ADDR1, MAC_ADDR2, MAC_ADDR3, MAC_ADDR4, MAC_ADDR5};
-    
-    eth_init(mac);
-
-    /* set MAC hardware address length */
-    netif->hwaddr_len = ETH_HWADDR_LEN;
-
-    /* set MAC hardware address */
-    netif->hwaddr[0] =  MAC_ADDR0;
-    netif->hwaddr[1] =  MAC_ADDR1;
-    netif->hwaddr[2] =  MAC_ADDR2;
-    netif->hwaddr[3] =  MAC_ADDR3;
-    netif->hwaddr[4] =  MAC_ADDR4;
-    netif->hwaddr[5] =  MAC_ADDR5;
+    uint32_t i;
+    uint32_t rie;
 
-    /* maximum transfer unit */
-    netif->mtu = ETH_MAX_PAYLOAD;
+    if (handler == NULL)
+    {
+        return ERR_ARG;
+    }
+    for (i = 0U; i < RxHandlerCnt; i++)
+    {
+        if (RxHandler[i].type == lwip_htons(type))
+        {
+            break;
+        }
+    }
+    if (i == ETH_RX_HANDLER_CNT)
+    {
+        return ERR_MEM;
+    }
 
-    /* device capabilities */
-    /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
-    netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
+    /* The drain loop may run in the RX interrupt, keep it out while the entry changes */
+    rie = eth_get_handle()->Instance->DMAIER & ETH_DMAIER_RIE;
+    __HAL_ETH_DMA_DISABLE_IT(eth_get_handle(), ETH_DMAIER_RIE);
+    RxHandler[i].type = lwip_htons(type);
+    RxHandler[i].handler = handler;
+    RxHandler[i].arg = arg;
+    if (i == RxHandlerCnt)
+    {
+        RxHandlerCnt++;
+    }
+    __HAL_ETH_DMA_ENABLE_IT(eth_get_handle(), rie);
 
-    /* Initialize the RX POOL */
-    LWIP_MEMPOOL_INIT(RX_POOL);
-    
-    (void)lan8720_basic_init(gs_addr);
-    
-    ethernet_link_check_state(netif);
+    return ERR_OK;
 }
 
 /**
- * This function should do the actual transmission of the packet. The packet is
- * contained in the pbuf that is passed to the function. This pbuf
- * might be chained.
- *
- * @param netif the lwip network interface structure for this ethernetif
- * @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
- * @return ERR_OK if the packet was sent, or ERR_IF if the packet was unable to be sent
- *
- * @note ERR_OK means the packet was sent (but not necessarily transmit complete),
- * and ERR_IF means the packet has more chained buffers than what the interface supports.
- */
-static err_t low_level_output(struct netif *netif, struct pbuf *p)
+  * @brief Remove the fast-path handler of an EtherType, its frames go to the
+  * stack again.
+  *
+  * @param type the EtherType in host order
+  * @retval ERR_OK on success, ERR_VAL if no handler is registered for it
+  */
+err_t ethernetif_remove_rx_handler(uint16_t type)
 {
-    uint32_t i = 0U;
-    struct pbuf *q = NULL;
-    err_t errval = ERR_OK;
-    ETH_BufferTypeDef Txbuffer[ETH_TX_DESC_CNT] = {0};
+    uint32_t i;
+    uint32_t rie;
 
-    memset(Txbuffer, 0 , ETH_TX_DESC_CNT * sizeof(ETH_BufferTypeDef));
-    for(q = p; q != NULL; q = q->next)
+    for (i = 0U; i < RxHandlerCnt; i++)
     {
-        if(i >= ETH_TX_DESC_CNT)
-        {
-            return ERR_IF;
-        }
-        Txbuffer[i].buffer = q->payload;
-        Txbuffer[i].len = q->len;
-        if (i > 0)
+        if (RxHandler[i].type == lwip_htons(type))
         {
-            Txbuffer[i-1].next = &Txbuffer[i];
+            break;
         }
-        if (q->next == NULL)
+    }
+    if (i == RxHandlerCnt)
+    {
+        return ERR_VAL;
+    }
+
+    /* Keep the table packed, the last entry takes the free slot */
+    rie = eth_get_handle()->Instance->DMAIER & ETH_DMAIER_RIE;
+    __HAL_ETH_DMA_DISABLE_IT(eth_get_handle(), ETH_DMAIER_RIE);
+    RxHandlerCnt--;
+    RxHandler[i] = RxHandler[RxHandlerCnt];
+    __HAL_ETH_DMA_ENABLE_IT(eth_get_handle(), rie);
+
+    return ERR_OK;
+}
+
+/**
+  * @brief Send the frames of an EtherType to a TX queue. Untagged frames are
+  * looked up by EtherType first, tagged frames go by their PCP.
+  *
+  * @param type the EtherType in host order
+  * @param queue the TX queue, 0 is served first
+  * @retval ERR_OK on success, ERR_ARG on an invalid queue, ERR_MEM if the table is full
+  */
+err_t ethernetif_set_tx_class(uint16_t type, uint32_t queue)
+{
+    uint32_t i;
+
+    if (queue >= ETH_TX_PRIO_CNT)
+    {
+        return ERR_ARG;
+    }
+    for (i = 0U; i < TxClassCnt; i++)
+    {
+        if (TxClass[i].type == lwip_htons(type))
         {
-            Txbuffer[i].next = NULL;
+            break;
         }
+    }
+    if (i == ETH_TX_CLASS_CNT)
+    {
+        return ERR_MEM;
+    }
+    TxClass[i].type = lwip_htons(type);
+    TxClass[i].queue = (uint8_t)queue;
+    if (i == TxClassCnt)
+    {
+        TxClassCnt++;
+    }
 
-        i++;
+    return ERR_OK;
+}
+
+/**
+  * @brief Set the bytes of bulk frames the TX descriptors may hold. A bulk
+  * frame waits in its queue while the limit is reached, so a higher priority
+  * frame waits for at most that many bytes on the wire.
+  *
+  * @param bytes the limit, 0 disables it
+  */
+void ethernetif_set_tx_bulk_limit(uint32_t bytes)
+{
+    TxBulkLimit = bytes;
+}
+
+/**
+  * @brief Set the capture tap. It sees every received frame, every frame
+  * given to low_level_output and the link loss. Without a tap each frame
+  * costs one test.
+  *
+  * @param tap the tap, NULL removes it
+  */
+void ethernetif_set_tap(ethernetif_tap_t tap)
+{
+    CaptureTap = tap;
+}
+
+/**
+  * @brief Configure the RX interrupt mitigation.
+  *
+  * @param enable 1 to poll from the main loop, 0 to drain the ring in the interrupt
+  * @param budget maximum number of frames read per ethernetif_poll() pass
+  */
+void ethernetif_set_rx_mitigation(uint8_t enable, uint32_t budget)
+{
+    RxMitigation = enable;
+    RxPollBudget = (budget != 0U) ? budget : 1U;
+}
+
+/**
+  * @brief Set the RX copy-break threshold.
+  *
+  * @param len frames shorter than len bytes are copied, 0 disables the copy
+  */
+void ethernetif_set_rx_copybreak(uint32_t len)
+{
+    RxCopyBreak = len;
+}
+
+/**
+  * @brief Clear the interface statistics, the MMC, missed frame and symbol
+  * error counters restart from now. The link, pause, duplex, multicast and
+  * flap state is kept, and the high-water marks restart from the current
+  * levels.
+  */
+void ethernetif_reset_stats(void)
+{
+    ethernetif_stats_t keep = EthStats;
+    uint32_t i;
+    uint32_t no_buffer;
+    uint32_t overflow;
+
+    /* Restart the free running counters from now */
+    (void)eth_get_rx_missed(&no_buffer, &overflow);
+    (void)eth_get_mmc(&StatsMmc);
+    (void)lan8720_basic_symbol_error_counter(&PhySymbolErrors);
+    memset(&EthStats, 0, sizeof(EthStats));
+
+    /* Keep the state, the high-water marks restart from the current levels */
+    EthStats.rx_pool_max = RxPoolInUse;
+    EthStats.tx_ring_max = eth_get_tx_in_use();
+    EthStats.tx_queue_max = TxQueueCnt;
+    for (i = 0U; i < ETH_TX_PRIO_CNT; i++)
+    {
+        EthStats.tx_prio[i].depth_max = TxQueueLen[i];
     }
-    pbuf_ref(p);
-    if (eth_write(Txbuffer, p, p->tot_len) != 0)
+    EthStats.pause_tx_enabled = keep.pause_tx_enabled;
+    EthStats.pause_rx_enabled = keep.pause_rx_enabled;
+    EthStats.duplex_half = keep.duplex_half;
+    EthStats.duplex_parallel_detect = keep.duplex_parallel_detect;
+    EthStats.duplex_mismatch = keep.duplex_mismatch;
+    EthStats.duplex_forced = keep.duplex_forced;
+    EthStats.mcast_groups = keep.mcast_groups;
+    EthStats.mcast_overflow = keep.mcast_overflow;
+    EthStats.flap_penalty = keep.flap_penalty;
+    EthStats.flap_held = keep.flap_held;
+}
+
+/**
+  * @brief Append a received buffer to the frame in O(1). Only the head keeps
+  * the running frame length, ethernetif_rx_chain_end() gives the other
+  * segments their tot_len once the frame is complete.
+  *
+  * @param start the first pbuf of the frame, NULL for a new frame
+  * @param end the last pbuf of the frame
+  * @param p the pbuf of the received buffer
+  * @param len the bytes in the buffer
+  */
+void ethernetif_rx_chain_add(struct pbuf **start, struct pbuf **end, struct pbuf *p, uint16_t len)
+{
+    p->next = NULL;
+    p->tot_len = len;
+    p->len = len;
+
+    /* Chain the buffer. */
+    if (*start == NULL)
+    {
+        /* The first buffer of the packet. */
+        *start = p;
+    }
+    else
     {
-        errval = ERR_TIMEOUT;
+        /* Chain the buffer to the end of the packet, the tail keeps its own length */
+        (*end)->next = p;
+        (*start)->tot_len += len;
     }
-    
-    return errval;
+    *end = p;
 }
 
 /**
-  * @brief Should allocate a pbuf and transfer the bytes of the incoming
-  * packet from the interface into the pbuf.
+  * @brief Give every segment of a complete frame its tot_len in one pass.
   *
-  * @param netif the lwip network interface structure for this ethernetif
-  * @return a pbuf filled with the received packet (including MAC header)
-  *         NULL on memory error
+  * @param p the first pbuf of the frame, or NULL
   */
-static struct pbuf *low_level_input(struct netif *netif)
+void ethernetif_rx_chain_end(struct pbuf *p)
 {
-    struct pbuf *p = NULL;
+    struct pbuf *q;
+    uint16_t len;
 
-    if(RxAllocStatus == RX_ALLOC_OK)
+    /* A single segment frame is already complete */
+    if ((p == NULL) || (p->next == NULL))
     {
-        HAL_ETH_ReadData(eth_get_handle(), (void **)&p);
+        return;
+    }
+    len = p->tot_len;
+    for (q = p; q != NULL; q = q->next)
+    {
+        q->tot_len = len;
+        len -= q->len;
     }
-    
-    return p;
 }
 
 /**
- * This task should be signaled when a receive packet is ready to be read
- * from the interface.
- *
- * @param argument the lwip network interface structure for this ethernetif
- */
-void ethernetif_input(struct netif *netif)
+  * @brief Get the interface statistics.
+  * @retval pointer to the statistics block
+  */
+const ethernetif_stats_t *ethernetif_get_stats(void)
 {
-  struct pbuf *p = NULL;
+    eth_mmc_t mmc;
+    uint32_t i;
+    uint32_t no_buffer;
+    uint32_t overflow;
 
-    do
+    (void)eth_get_rx_missed(&no_buffer, &overflow);
+    EthStats.rx_drop_no_buffer += no_buffer;
+    EthStats.rx_drop_overflow += overflow;
+    EthStats.rx_pool_in_use = RxPoolInUse;
+    EthStats.tx_ring_in_use = eth_get_tx_in_use();
+    EthStats.tx_queue_depth = TxQueueCnt;
+    EthStats.tx_bulk_ring_bytes = TxBulkBytes;
+    for (i = 0U; i < ETH_TX_PRIO_CNT; i++)
     {
-        p = low_level_input(netif);
-        if (p != NULL)
-        {
-            if (netif->input(p, netif) != ERR_OK)
-            {
-                pbuf_free(p);
-            }
-        }
-    } while(p!=NULL);
+        EthStats.tx_prio[i].depth = TxQueueLen[i];
+    }
+    (void)eth_get_mmc(&mmc);
+    EthStats.mmc_tx_good = mmc.tx_good - StatsMmc.tx_good;
+    EthStats.mmc_tx_collisions = (mmc.tx_single_collision - StatsMmc.tx_single_collision) +
+                                 (mmc.tx_multiple_collision - StatsMmc.tx_multiple_collision);
+    EthStats.mmc_rx_good_unicast = mmc.rx_good_unicast - StatsMmc.rx_good_unicast;
+    EthStats.mmc_rx_crc_errors = mmc.rx_crc_error - StatsMmc.rx_crc_error;
+    EthStats.mmc_rx_alignment_errors = mmc.rx_alignment_error - StatsMmc.rx_alignment_error;
+    low_level_phy_stats();
+    low_level_flap_decay();
+
+    return &EthStats;
 }
 
 /**
@@ -251,14 +1592,26 @@ void pbuf_free_custom(struct pbuf *p)
 {
     struct pbuf_custom* custom_pbuf = (struct pbuf_custom*)p;
     LWIP_MEMPOOL_FREE(RX_POOL, custom_pbuf);
-    /* If the Rx Buffer Pool was exhausted, signal the ethernetif_input task to
-     * call HAL_ETH_GetRxDataBuffer to rebuild the Rx descriptors. */
+    RxPoolInUse--;
+    /* If the Rx Buffer Pool was exhausted, signal ethernetif_poll() to
+     * call HAL_ETH_ReadData which rebuilds the Rx descriptors. */
     if (RxAllocStatus == RX_ALLOC_ERROR)
     {
         RxAllocStatus = RX_ALLOC_OK;
+        RxRefill = 1U;
     }
 }
 
+/**
+  * @brief  TX bounce pbuf free callback
+  * @param  pbuf: pbuf to be freed
+  * @retval None
+  */
+static void pbuf_free_tx_bounce(struct pbuf *p)
+{
+    LWIP_MEMPOOL_FREE(TX_POOL, p);
+}
+
 /**
   * @brief  Returns the current time in milliseconds
   *         when LWIP_TIMERS == 1 and NO_SYS == 1
@@ -278,10 +1631,83 @@ void ethernet_link_check_state(struct netif *netif)
 {
     ETH_MACConfigTypeDef MACConf = {0};
     lan8720_speed_indication_t speed_indication;
+    lan8720_bool_t tx_pause, rx_pause, an_done;
+    lan8720_link_t link;
     uint32_t linkchanged = 0U, speed = 0U, duplex =0U;
     
-    /* check auto negotiation */
-    if (lan8720_basic_auto_negotiation(&speed_indication) != 0)
+    if (LoopBack != 0U)
+    {
+        /* The line is checked again once the loopback ends */
+        return;
+    }
+
+    if (netif_is_link_up(netif))
+    {
+        /* Look for a link loss, the link status bit latches low */
+        if (lan8720_basic_link_status(&link) != 0)
+        {
+            return;
+        }
+        if (link == LAN8720_LINK_DOWN)
+        {
+            EthStats.link_down++;
+            LinkLost = 1U;
+            LinkDownTick = HAL_GetTick();
+            LinkTrafficWait = 0U;
+#if ETH_FLAP_HALF_LIFE_MS != 0U
+            /* Every loss adds to the penalty, a flapping link is held down */
+            low_level_flap_decay();
+            FlapPenalty += ETH_FLAP_PENALTY;
+            EthStats.flap_penalty = FlapPenalty;
+            if ((FlapPenalty >= ETH_FLAP_SUPPRESS) && (FlapHeld == 0U))
+            {
+                FlapHeld = 1U;
+                EthStats.flap_held = 1U;
+                EthStats.flap_suppressed++;
+            }
+#endif
+            TxPauseActive = 0U;
+            if (CaptureTap != NULL)
+            {
+                CaptureTap(NULL, ETH_TAP_LINK_DOWN);
+            }
+            HAL_ETH_Stop_IT(eth_get_handle());
+            netif_set_link_down(netif);
+        }
+        else
+        {
+            low_level_duplex_check(netif);
+        }
+
+        return;
+    }
+
+    if (FlapHeld != 0U)
+    {
+        /* Keep a dampened link down until the penalty decays */
+        low_level_flap_decay();
+        if (FlapPenalty > ETH_FLAP_REUSE)
+        {
+            return;
+        }
+        FlapHeld = 0U;
+        EthStats.flap_held = 0U;
+    }
+
+    /* The link status bit latches low, the second read gives the current line */
+    if ((lan8720_basic_link_status(&link) != 0) || (lan8720_basic_link_status(&link) != 0) ||
+        (link != LAN8720_LINK_UP))
+    {
+        return;
+    }
+    if (DuplexForced != 0U)
+    {
+        /* forced mode, the link is enough */
+        speed_indication = (lan8720_speed_indication_t)ETH_DUPLEX_FORCE_MODE;
+    }
+    /* check auto negotiation, the speed is only read once it has completed */
+    else if ((lan8720_basic_auto_negotiation_poll(&an_done, &speed_indication) != 0) ||
+             (an_done != LAN8720_BOOL_TRUE))
     {
         return;
     }
@@ -315,23 +1741,77 @@ void ethernet_link_check_state(struct netif *netif)
         }
         if (linkchanged)
         {
+            /* Resolve the negotiated pause, flow control is full duplex only and needs a negotiation,
+               a forced link keeps the stale partner ability of the last one */
+            tx_pause = LAN8720_BOOL_FALSE;
+            rx_pause = LAN8720_BOOL_FALSE;
+            if ((duplex == ETH_FULLDUPLEX_MODE) && (DuplexForced == 0U))
+            {
+                if (lan8720_basic_pause_resolve(&tx_pause, &rx_pause) != 0)
+                {
+                    tx_pause = LAN8720_BOOL_FALSE;
+                    rx_pause = LAN8720_BOOL_FALSE;
+                }
+            }
+            TxPauseEnable = (tx_pause == LAN8720_BOOL_TRUE) ? 1U : 0U;
+            TxPauseActive = 0U;
+            /* Refresh the pause at half of its length, one slot is 512 bit times */
+            TxPauseRefreshMs = (ETH_PAUSE_TIME * 512U) / ((speed == ETH_SPEED_100M) ? 100000U : 10000U) / 2U;
+            EthStats.pause_tx_enabled = TxPauseEnable;
+            EthStats.pause_rx_enabled = (rx_pause == LAN8720_BOOL_TRUE) ? 1U : 0U;
+
+            /* Restart the duplex mismatch detector */
+            LinkDuplex = duplex;
+            DuplexSuspect = 0U;
+            DuplexCheckTick = HAL_GetTick();
+            (void)eth_get_mmc(&DuplexMmc);
+            EthStats.duplex_half = (duplex == ETH_HALFDUPLEX_MODE) ? 1U : 0U;
+            EthStats.duplex_mismatch = 0U;
+
             /* Get MAC Config MAC */
             HAL_ETH_GetMACConfig(eth_get_handle(), &MACConf);
             MACConf.DuplexMode = duplex;
             MACConf.Speed = speed;
+            MACConf.TransmitFlowControl = (tx_pause == LAN8720_BOOL_TRUE) ? ENABLE : DISABLE;
+            MACConf.ReceiveFlowControl = (rx_pause == LAN8720_BOOL_TRUE) ? ENABLE : DISABLE;
+            MACConf.PauseTime = ETH_PAUSE_TIME;
+            MACConf.ZeroQuantaPause = DISABLE;
+            MACConf.UnicastPausePacketDetect = DISABLE;
             HAL_ETH_SetMACConfig(eth_get_handle(), &MACConf);
             HAL_ETH_Start_IT(eth_get_handle());
             netif_set_up(netif);
+            LinkUpTick = HAL_GetTick();
+            LinkTrafficWait = 1U;
+            if (LinkLost != 0U)
+            {
+                EthStats.link_outage_ms = LinkUpTick - LinkDownTick;
+            }
             netif_set_link_up(netif);
+            EthStats.link_up++;
         }
     }
 }
 
 void HAL_ETH_RxAllocateCallback(uint8_t **buff)
 {
+    TRACE_BEGIN(TRACE_PROBE_RX_ALLOCATE);
     struct pbuf_custom *p = LWIP_MEMPOOL_ALLOC(RX_POOL);
     if (p)
     {
+        RxPoolInUse++;
+        if (RxPoolInUse > EthStats.rx_pool_max)
+        {
+            EthStats.rx_pool_max = RxPoolInUse;
+        }
+        if ((ETH_RX_BUFFER_CNT - RxPoolInUse) == ETH_RX_POOL_LOW_WATER)
+        {
+            EthStats.rx_pool_low++;
+        }
+        if ((TxPauseEnable != 0U) && (TxPauseActive == 0U) &&
+            ((ETH_RX_BUFFER_CNT - RxPoolInUse) <= ETH_RX_PAUSE_WATER))
+        {
+            low_level_pause();
+        }
         /* Get the buff from the struct pbuf address. */
         *buff = (uint8_t *)p + offsetof(RxBuff_t, buff);
         p->custom_free_function = pbuf_free_custom;
@@ -342,45 +1822,44 @@ void HAL_ETH_RxAllocateCallback(uint8_t **buff)
     }
     else
     {
+        if (RxAllocStatus == RX_ALLOC_OK)
+        {
+            RxAllocErrorTick = HAL_GetTick();
+            EthStats.rx_pool_empty++;
+        }
         RxAllocStatus = RX_ALLOC_ERROR;
         *buff = NULL;
     }
+    TRACE_END(TRACE_PROBE_RX_ALLOCATE);
 }
 
 void HAL_ETH_RxLinkCallback(void **pStart, void **pEnd, uint8_t *buff, uint16_t Length)
 {
-    struct pbuf **ppStart = (struct pbuf **)pStart;
-    struct pbuf **ppEnd = (struct pbuf **)pEnd;
     struct pbuf *p = NULL;
+    TRACE_BEGIN(TRACE_PROBE_RX_LINK);
 
     /* Get the struct pbuf from the buff address. */
     p = (struct pbuf *)(buff - offsetof(RxBuff_t, buff));
-    p->next = NULL;
-    p->tot_len = 0;
-    p->len = Length;
-
-    /* Chain the buffer. */
-    if (!*ppStart)
-    {
-        /* The first buffer of the packet. */
-        *ppStart = p;
-    }
-    else
-    {
-        /* Chain the buffer to the end of the packet. */
-        (*ppEnd)->next = p;
-    }
-    *ppEnd = p;
-
-    /* Update the total length of all the buffers of the chain. Each pbuf in the chain should have its tot_len
-    * set to its own length, plus the length of all the following pbufs in the chain. */
-    for (p = *ppStart; p != NULL; p = p->next)
-    {
-        p->tot_len += Length;
-    }
+    ethernetif_rx_chain_add((struct pbuf **)pStart, (struct pbuf **)pEnd, p, Length);
+    TRACE_END(TRACE_PROBE_RX_LINK);
 }
 
 void HAL_ETH_TxFreeCallback(uint32_t * buff)
 {
-    pbuf_free((struct pbuf *)buff);
+    struct pbuf *p = (struct pbuf *)buff;
+    uint32_t i;
+
+    /* A bulk frame leaves the ring, the bulk queue may go on */
+    for (i = 0U; i < TxBulkCnt; i++)
+    {
+        if (TxBulk[i] == p)
+        {
+            TxBulkBytes -= TxBulkLen[i];
+            TxBulkCnt--;
+            TxBulk[i] = TxBulk[TxBulkCnt];
+            TxBulkLen[i] = TxBulkLen[TxBulkCnt];
+            break;
+        }
+    }
+    pbuf_free(p);
 }
@@ -23,7 +23,227 @@
 #include "lwip/err.h"
 #include "lwip/netif.h"
 
+/* Exported constants --------------------------------------------------------*/
+/* ETH_RX_MITIGATION==1: after the first RX interrupt the RX interrupt is
+   masked and the main loop reads up to ETH_RX_POLL_BUDGET frames per
+   ethernetif_poll() pass, the interrupt is unmasked once the ring is empty. */
+#ifndef ETH_RX_MITIGATION
+#define ETH_RX_MITIGATION             1U
+#endif
+
+/* ETH_RX_POLL_BUDGET: the number of frames read per ethernetif_poll() pass */
+#ifndef ETH_RX_POLL_BUDGET
+#define ETH_RX_POLL_BUDGET            8U
+#endif
+
+/* ETH_RX_COPYBREAK: received frames shorter than this are copied into a
+   PBUF_RAM pbuf and their RX pool buffer is recycled at once, 0 disables it */
+#ifndef ETH_RX_COPYBREAK
+#define ETH_RX_COPYBREAK              128U
+#endif
+
+/* ETH_RX_POOL_LOW_WATER: the free RX pool buffers which count as a low-water event */
+#ifndef ETH_RX_POOL_LOW_WATER
+#define ETH_RX_POOL_LOW_WATER         2U
+#endif
+
+/* ETH_RX_STALL_MS: the time the RX pool may stay exhausted before a stall is reported */
+#ifndef ETH_RX_STALL_MS
+#define ETH_RX_STALL_MS               1000U
+#endif
+
+/* ETH_TX_QUEUE_LEN: the number of frames each software TX queue holds while
+   the TX descriptors are busy, low_level_output returns ERR_MEM when it is full */
+#ifndef ETH_TX_QUEUE_LEN
+#define ETH_TX_QUEUE_LEN              8U
+#endif
+
+/* ETH_TX_PRIO_CNT: the number of strict priority TX queues, queue 0 is served
+   first and the last one is the bulk queue,
+   ETH_TX_CLASS_CNT: the number of EtherTypes with a configured TX queue,
+   ETH_TX_BULK_RING_BYTES: the bytes of bulk frames the TX descriptors may hold,
+   0 disables the limit */
+#ifndef ETH_TX_PRIO_CNT
+#define ETH_TX_PRIO_CNT               2U
+#endif
+#ifndef ETH_TX_CLASS_CNT
+#define ETH_TX_CLASS_CNT              4U
+#endif
+#ifndef ETH_TX_BULK_RING_BYTES
+#define ETH_TX_BULK_RING_BYTES        3036U
+#endif
+
+/* ETH_TX_BOUNCE_CNT: the number of TX bounce buffers, a pbuf chain with more
+   segments than TX descriptors is copied into one of them */
+#ifndef ETH_TX_BOUNCE_CNT
+#define ETH_TX_BOUNCE_CNT             2U
+#endif
+
+/* ETH_PAUSE_TIME: the pause time in 512 bit time slots sent to the link
+   partner when the RX pool runs low, about 21ms at 100Mbps */
+#ifndef ETH_PAUSE_TIME
+#define ETH_PAUSE_TIME                0x1000U
+#endif
+
+/* ETH_RX_PAUSE_WATER: the free RX pool buffers which trigger a PAUSE frame,
+   ETH_RX_RESUME_WATER: the free RX pool buffers which resume the link partner */
+#ifndef ETH_RX_PAUSE_WATER
+#define ETH_RX_PAUSE_WATER            2U
+#endif
+#ifndef ETH_RX_RESUME_WATER
+#define ETH_RX_RESUME_WATER           4U
+#endif
+
+/* ETH_DUPLEX_CHECK_MS: the duplex mismatch detector window,
+   ETH_DUPLEX_MISMATCH_WINDOWS: the suspicious windows in a row which flag a mismatch,
+   ETH_DUPLEX_COLLISION_PCT: the TX collision rate of a suspicious half duplex window,
+   ETH_DUPLEX_MIN_FRAMES: the TX frames a half duplex window needs to be judged,
+   ETH_DUPLEX_MIN_ERRORS: the RX CRC and alignment errors of a suspicious full duplex window */
+#ifndef ETH_DUPLEX_CHECK_MS
+#define ETH_DUPLEX_CHECK_MS           1000U
+#endif
+#ifndef ETH_DUPLEX_MISMATCH_WINDOWS
+#define ETH_DUPLEX_MISMATCH_WINDOWS   3U
+#endif
+#ifndef ETH_DUPLEX_COLLISION_PCT
+#define ETH_DUPLEX_COLLISION_PCT      10U
+#endif
+#ifndef ETH_DUPLEX_MIN_FRAMES
+#define ETH_DUPLEX_MIN_FRAMES         50U
+#endif
+#ifndef ETH_DUPLEX_MIN_ERRORS
+#define ETH_DUPLEX_MIN_ERRORS         10U
+#endif
+
+/* ETH_DUPLEX_FORCE_MODE: the lan8720_speed_indication_t mode forced on the PHY
+   once a mismatch is flagged, 0 only reports the mismatch */
+#ifndef ETH_DUPLEX_FORCE_MODE
+#define ETH_DUPLEX_FORCE_MODE         0U
+#endif
+
+/* ETH_FLAP_PENALTY: the penalty added by each link loss,
+   ETH_FLAP_SUPPRESS: the penalty above which a link up is held back,
+   ETH_FLAP_REUSE: the penalty below which a held back link is used again,
+   ETH_FLAP_HALF_LIFE_MS: the time in which the penalty halves, 0 disables the dampening */
+#ifndef ETH_FLAP_PENALTY
+#define ETH_FLAP_PENALTY              1000U
+#endif
+#ifndef ETH_FLAP_SUPPRESS
+#define ETH_FLAP_SUPPRESS             3000U
+#endif
+#ifndef ETH_FLAP_REUSE
+#define ETH_FLAP_REUSE                1500U
+#endif
+#ifndef ETH_FLAP_HALF_LIFE_MS
+#define ETH_FLAP_HALF_LIFE_MS         10000U
+#endif
+
+/* ETH_MCAST_FILTER_CNT: the number of multicast MAC addresses tracked for the
+   hardware filter, the MAC passes all multicast frames once it overflows */
+#ifndef ETH_MCAST_FILTER_CNT
+#define ETH_MCAST_FILTER_CNT          16U
+#endif
+
+/* ETH_RX_HANDLER_CNT: the number of EtherType fast-path handlers */
+#ifndef ETH_RX_HANDLER_CNT
+#define ETH_RX_HANDLER_CNT            4U
+#endif
+
 /* Exported types ------------------------------------------------------------*/
+/* EtherType fast-path handler, p starts at the Ethernet header and is the
+   zero-copy RX pool buffer. ERR_OK means the handler took the frame and frees
+   it, any other value hands the frame to the stack. */
+typedef err_t (*ethernetif_rx_handler_t)(struct pbuf *p, struct netif *netif, void *arg);
+
+/* Capture tap events, p is the frame of ETH_TAP_RX and ETH_TAP_TX and NULL otherwise */
+#define ETH_TAP_RX                    0U        /* a received frame before the fast path and the copy-break */
+#define ETH_TAP_TX                    1U        /* a frame given to low_level_output */
+#define ETH_TAP_LINK_DOWN             2U        /* the link check has seen the link go down */
+
+/* Capture tap, the tap must not keep or free p. It runs where the frame is
+   handled, in the ETH interrupt with the RX mitigation off. */
+typedef void (*ethernetif_tap_t)(const struct pbuf *p, uint32_t event);
+
+typedef struct
+{
+    uint32_t frames;                  /* frames handed to the DMA */
+    uint32_t bytes;                   /* bytes handed to the DMA */
+    uint32_t queued;                  /* frames which waited in the queue */
+    uint32_t full;                    /* frames refused with ERR_MEM */
+    uint32_t depth;                   /* frames in the queue */
+    uint32_t depth_max;               /* high-water mark of the queue */
+    uint32_t wait_max_us;             /* longest wait of a queued frame */
+    uint32_t wait_sum_us;             /* total wait of the queued frames */
+} ethernetif_tx_queue_stats_t;
+
+typedef struct
+{
+    uint32_t rx_irq;                  /* RX interrupts taken */
+    uint32_t rx_poll;                 /* ethernetif_poll() passes with frames pending */
+    uint32_t rx_poll_exhausted;       /* passes which used the whole budget */
+    uint32_t rx_frames;               /* frames handed to the stack */
+    uint32_t rx_bytes;                /* bytes handed to the stack */
+    uint32_t rx_drop_stack;           /* frames refused by netif->input */
+    uint32_t rx_fastpath;             /* frames taken by the EtherType handlers */
+    uint32_t rx_fastpath_bytes;       /* bytes taken by the EtherType handlers */
+    uint32_t rx_fastpath_pass;        /* frames a handler gave back to the stack */
+    uint32_t rx_copybreak;            /* small frames copied out of the RX pool */
+    uint32_t rx_copybreak_fail;       /* small frames kept zero-copy on a heap shortage */
+    uint32_t rx_pool_in_use;          /* RX pool buffers owned by the DMA or lwIP */
+    uint32_t rx_pool_max;             /* high-water mark of the RX pool buffers in use */
+    uint32_t rx_pool_low;             /* times the free RX buffers fell to the low-water mark */
+    uint32_t rx_pool_empty;           /* times the RX pool was exhausted */
+    uint32_t rx_refill;               /* RX descriptor rebuilds after an exhaustion */
+    uint32_t rx_ring_empty;           /* receive buffer unavailable DMA errors */
+    uint32_t rx_stall;                /* RX pool exhausted for longer than ETH_RX_STALL_MS */
+    uint32_t rx_drop_no_buffer;       /* frames dropped by the DMA with no RX descriptor */
+    uint32_t rx_drop_overflow;        /* frames dropped on a RX FIFO overflow */
+    uint32_t tx_frames;               /* frames handed to the DMA */
+    uint32_t tx_bytes;                /* bytes handed to the DMA */
+    uint32_t tx_errors;               /* frames dropped on a DMA error */
+    uint32_t tx_zero_copy;            /* frames sent from the pbuf chain */
+    uint32_t tx_linearized;           /* frames copied into a bounce buffer */
+    uint32_t tx_bounce_busy;          /* transmits deferred with no free bounce buffer */
+    uint32_t tx_ring_full;            /* transmits refused by busy descriptors */
+    uint32_t tx_ring_in_use;          /* TX descriptors in use */
+    uint32_t tx_ring_max;             /* high-water mark of the TX descriptors in use */
+    uint32_t tx_queued;               /* frames deferred to the TX queues */
+    uint32_t tx_queue_full;           /* frames refused with ERR_MEM */
+    uint32_t tx_queue_depth;          /* frames in the TX queues */
+    uint32_t tx_queue_max;            /* high-water mark of the TX queue */
+    uint32_t tx_bulk_ring_bytes;      /* bulk bytes held by the TX descriptors */
+    uint32_t tx_bulk_held;            /* bulk frames held back by the ring byte limit */
+    ethernetif_tx_queue_stats_t tx_prio[ETH_TX_PRIO_CNT]; /* per priority queue, 0 first */
+    uint32_t mmc_tx_good;             /* MAC good frames transmitted */
+    uint32_t mmc_tx_collisions;       /* MAC frames transmitted after collisions */
+    uint32_t mmc_rx_good_unicast;     /* MAC good unicast frames received */
+    uint32_t mmc_rx_crc_errors;       /* MAC frames received with a CRC error */
+    uint32_t mmc_rx_alignment_errors; /* MAC frames received with an alignment error */
+    uint32_t phy_symbol_errors;       /* PHY invalid code symbols received */
+    uint32_t link_up;                 /* link up events */
+    uint32_t link_down;               /* link down events */
+    uint32_t link_outage_ms;          /* length of the last link loss */
+    uint32_t link_traffic_ms;         /* time from the last link up to the first frame received */
+    uint32_t flap_penalty;            /* flap dampening penalty */
+    uint32_t flap_held;               /* a link up is held back by the dampening now */
+    uint32_t flap_suppressed;         /* times the dampening held back the link */
+    uint32_t pause_tx_enabled;        /* PAUSE frames may be sent on this link */
+    uint32_t pause_rx_enabled;        /* received PAUSE frames stop the transmitter */
+    uint32_t pause_frames;            /* PAUSE frames sent on a low RX pool */
+    uint32_t pause_resume_frames;     /* zero quanta PAUSE frames sent on recovery */
+    uint32_t duplex_half;             /* the link runs half duplex */
+    uint32_t duplex_parallel_detect;  /* the link partner does not auto negotiate */
+    uint32_t duplex_pd_fault;         /* parallel detection faults seen */
+    uint32_t duplex_collisions;       /* TX collisions seen while the link is up */
+    uint32_t duplex_rx_errors;        /* RX CRC and alignment errors seen while the link is up */
+    uint32_t duplex_mismatch;         /* a duplex mismatch is suspected now */
+    uint32_t duplex_mismatch_events;  /* times a duplex mismatch was flagged */
+    uint32_t duplex_forced;           /* ETH_DUPLEX_FORCE_MODE was applied */
+    uint32_t mcast_groups;            /* multicast MAC addresses in the hardware filter */
+    uint32_t mcast_overflow;          /* multicast MAC addresses beyond ETH_MCAST_FILTER_CNT */
+    uint32_t mcast_filter_errors;     /* failed hardware filter updates */
+} ethernetif_stats_t;
+
 /* Exported functions ------------------------------------------------------- */
 
 /**
@@ -46,6 +266,163 @@ err_t ethernetif_init(struct netif *netif);
   */
 void ethernetif_input(struct netif *netif);
 
+/**
+  * @brief This function should be called from the ETH RX complete interrupt.
+  * With mitigation enabled the RX interrupt is masked and the frames are left
+  * in the descriptor ring for ethernetif_poll(), otherwise the ring is drained
+  * at once by ethernetif_input().
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  */
+void ethernetif_rx_irq(struct netif *netif);
+
+/**
+  * @brief Read at most the poll budget of frames from the RX descriptor ring.
+  * The RX interrupt is unmasked again once the ring is found empty.
+  * Should be called from the main loop.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @return 1 if frames are still pending, 0 if the ring is empty
+  */
+uint8_t ethernetif_poll(struct netif *netif);
+
+/**
+  * @brief This function should be called from the ETH TX complete interrupt.
+  * The descriptors are reclaimed by the next ethernetif_poll() pass.
+  */
+void ethernetif_tx_irq(void);
+
+/**
+  * @brief This function should be called from the ETH DMA error interrupt.
+  * A receive buffer unavailable error means the DMA owns no RX descriptor,
+  * the next ethernetif_poll() pass tries to rebuild them.
+  *
+  * @param dma_error the DMA error code of the ETH handle
+  */
+void ethernetif_error_irq(uint32_t dma_error);
+
+/**
+  * @brief Check if RX frames or TX completions are waiting for ethernetif_poll().
+  * @retval 1 if work is pending, 0 otherwise
+  */
+uint8_t ethernetif_pending(void);
+
+/**
+  * @brief Get the time until ethernetif_poll() has timed work to do, a PAUSE
+  * refresh or the RX stall check.
+  * @retval milliseconds until the next deadline, 0xFFFFFFFF if there is none
+  */
+uint32_t ethernetif_sleeptime(void);
+
+/**
+  * @brief Enable or disable the PHY near end loopback. The PHY is forced to
+  * 100Mbps full duplex and the MAC is started even without a link, so the
+  * transmitted frames come back to the RX path of this interface. Disabling
+  * it takes the link down, the link check negotiates the line again.
+  *
+  * @param netif the lwip network interface structure for this ethernetif
+  * @param enable 1 to loop the frames back, 0 to use the line
+  * @retval ERR_OK on success, ERR_IF if the PHY refused the setting
+  */
+err_t ethernetif_set_loopback(struct netif *netif, uint8_t enable);
+
+/**
+  * @brief Register a fast-path handler for an EtherType. Its frames skip the
+  * copy-break and netif->input and go straight from the RX drain loop to the
+  * handler, in ethernetif_poll() or, with the mitigation off, in the RX
+  * interrupt. A 802.1Q tagged frame is matched on its inner EtherType.
+  * Registering a type again replaces its handler.
+  *
+  * @param type the EtherType in host order
+  * @param handler the handler
+  * @param arg the handler argument
+  * @retval ERR_OK on success, ERR_ARG on a NULL handler, ERR_MEM if the table is full
+  */
+err_t ethernetif_add_rx_handler(uint16_t type, ethernetif_rx_handler_t handler, void *arg);
+
+/**
+  * @brief Remove the fast-path handler of an EtherType, its frames go to the
+  * stack again.
+  *
+  * @param type the EtherType in host order
+  * @retval ERR_OK on success, ERR_VAL if no handler is registered for it
+  */
+err_t ethernetif_remove_rx_handler(uint16_t type);
+
+/**
+  * @brief Send the frames of an EtherType to a TX queue. Untagged frames are
+  * looked up by EtherType first, tagged frames go by their PCP.
+  *
+  * @param type the EtherType in host order
+  * @param queue the TX queue, 0 is served first
+  * @retval ERR_OK on success, ERR_ARG on an invalid queue, ERR_MEM if the table is full
+  */
+err_t ethernetif_set_tx_class(uint16_t type, uint32_t queue);
+
+/**
+  * @brief Set the bytes of bulk frames the TX descriptors may hold. A bulk
+  * frame waits in its queue while the limit is reached, so a higher priority
+  * frame waits for at most that many bytes on the wire.
+  *
+  * @param bytes the limit, 0 disables it
+  */
+void ethernetif_set_tx_bulk_limit(uint32_t bytes);
+
+/**
+  * @brief Set the capture tap. It sees every received frame, every frame
+  * given to low_level_output and the link loss. Without a tap each frame
+  * costs one test.
+  *
+  * @param tap the tap, NULL removes it
+  */
+void ethernetif_set_tap(ethernetif_tap_t tap);
+
+/**
+  * @brief Configure the RX interrupt mitigation.
+  *
+  * @param enable 1 to poll from the main loop, 0 to drain the ring in the interrupt
+  * @param budget maximum number of frames read per ethernetif_poll() pass
+  */
+void ethernetif_set_rx_mitigation(uint8_t enable, uint32_t budget);
+
+/**
+  * @brief Set the RX copy-break threshold.
+  *
+  * @param len frames shorter than len bytes are copied, 0 disables the copy
+  */
+void ethernetif_set_rx_copybreak(uint32_t len);
+
+/**
+  * @brief Append a received buffer to the frame in O(1). Only the head keeps
+  * the running frame length, ethernetif_rx_chain_end() gives the other
+  * segments their tot_len once the frame is complete.
+  *
+  * @param start the first pbuf of the frame, NULL for a new frame
+  * @param end the last pbuf of the frame
+  * @param p the pbuf of the received buffer
+  * @param len the bytes in the buffer
+  */
+void ethernetif_rx_chain_add(struct pbuf **start, struct pbuf **end, struct pbuf *p, uint16_t len);
+
+/**
+  * @brief Give every segment of a complete frame its tot_len in one pass.
+  *
+  * @param p the first pbuf of the frame, or NULL
+  */
+void ethernetif_rx_chain_end(struct pbuf *p);
+
+/**
+  * @brief Clear the interface statistics, the high-water marks restart from
+  * the current levels.
+  */
+void ethernetif_reset_stats(void);
+
+/**
+  * @brief Get the interface statistics.
+  * @retval pointer to the statistics block
+  */
+const ethernetif_stats_t *ethernetif_get_stats(void);
+
 /**
   * @brief
   * @retval None
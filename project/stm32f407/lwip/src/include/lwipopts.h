@@ -89,12 +89,34 @@ a lot of data that needs to be copied, this should be set high. */
 /* ---------- DHCP options ---------- */
 #define LWIP_DHCP               1
 
+/* ---------- IGMP options ---------- */
+/* LWIP_IGMP==1: Join multicast groups, the MAC filter is driven by igmp_mac_filter */
+#define LWIP_IGMP               1
+
 /* ---------- UDP options ---------- */
 #define LWIP_UDP                1
 #define UDP_TTL                 255
 
 /* ---------- Statistics options ---------- */
-#define LWIP_STATS 0
+/* LWIP_SERVER_PERF==1: the perf build, the MIB2 counters give the fast retransmissions of the perf test */
+#ifndef LWIP_SERVER_PERF
+#define LWIP_SERVER_PERF        0
+#endif
+#if LWIP_SERVER_PERF
+#define LWIP_STATS              1
+#define MIB2_STATS              1
+#define LINK_STATS              0
+#define ETHARP_STATS            0
+#define IP_STATS                0
+#define ICMP_STATS              0
+#define IGMP_STATS              0
+#define UDP_STATS               0
+#define TCP_STATS               0
+#define MEM_STATS               0
+#define MEMP_STATS              0
+#else
+#define LWIP_STATS              0
+#endif
 
 /* ---------- link callback options ---------- */
 /* LWIP_NETIF_LINK_CALLBACK==1: Support a callback function from an interface
@@ -102,6 +124,15 @@ a lot of data that needs to be copied, this should be set high. */
  */
 #define LWIP_NETIF_LINK_CALLBACK        1
 
+/* LWIP_NETIF_STATUS_CALLBACK==1: Support a callback function whenever the
+ * interface is brought up or its address changes
+ */
+#define LWIP_NETIF_STATUS_CALLBACK      1
+
+/* ---------- ARP options ---------- */
+/* ETHARP_SUPPORT_STATIC_ENTRIES==1: fixed peers keep their ARP entries */
+#define ETHARP_SUPPORT_STATIC_ENTRIES   1
+
 #define LWIP_RAW 1
 
 /*
@@ -175,6 +206,11 @@ The STM32F4xx allows computing and verifying the IP, UDP, TCP and ICMP checksums
  */
 #define LWIP_DNS                        1
 
+/**
+ * DNS_TABLE_SIZE: records kept for their ttl, one for each name of the app dns cache
+ */
+#define DNS_TABLE_SIZE                  8
+
 /**
  * Don't use protect
  */
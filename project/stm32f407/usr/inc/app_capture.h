@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_capture.h
+ * @brief     app capture header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_CAPTURE_H
+#define APP_CAPTURE_H
+
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app capture definition
+ */
+#ifndef APP_CAPTURE_RING_SIZE
+    #define APP_CAPTURE_RING_SIZE    8192          /**< ring bytes with the record headers, a multiple of 4 */
+#endif
+#ifndef APP_CAPTURE_SNAPLEN
+    #define APP_CAPTURE_SNAPLEN      128           /**< default bytes kept of a frame */
+#endif
+#ifndef APP_CAPTURE_POLL_MS
+    #define APP_CAPTURE_POLL_MS      100           /**< crc error counter check period */
+#endif
+#define APP_CAPTURE_SNAPLEN_MIN      14            /**< min bytes kept of a frame, the ethernet header */
+#define APP_CAPTURE_SNAPLEN_MAX      1514          /**< max bytes kept of a frame without the fcs */
+
+/**
+ * @brief app capture trigger definition
+ */
+#define APP_CAPTURE_TRIGGER_LINK_DOWN    (1U << 0)        /**< the link goes down */
+#define APP_CAPTURE_TRIGGER_CRC          (1U << 1)        /**< the mac counts a crc error */
+#define APP_CAPTURE_TRIGGER_MANUAL       (1U << 2)        /**< app_capture_trigger is called */
+
+/**
+ * @brief app capture state enumeration definition
+ */
+typedef enum
+{
+    APP_CAPTURE_STATE_IDLE      = 0x00,        /**< never armed */
+    APP_CAPTURE_STATE_ARMED     = 0x01,        /**< recording, waiting for the trigger */
+    APP_CAPTURE_STATE_TRIGGERED = 0x02,        /**< recording the frames after the trigger */
+    APP_CAPTURE_STATE_DONE      = 0x03,        /**< stopped, the ring is kept */
+} app_capture_state_t;
+
+/**
+ * @brief app capture config structure definition
+ */
+typedef struct app_capture_config_s
+{
+    uint16_t snaplen;            /**< bytes kept of a frame */
+    uint32_t trigger;            /**< trigger mask, 0 records until it is stopped or triggered by hand */
+    uint32_t pre;                /**< frames kept before the trigger, 0 keeps all the ring holds */
+    uint32_t post;               /**< frames recorded after the trigger */
+} app_capture_config_t;
+
+/**
+ * @brief app capture stats structure definition
+ */
+typedef struct app_capture_stats_s
+{
+    app_capture_state_t state;   /**< capture state */
+    uint32_t reason;             /**< trigger that fired, 0 if none */
+    uint32_t frames;             /**< frames recorded */
+    uint32_t overwritten;        /**< frames overwritten by newer ones */
+    uint32_t ring_frames;        /**< frames in the ring */
+    uint32_t ring_bytes;         /**< bytes in the ring with the record headers */
+    uint32_t pre;                /**< frames in the ring before the trigger */
+    uint32_t post;               /**< frames recorded after the trigger */
+} app_capture_stats_t;
+
+/**
+ * @brief app capture init
+ * @note  none
+ */
+void app_capture_init(void);
+
+/**
+ * @brief     app capture arm
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - ERR_OK the capture is recording
+ *            - ERR_VAL the config is invalid
+ * @note      the ring is cleared, a running capture starts again
+ */
+err_t app_capture_arm(const app_capture_config_t *config);
+
+/**
+ * @brief     app capture trigger
+ * @param[in] reason trigger reason
+ * @note      an armed capture records its post frames and stops, otherwise nothing happens
+ */
+void app_capture_trigger(uint32_t reason);
+
+/**
+ * @brief app capture stop
+ * @note  the ring is kept for the dump
+ */
+void app_capture_stop(void);
+
+/**
+ * @brief app capture check the crc error trigger
+ * @note  call it from the main loop
+ */
+void app_capture_poll(void);
+
+/**
+ * @brief  app capture get the time until app_capture_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no crc trigger is armed
+ * @note   none
+ */
+uint32_t app_capture_sleeptime(void);
+
+/**
+ * @brief  app capture open the ring as a pcap file
+ * @return pcap file size in bytes
+ * @note   the capture is stopped, the frames before the pre window are left out
+ */
+uint32_t app_capture_open(void);
+
+/**
+ * @brief      app capture read the pcap file
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len buffer length
+ * @return     bytes read, 0 at the end of the file
+ * @note       reads follow each other from app_capture_open
+ */
+uint32_t app_capture_read(uint8_t *buf, uint32_t len);
+
+/**
+ * @brief      app capture get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_capture_get_stats(app_capture_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
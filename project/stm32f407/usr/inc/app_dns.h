@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_dns.h
+ * @brief     app dns header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_DNS_H
+#define APP_DNS_H
+
+#include "lwip/dns.h"
+#include "lwip/ip_addr.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app dns cache definition
+ */
+#ifndef APP_DNS_CACHE_SIZE
+    #define APP_DNS_CACHE_SIZE    DNS_TABLE_SIZE    /**< cached names, lwip keeps the records of as many */
+#endif
+#ifndef APP_DNS_NAME_LEN
+    #define APP_DNS_NAME_LEN      64          /**< max name length with the terminator */
+#endif
+#ifndef APP_DNS_REQUEST_CNT
+    #define APP_DNS_REQUEST_CNT   4           /**< callbacks waiting for an answer */
+#endif
+
+/**
+ * @brief app dns callback definition
+ * @note  addr is NULL if the name could not be resolved
+ */
+typedef void (*app_dns_callback_t)(const char *name, const ip_addr_t *addr, void *arg);
+
+/**
+ * @brief app dns stats structure definition
+ */
+typedef struct app_dns_stats_s
+{
+    uint32_t lookups;            /**< resolve calls */
+    uint32_t hits;               /**< answers from the cache with a valid ttl */
+    uint32_t misses;             /**< names sent to the server */
+    uint32_t prefetches;         /**< used names queried again once their ttl ran out */
+    uint32_t failures;           /**< queries without an answer */
+    uint32_t evictions;          /**< least recently used names dropped */
+    uint32_t answers;            /**< queries answered */
+    uint32_t latency_sum;        /**< total query latency in ms */
+    uint32_t latency_max;        /**< max query latency in ms */
+} app_dns_stats_t;
+
+/**
+ * @brief app dns init
+ * @note  the prefetch runs from the lwip server timer wheel
+ */
+void app_dns_init(void);
+
+/**
+ * @brief      app dns resolve a name
+ * @param[in]  *name pointer to a host name
+ * @param[out] *addr pointer to an address buffer
+ * @param[in]  callback called with the answer if the name is not cached
+ * @param[in]  *arg callback argument
+ * @return     status code
+ *             - ERR_OK the address is in addr
+ *             - ERR_INPROGRESS the callback is called later
+ *             - other the name can not be resolved
+ * @note       none
+ */
+err_t app_dns_resolve(const char *name, ip_addr_t *addr, app_dns_callback_t callback, void *arg);
+
+/**
+ * @brief app dns flush the cache
+ * @note  names waiting for an answer are kept
+ */
+void app_dns_flush(void);
+
+/**
+ * @brief      app dns get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_dns_get_stats(app_dns_stats_t *stats);
+
+/**
+ * @brief app dns reset the stats
+ */
+void app_dns_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -44,13 +44,91 @@
 #include "netif/etharp.h"
 #include "ethernetif.h"
 #include "lwip/dhcp.h"
+#include "lwip/prot/dhcp.h"
 #include "driver_lan8720_interface.h"
 #include "stm32f4xx_hal.h"
+#include "timer_wheel.h"
 
 #ifdef __cplusplus
 extern "C"{
 #endif
 
+/**
+ * @brief lwip server watchdog definition
+ * @note  refresh period of the independent watchdog in ms, 0 leaves the watchdog off,
+ *        the watchdog can not be stopped once it runs
+ */
+#ifndef LWIP_SERVER_WATCHDOG_MS
+    #define LWIP_SERVER_WATCHDOG_MS 0
+#endif
+
+/**
+ * @brief lwip server flap hold definition
+ * @note  a bound address is kept while it is confirmed after a link loss shorter than this in ms,
+ *        after a longer loss the address is dropped until the dhcp server acks it again
+ */
+#ifndef LWIP_SERVER_FLAP_HOLD_MS
+    #define LWIP_SERVER_FLAP_HOLD_MS 30000
+#endif
+
+/**
+ * @brief lwip server arp definition
+ * @note  peers resolved at link up besides the gateway, and the gratuitous arp
+ *        announcements sent after the one of lwip, 2s apart as in rfc 5227
+ */
+#ifndef LWIP_SERVER_ARP_PEER_CNT
+    #define LWIP_SERVER_ARP_PEER_CNT 4
+#endif
+#ifndef LWIP_SERVER_ARP_ANNOUNCE
+    #define LWIP_SERVER_ARP_ANNOUNCE 1
+#endif
+
+/**
+ * @brief lwip server arp stats structure definition
+ */
+typedef struct lwip_server_arp_stats_s
+{
+    uint32_t announces;        /**< gratuitous arp announcements sent */
+    uint32_t prewarms;         /**< arp requests sent at link up or address change */
+    uint32_t gateway_ms;       /**< time from the last link up to the resolved gateway */
+    uint32_t gateway_timeouts; /**< gateways not resolved within 2s */
+} lwip_server_arp_stats_t;
+
+/**
+ * @brief lwip server rate structure definition
+ */
+typedef struct lwip_server_rate_s
+{
+    uint32_t rx_frames;        /**< frames received per second */
+    uint32_t tx_frames;        /**< frames sent per second */
+    uint32_t rx_bytes;         /**< bytes received per second */
+    uint32_t tx_bytes;         /**< bytes sent per second */
+} lwip_server_rate_t;
+
+/**
+ * @brief lwip server dhcp lease structure definition
+ * @note  the addresses are in network order, the times are the seconds left at the lease clock time
+ */
+typedef struct lwip_server_lease_s
+{
+    uint32_t addr;             /**< leased address */
+    uint32_t netmask;          /**< subnet mask */
+    uint32_t gw;               /**< gateway */
+    uint32_t server;           /**< dhcp server */
+    uint32_t lease;            /**< lease time, 0 is expired */
+    uint32_t t1;               /**< renewal time */
+    uint32_t t2;               /**< rebinding time */
+    uint32_t time;             /**< lease clock time of the save in seconds */
+} lwip_server_lease_t;
+
+/**
+ * @brief lwip server dhcp lease storage definition
+ * @note  the functions return 0 on success
+ */
+typedef uint8_t (*lwip_server_lease_load_t)(lwip_server_lease_t *lease);
+typedef uint8_t (*lwip_server_lease_save_t)(const lwip_server_lease_t *lease);
+typedef uint8_t (*lwip_server_lease_clock_t)(uint32_t *seconds);
+
 /**
  * @brief netif config
  */
@@ -61,6 +139,57 @@ void netif_config(void);
  */
 void lwip_server(void);
 
+/**
+ * @brief  get the time until the next lwip server deadline
+ * @return milliseconds until lwip_server() has timed work to do
+ */
+uint32_t lwip_server_sleeptime(void);
+
+/**
+ * @brief     set the dhcp lease storage
+ * @param[in] load pointer to a lease load function, NULL disables init-reboot
+ * @param[in] save pointer to a lease save function, NULL disables the lease saving
+ * @param[in] clock pointer to a clock which keeps running over a reset, NULL disables init-reboot
+ * @note      call it before netif_config, a lease whose time has run out on the clock is not requested again
+ */
+void lwip_server_set_lease_storage(lwip_server_lease_load_t load, lwip_server_lease_save_t save,
+                                   lwip_server_lease_clock_t clock);
+
+/**
+ * @brief     add a peer resolved at link up
+ * @param[in] *addr pointer to the peer address
+ * @return    lwip error code
+ * @note      call it after netif_config
+ */
+err_t lwip_server_add_arp_peer(const ip4_addr_t *addr);
+
+/**
+ * @brief     add a static arp entry for a fixed peer
+ * @param[in] *addr pointer to the peer address
+ * @param[in] *mac pointer to the peer mac address
+ * @return    lwip error code
+ * @note      call it after netif_config, the entry survives link flaps
+ */
+err_t lwip_server_add_static_arp(const ip4_addr_t *addr, const uint8_t mac[6]);
+
+/**
+ * @brief      get the arp stats
+ * @param[out] *stats pointer to an arp stats structure
+ */
+void lwip_server_get_arp_stats(lwip_server_arp_stats_t *stats);
+
+/**
+ * @brief  get the wheel which runs the periodic work of the lwip server
+ * @return pointer to the timer wheel, the tick is HAL_GetTick()
+ */
+timer_wheel_t *lwip_server_get_wheel(void);
+
+/**
+ * @brief      get the interface rates of the last sampling period
+ * @param[out] *rate pointer to a rate structure
+ */
+void lwip_server_get_rate(lwip_server_rate_t *rate);
+
 /**
  * @brief netif get handle
  * @return points to a netif buffer
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_perf.h
+ * @brief     app perf header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_PERF_H
+#define APP_PERF_H
+
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+#include "lwip/apps/lwiperf.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app perf definition
+ */
+#ifndef APP_PERF_MAX_IDLE_S
+    #define APP_PERF_MAX_IDLE_S    10          /**< a client without an ack for this long is aborted */
+#endif
+
+/**
+ * @brief app perf retransmission structure definition
+ */
+typedef struct app_perf_rexmit_s
+{
+    uint32_t fast;              /**< fast retransmitted segments, counted by lwip with MIB2_STATS */
+    uint32_t timeouts;          /**< retransmission timeouts of the client */
+    uint8_t fast_valid;         /**< 1 if lwip counts the fast retransmissions, 0 leaves fast at 0 */
+} app_perf_rexmit_t;
+
+/**
+ * @brief     app perf start a client
+ * @param[in] *remote_addr pointer to the server address
+ * @param[in] remote_port server port
+ * @param[in] duration_ms send time in ms
+ * @param[in] report_fn called once the client is done or aborted
+ * @param[in] *report_arg report argument
+ * @return    lwip error code
+ * @note      one client runs at a time, it talks iperf 2 like lwiperf_start_tcp_client,
+ *            which always sends for 10 s
+ */
+err_t app_perf_client_start(const ip_addr_t *remote_addr, uint16_t remote_port, uint32_t duration_ms,
+                            lwiperf_report_fn report_fn, void *report_arg);
+
+/**
+ * @brief app perf abort the client
+ * @note  the report function is not called
+ */
+void app_perf_client_abort(void);
+
+/**
+ * @brief      app perf get the retransmissions
+ * @param[out] *rexmit pointer to a retransmission structure
+ * @note       both counters are free running
+ */
+void app_perf_get_rexmit(app_perf_rexmit_t *rexmit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
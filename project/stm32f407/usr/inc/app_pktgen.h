@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_pktgen.h
+ * @brief     app pktgen header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_PKTGEN_H
+#define APP_PKTGEN_H
+
+#include "lwip/err.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app pktgen definition
+ */
+#ifndef APP_PKTGEN_FRAME_CNT
+    #define APP_PKTGEN_FRAME_CNT    8             /**< frames in flight */
+#endif
+#ifndef APP_PKTGEN_ETHTYPE
+    #define APP_PKTGEN_ETHTYPE      0x88B5U       /**< local experimental ethertype */
+#endif
+#ifndef APP_PKTGEN_UDP_PORT
+    #define APP_PKTGEN_UDP_PORT     9U            /**< udp port of the udp mode, the discard port */
+#endif
+#ifndef APP_PKTGEN_SETTLE_MS
+    #define APP_PKTGEN_SETTLE_MS    50            /**< loopback settle time before the first frame */
+#endif
+#ifndef APP_PKTGEN_DRAIN_MS
+    #define APP_PKTGEN_DRAIN_MS     100           /**< wait for the frames in flight after the last one */
+#endif
+#define APP_PKTGEN_SIZE_MIN         64            /**< min frame size with the fcs */
+#define APP_PKTGEN_SIZE_MAX         1518          /**< max frame size with the fcs */
+
+/**
+ * @brief app pktgen config structure definition
+ */
+typedef struct app_pktgen_config_s
+{
+    uint8_t dst[6];              /**< destination mac address */
+    uint16_t size;               /**< frame size with the fcs */
+    uint32_t rate;               /**< frames per second, 0 sends as fast as the link takes them */
+    uint32_t burst;              /**< frames sent back to back at a time */
+    uint32_t count;              /**< frames to send, 0 sends until the duration ends */
+    uint32_t duration_ms;        /**< send time, 0 sends until the count is reached */
+    uint8_t loopback;            /**< send over the phy near end loopback */
+    uint8_t udp;                 /**< send udp datagrams through the stack receiver instead of raw frames */
+    uint32_t ip;                 /**< udp destination address in network order, 0 is the own address */
+} app_pktgen_config_t;
+
+/**
+ * @brief app pktgen stats structure definition
+ */
+typedef struct app_pktgen_stats_s
+{
+    uint32_t tx_frames;          /**< frames sent */
+    uint32_t tx_bytes;           /**< bytes sent with the fcs */
+    uint32_t tx_busy;            /**< passes held back by the frames in flight */
+    uint32_t tx_errors;          /**< frames refused by the interface */
+    uint32_t tx_ms;              /**< time from the first frame to the last one */
+    uint32_t rx_frames;          /**< frames received */
+    uint32_t rx_bytes;           /**< bytes received with the fcs */
+    uint32_t rx_lost;            /**< sequence numbers missing */
+    uint32_t rx_reordered;       /**< frames older than the newest one received */
+    uint32_t rx_ms;              /**< time from the first frame to the last one */
+    uint32_t latency_cnt;        /**< latency samples */
+    uint32_t latency_min;        /**< min latency in ns */
+    uint32_t latency_max;        /**< max latency in ns */
+    uint64_t latency_sum;        /**< total latency in ns */
+} app_pktgen_stats_t;
+
+/**
+ * @brief app pktgen report callback definition
+ * @note  called once the run ends
+ */
+typedef void (*app_pktgen_report_t)(const app_pktgen_stats_t *stats, void *arg);
+
+/**
+ * @brief app pktgen init
+ * @note  call it after netif_config, the raw frames are received by an ethernetif fast path handler
+ */
+void app_pktgen_init(void);
+
+/**
+ * @brief     app pktgen start a run
+ * @param[in] *config pointer to a config structure
+ * @param[in] report called once the run ends
+ * @param[in] *arg report argument
+ * @return    status code
+ *            - ERR_OK the run is started
+ *            - ERR_VAL the config is invalid
+ *            - ERR_CONN the link is down or the udp mode has no address
+ *            - ERR_IF the loopback can not be set
+ * @note      a running run is stopped first, the tx stats restart
+ */
+err_t app_pktgen_start(const app_pktgen_config_t *config, app_pktgen_report_t report, void *arg);
+
+/**
+ * @brief app pktgen stop the run
+ * @note  the report is called at once
+ */
+void app_pktgen_stop(void);
+
+/**
+ * @brief app pktgen send the frames which are due
+ * @note  call it from the main loop after lwip_server
+ */
+void app_pktgen_poll(void);
+
+/**
+ * @brief  app pktgen get the time until app_pktgen_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no run is active
+ * @note   a generator waiting for the frames in flight is woken by the tx interrupt
+ */
+uint32_t app_pktgen_sleeptime(void);
+
+/**
+ * @brief      app pktgen get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_pktgen_get_stats(app_pktgen_stats_t *stats);
+
+/**
+ * @brief app pktgen reset the stats
+ */
+void app_pktgen_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
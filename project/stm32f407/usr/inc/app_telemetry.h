@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_telemetry.h
+ * @brief     app telemetry header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_TELEMETRY_H
+#define APP_TELEMETRY_H
+
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app telemetry definition
+ */
+#define APP_TELEMETRY_SIZE_MIN     8             /**< min block size, the sample header */
+#define APP_TELEMETRY_SIZE_MAX     1472          /**< max block size in one datagram */
+#define APP_TELEMETRY_PORT         9             /**< udp discard port */
+#ifndef APP_TELEMETRY_ARP_MS
+    #define APP_TELEMETRY_ARP_MS   1000          /**< arp request interval while the next hop is unresolved */
+#endif
+#ifndef APP_TELEMETRY_RETRY_MS
+    #define APP_TELEMETRY_RETRY_MS 100           /**< wait after a refused block before the next send */
+#endif
+
+/**
+ * @brief app telemetry stats structure definition
+ */
+typedef struct app_telemetry_stats_s
+{
+    uint32_t blocks;             /**< blocks sent */
+    uint32_t bytes;              /**< bytes sent */
+    uint32_t errors;             /**< blocks refused */
+    uint32_t ms;                 /**< time from the arp reply to the last block released */
+} app_telemetry_stats_t;
+
+/**
+ * @brief app telemetry report callback definition
+ * @note  called once the stream ends
+ */
+typedef void (*app_telemetry_report_t)(const app_telemetry_stats_t *stats, void *arg);
+
+/**
+ * @brief     app telemetry start a stream
+ * @param[in] *dst pointer to a unicast ipv4 destination address
+ * @param[in] size block size
+ * @param[in] count blocks to send, 0 sends until the duration ends
+ * @param[in] duration_ms send time in ms
+ * @param[in] report called once the stream ends
+ * @param[in] *arg report argument
+ * @return    status code
+ *            - ERR_OK the stream is started
+ *            - ERR_VAL the size or the destination is invalid
+ *            - ERR_CONN the interface has no address
+ *            - ERR_MEM the pcb can not be allocated
+ * @note      the blocks are sent from two static buffers without a copy, the stream waits for the
+ *            arp reply of the next hop first, a running stream is restarted
+ */
+err_t app_telemetry_start(const ip_addr_t *dst, uint16_t size, uint32_t count, uint32_t duration_ms,
+                          app_telemetry_report_t report, void *arg);
+
+/**
+ * @brief app telemetry send the blocks which are free
+ * @note  call it from the main loop after lwip_server
+ */
+void app_telemetry_poll(void);
+
+/**
+ * @brief  app telemetry get the time until app_telemetry_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no stream is active
+ * @note   a released block wakes up the loop through the tx interrupt and the arp reply through the
+ *         rx interrupt, a refused block holds the stream for APP_TELEMETRY_RETRY_MS
+ */
+uint32_t app_telemetry_sleeptime(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_udp_zc.h
+ * @brief     app udp zero copy header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef APP_UDP_ZC_H
+#define APP_UDP_ZC_H
+
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+#include "lwip/udp.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @brief app udp zc definition
+ */
+#ifndef APP_UDP_ZC_CNT
+    #define APP_UDP_ZC_CNT    8        /**< buffers in flight */
+#endif
+
+/**
+ * @brief app udp zc done callback definition
+ * @note  called once the buffer is no longer used by lwip or the dma, the owner may write it again
+ */
+typedef void (*app_udp_zc_done_t)(void *buf, void *arg);
+
+/**
+ * @brief app udp zc stats structure definition
+ */
+typedef struct app_udp_zc_stats_s
+{
+    uint32_t sent;               /**< datagrams handed to lwip */
+    uint32_t bytes;              /**< payload bytes handed to lwip */
+    uint32_t busy;               /**< sends refused with all the wrappers in flight */
+    uint32_t errors;             /**< sends refused by lwip */
+    uint32_t in_flight;          /**< buffers not released yet */
+    uint32_t in_flight_max;      /**< high-water mark of the buffers in flight */
+    uint32_t release_cnt;        /**< buffers released */
+    uint32_t release_max_us;     /**< longest time from the send to the release */
+    uint32_t release_sum_us;     /**< total time from the send to the release */
+} app_udp_zc_stats_t;
+
+/**
+ * @brief app udp zc init
+ * @note  none
+ */
+void app_udp_zc_init(void);
+
+/**
+ * @brief     app udp zc send a caller owned buffer without a copy
+ * @param[in] *pcb pointer to a udp pcb
+ * @param[in] *dst pointer to the destination address, NULL uses the connected address
+ * @param[in] port destination port, ignored with a NULL dst
+ * @param[in] *buf pointer to the payload
+ * @param[in] len payload length
+ * @param[in] done called once the buffer is released
+ * @param[in] *arg done argument
+ * @return    status code
+ *            - ERR_OK the buffer is handed over, done is called once it is released
+ *            - ERR_WOULDBLOCK all the wrappers are in flight, the buffer is not used
+ *            - other values the send failed, done has already been called
+ * @note      the buffer must not be written until done is called, the headers are built in the wrapper
+ */
+err_t app_udp_zc_sendto(struct udp_pcb *pcb, const ip_addr_t *dst, u16_t port,
+                        const void *buf, u16_t len, app_udp_zc_done_t done, void *arg);
+
+/**
+ * @brief      app udp zc get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_udp_zc_get_stats(app_udp_zc_stats_t *stats);
+
+/**
+ * @brief app udp zc reset the stats
+ * @note  the buffers in flight are kept
+ */
+void app_udp_zc_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
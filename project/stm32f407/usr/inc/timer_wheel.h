@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      timer_wheel.h
+ * @brief     timer wheel header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup timer_wheel timer wheel function
+ * @brief    timer wheel function modules
+ * @{
+ */
+
+/**
+ * @brief timer wheel geometry definition
+ * @note  3 levels of 64 slots cover 1 tick, 64 ticks and 4096 ticks per slot,
+ *        timers further than 262143 ticks are parked in the last level and cascaded again
+ */
+#define TIMER_WHEEL_LEVEL            3                /**< levels */
+#define TIMER_WHEEL_SLOT_BITS        6                /**< slot bits per level */
+#define TIMER_WHEEL_SLOT             64               /**< slots per level */
+#define TIMER_WHEEL_NONE             0xFFFFFFFFU      /**< no timer is pending */
+
+/**
+ * @brief timer wheel callback definition
+ */
+typedef void (*timer_wheel_callback_t)(void *arg);
+
+/**
+ * @brief timer wheel timer structure definition
+ */
+typedef struct timer_wheel_timer_s
+{
+    struct timer_wheel_timer_s *next;        /**< next timer in the slot */
+    struct timer_wheel_timer_s *prev;        /**< previous timer in the slot */
+    uint32_t expire;                         /**< expire tick */
+    uint32_t period;                         /**< reload period, 0 is one shot */
+    uint8_t level;                           /**< level of the slot */
+    uint8_t slot;                            /**< slot index */
+    uint8_t active;                          /**< timer is in the wheel */
+    timer_wheel_callback_t callback;         /**< expire callback */
+    void *arg;                               /**< callback argument */
+} timer_wheel_timer_t;
+
+/**
+ * @brief timer wheel structure definition
+ */
+typedef struct timer_wheel_s
+{
+    uint32_t now;                                                          /**< last processed tick */
+    uint64_t bitmap[TIMER_WHEEL_LEVEL];                                    /**< non empty slots */
+    timer_wheel_timer_t *slot[TIMER_WHEEL_LEVEL][TIMER_WHEEL_SLOT];        /**< slot lists */
+} timer_wheel_t;
+
+/**
+ * @brief     timer wheel init
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @note      none
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint32_t now);
+
+/**
+ * @brief     timer wheel add a timer
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @param[in] delay ticks until the first expiry, 0 runs at the next tick
+ * @param[in] period reload period in ticks, 0 is one shot
+ * @param[in] callback expire callback
+ * @param[in] *arg callback argument
+ * @note      an active timer is moved, the cost is O(1)
+ */
+void timer_wheel_add(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t delay, uint32_t period,
+                     timer_wheel_callback_t callback, void *arg);
+
+/**
+ * @brief     timer wheel remove a timer
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @note      an inactive timer is ignored, the cost is O(1)
+ */
+void timer_wheel_remove(timer_wheel_t *wheel, timer_wheel_timer_t *timer);
+
+/**
+ * @brief     timer wheel run the expired timers
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @note      the wheel jumps over the ticks without work, callbacks may add and remove timers
+ */
+void timer_wheel_run(timer_wheel_t *wheel, uint32_t now);
+
+/**
+ * @brief     timer wheel get the ticks until the next expiry
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @return    ticks until timer_wheel_run() has work, TIMER_WHEEL_NONE if no timer is pending
+ * @note      a timer in an upper level reports its cascade tick, which is never later than its expiry
+ */
+uint32_t timer_wheel_sleeptime(timer_wheel_t *wheel, uint32_t now);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
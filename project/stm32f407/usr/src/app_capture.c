@@ -0,0 +1,495 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_capture.c
+ * @brief     app capture source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_capture.h"
+#include "app_lwip.h"
+#include "ethernetif.h"
+#include "eth.h"
+#include "trace.h"
+#include <string.h>
+
+/**
+ * @brief app capture record definition
+ * @note  a record is the pcap record header and the frame, padded to 4 bytes
+ */
+#define APP_CAPTURE_HDR_LEN        16U                                     /**< pcap record header bytes */
+#define APP_CAPTURE_REC_LEN(n)     ((APP_CAPTURE_HDR_LEN + (n) + 3U) & ~3U)  /**< ring bytes of a record */
+
+/**
+ * @brief app capture pcap file header structure definition
+ */
+typedef struct app_capture_pcap_hdr_s
+{
+    uint32_t magic;              /**< 0xa1b2c3d4 in host order, microsecond stamps */
+    uint16_t major;              /**< major version 2 */
+    uint16_t minor;              /**< minor version 4 */
+    int32_t zone;                /**< gmt offset */
+    uint32_t sigfigs;            /**< stamp accuracy */
+    uint32_t snaplen;            /**< bytes kept of a frame */
+    uint32_t linktype;           /**< 1 is ethernet */
+} app_capture_pcap_hdr_t;
+
+static uint32_t gs_ring[APP_CAPTURE_RING_SIZE / 4];        /**< record ring */
+static uint32_t gs_head;                                   /**< offset of the oldest record */
+static uint32_t gs_tail;                                   /**< offset of the next record */
+static uint32_t gs_lap_end;                                /**< end of the records behind the tail after a wrap */
+static uint32_t gs_count;                                  /**< records in the ring */
+static uint32_t gs_bytes;                                  /**< ring bytes of the records */
+static uint32_t gs_seq_head;                               /**< sequence number of the oldest record */
+static uint32_t gs_seq_next;                               /**< sequence number of the next record */
+static uint32_t gs_seq_trigger;                            /**< sequence number of the first record after the trigger */
+static app_capture_config_t gs_config;                     /**< config */
+static volatile app_capture_state_t gs_state;              /**< state */
+static uint32_t gs_reason;                                 /**< trigger that fired */
+static uint32_t gs_frames;                                 /**< frames recorded */
+static uint32_t gs_overwritten;                            /**< frames overwritten */
+static uint32_t gs_post;                                   /**< frames recorded after the trigger */
+static uint32_t gs_crc;                                    /**< crc error count at the last check */
+static uint32_t gs_crc_tick;                               /**< tick of the last crc check */
+static uint32_t gs_clock_tick;                             /**< trace tick of the last stamp */
+static uint32_t gs_clock_ms;                               /**< system tick of the last stamp */
+static uint32_t gs_clock_sec;                              /**< seconds of the last stamp */
+static uint32_t gs_clock_usec;                             /**< microseconds of the last stamp */
+static uint32_t gs_clock_rem;                              /**< trace ticks below a microsecond */
+static uint32_t gs_clock_resync_ms;                        /**< time after which the trace tick may have wrapped */
+static uint32_t gs_tick_per_us;                            /**< trace ticks in a microsecond */
+static app_capture_pcap_hdr_t gs_file;                     /**< pcap file header of the reader */
+static uint32_t gs_read_hdr;                               /**< file header bytes read */
+static uint32_t gs_read_off;                               /**< offset of the record being read */
+static uint32_t gs_read_pos;                               /**< bytes read of the record */
+static uint32_t gs_read_left;                              /**< records left to read */
+
+/**
+ * @brief      app capture stamp a frame
+ * @param[out] *sec pointer to the seconds
+ * @param[out] *usec pointer to the microseconds
+ * @note       the trace tick gives the microseconds, the system tick catches a wrap of it
+ */
+static void a_app_capture_stamp(uint32_t *sec, uint32_t *usec)
+{
+    uint32_t tick = trace_get_tick();
+    uint32_t ms = HAL_GetTick();
+    uint32_t delta;
+    
+    if ((ms - gs_clock_ms) >= gs_clock_resync_ms)
+    {
+        gs_clock_sec = ms / 1000U;
+        gs_clock_usec = (ms % 1000U) * 1000U;
+        gs_clock_rem = 0;
+    }
+    else
+    {
+        delta = (tick - gs_clock_tick) + gs_clock_rem;
+        gs_clock_usec += delta / gs_tick_per_us;
+        gs_clock_rem = delta % gs_tick_per_us;
+        while (gs_clock_usec >= 1000000U)
+        {
+            gs_clock_usec -= 1000000U;
+            gs_clock_sec++;
+        }
+    }
+    gs_clock_tick = tick;
+    gs_clock_ms = ms;
+    *sec = gs_clock_sec;
+    *usec = gs_clock_usec;
+}
+
+/**
+ * @brief app capture drop the oldest record
+ * @note  none
+ */
+static void a_app_capture_evict(void)
+{
+    uint32_t len = APP_CAPTURE_REC_LEN(gs_ring[gs_head / 4 + 2]);
+    
+    gs_head += len;
+    gs_bytes -= len;
+    gs_count--;
+    gs_seq_head++;
+    gs_overwritten++;
+    if (gs_head >= gs_lap_end)
+    {
+        /* the oldest record is in the lap of the tail again */
+        gs_head = 0;
+        gs_lap_end = APP_CAPTURE_RING_SIZE;
+    }
+}
+
+/**
+ * @brief app capture stop recording
+ * @note  none
+ */
+static void a_app_capture_freeze(void)
+{
+    ethernetif_set_tap(NULL);
+    gs_state = APP_CAPTURE_STATE_DONE;
+}
+
+/**
+ * @brief     app capture tap
+ * @param[in] *p pointer to a frame
+ * @param[in] event tap event
+ * @note      runs in the rx drain, low_level_output and the link check
+ */
+static void a_app_capture_tap(const struct pbuf *p, uint32_t event)
+{
+    uint32_t incl;
+    uint32_t len;
+    uint32_t *rec;
+    
+    if (event == ETH_TAP_LINK_DOWN)
+    {
+        if ((gs_config.trigger & APP_CAPTURE_TRIGGER_LINK_DOWN) != 0)
+        {
+            app_capture_trigger(APP_CAPTURE_TRIGGER_LINK_DOWN);
+        }
+        
+        return;
+    }
+    
+    /* an empty ring starts at the front */
+    incl = (p->tot_len < gs_config.snaplen) ? p->tot_len : gs_config.snaplen;
+    len = APP_CAPTURE_REC_LEN(incl);
+    if (gs_count == 0)
+    {
+        gs_head = 0;
+        gs_tail = 0;
+        gs_lap_end = APP_CAPTURE_RING_SIZE;
+    }
+    
+    /* a record never wraps, the writer goes to the front and the records behind it are the old lap */
+    if ((gs_tail + len) > APP_CAPTURE_RING_SIZE)
+    {
+        while ((gs_count != 0) && (gs_head >= gs_tail))
+        {
+            a_app_capture_evict();
+        }
+        gs_lap_end = gs_tail;
+        gs_tail = 0;
+        if (gs_count == 0)
+        {
+            gs_head = 0;
+            gs_lap_end = APP_CAPTURE_RING_SIZE;
+        }
+    }
+    while ((gs_count != 0) && (gs_head >= gs_tail) && (gs_head < (gs_tail + len)))
+    {
+        a_app_capture_evict();
+    }
+    if (gs_count == 0)
+    {
+        gs_head = gs_tail;
+    }
+    
+    /* the pcap record header is kept as it goes into the file */
+    rec = &gs_ring[gs_tail / 4];
+    a_app_capture_stamp(&rec[0], &rec[1]);
+    rec[2] = incl;
+    rec[3] = p->tot_len;
+    (void)pbuf_copy_partial(p, &rec[4], (u16_t)incl, 0);
+    gs_tail += len;
+    gs_bytes += len;
+    gs_count++;
+    gs_seq_next++;
+    gs_frames++;
+    if (gs_state == APP_CAPTURE_STATE_TRIGGERED)
+    {
+        gs_post++;
+        if (gs_post >= gs_config.post)
+        {
+            a_app_capture_freeze();
+        }
+    }
+}
+
+/**
+ * @brief app capture init
+ * @note  none
+ */
+void app_capture_init(void)
+{
+    ethernetif_set_tap(NULL);
+    gs_state = APP_CAPTURE_STATE_IDLE;
+    gs_count = 0;
+    gs_bytes = 0;
+    gs_reason = 0;
+    gs_tick_per_us = trace_get_tick_per_us();
+    gs_clock_resync_ms = 0xFFFFFFFFU / gs_tick_per_us / 1000U / 2U;
+    gs_clock_ms = HAL_GetTick() - gs_clock_resync_ms;
+    gs_read_left = 0;
+}
+
+/**
+ * @brief     app capture arm
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - ERR_OK the capture is recording
+ *            - ERR_VAL the config is invalid
+ * @note      the ring is cleared, a running capture starts again
+ */
+err_t app_capture_arm(const app_capture_config_t *config)
+{
+    eth_mmc_t mmc;
+    
+    if ((config->snaplen < APP_CAPTURE_SNAPLEN_MIN) || (config->snaplen > APP_CAPTURE_SNAPLEN_MAX) ||
+        (APP_CAPTURE_REC_LEN(config->snaplen) > APP_CAPTURE_RING_SIZE))
+    {
+        return ERR_VAL;
+    }
+    ethernetif_set_tap(NULL);
+    gs_config = *config;
+    gs_head = 0;
+    gs_tail = 0;
+    gs_lap_end = APP_CAPTURE_RING_SIZE;
+    gs_count = 0;
+    gs_bytes = 0;
+    gs_seq_head = 0;
+    gs_seq_next = 0;
+    gs_seq_trigger = 0;
+    gs_reason = 0;
+    gs_frames = 0;
+    gs_overwritten = 0;
+    gs_post = 0;
+    gs_read_left = 0;
+    (void)eth_get_mmc(&mmc);
+    gs_crc = mmc.rx_crc_error;
+    gs_crc_tick = HAL_GetTick();
+    gs_state = APP_CAPTURE_STATE_ARMED;
+    ethernetif_set_tap(a_app_capture_tap);
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     app capture trigger
+ * @param[in] reason trigger reason
+ * @note      an armed capture records its post frames and stops, otherwise nothing happens
+ */
+void app_capture_trigger(uint32_t reason)
+{
+    if (gs_state != APP_CAPTURE_STATE_ARMED)
+    {
+        return;
+    }
+    gs_reason = reason;
+    gs_seq_trigger = gs_seq_next;
+    gs_post = 0;
+    gs_state = APP_CAPTURE_STATE_TRIGGERED;
+    if (gs_config.post == 0)
+    {
+        a_app_capture_freeze();
+    }
+}
+
+/**
+ * @brief app capture stop
+ * @note  the ring is kept for the dump
+ */
+void app_capture_stop(void)
+{
+    if (gs_state == APP_CAPTURE_STATE_ARMED)
+    {
+        /* the whole ring is the pre window */
+        gs_seq_trigger = gs_seq_next;
+    }
+    if (gs_state != APP_CAPTURE_STATE_IDLE)
+    {
+        a_app_capture_freeze();
+    }
+}
+
+/**
+ * @brief app capture check the crc error trigger
+ * @note  call it from the main loop
+ */
+void app_capture_poll(void)
+{
+    eth_mmc_t mmc;
+    
+    if ((gs_state != APP_CAPTURE_STATE_ARMED) || ((gs_config.trigger & APP_CAPTURE_TRIGGER_CRC) == 0) ||
+        ((HAL_GetTick() - gs_crc_tick) < APP_CAPTURE_POLL_MS))
+    {
+        return;
+    }
+    gs_crc_tick = HAL_GetTick();
+    (void)eth_get_mmc(&mmc);
+    if (mmc.rx_crc_error != gs_crc)
+    {
+        gs_crc = mmc.rx_crc_error;
+        app_capture_trigger(APP_CAPTURE_TRIGGER_CRC);
+    }
+}
+
+/**
+ * @brief  app capture get the time until app_capture_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no crc trigger is armed
+ * @note   none
+ */
+uint32_t app_capture_sleeptime(void)
+{
+    uint32_t elapsed;
+    
+    if ((gs_state != APP_CAPTURE_STATE_ARMED) || ((gs_config.trigger & APP_CAPTURE_TRIGGER_CRC) == 0))
+    {
+        return 0xFFFFFFFFU;
+    }
+    elapsed = HAL_GetTick() - gs_crc_tick;
+    
+    return (elapsed < APP_CAPTURE_POLL_MS) ? (APP_CAPTURE_POLL_MS - elapsed) : 0;
+}
+
+/**
+ * @brief  app capture open the ring as a pcap file
+ * @return pcap file size in bytes
+ * @note   the capture is stopped, the frames before the pre window are left out
+ */
+uint32_t app_capture_open(void)
+{
+    uint32_t skip = 0;
+    uint32_t size;
+    uint32_t off;
+    uint32_t i;
+    
+    app_capture_stop();
+    if ((gs_config.pre != 0) && ((gs_seq_trigger - gs_seq_head) > gs_config.pre) &&
+        ((gs_seq_trigger - gs_seq_head) <= gs_count))
+    {
+        skip = gs_seq_trigger - gs_seq_head - gs_config.pre;
+    }
+    gs_file.magic = 0xA1B2C3D4U;
+    gs_file.major = 2;
+    gs_file.minor = 4;
+    gs_file.zone = 0;
+    gs_file.sigfigs = 0;
+    gs_file.snaplen = gs_config.snaplen;
+    gs_file.linktype = 1;
+    gs_read_hdr = 0;
+    gs_read_pos = 0;
+    gs_read_left = gs_count - skip;
+    size = sizeof(app_capture_pcap_hdr_t);
+    off = gs_head;
+    for (i = 0; i < gs_count; i++)
+    {
+        if (off >= gs_lap_end)
+        {
+            off = 0;
+        }
+        if (i == skip)
+        {
+            gs_read_off = off;
+        }
+        if (i >= skip)
+        {
+            size += APP_CAPTURE_HDR_LEN + gs_ring[off / 4 + 2];
+        }
+        off += APP_CAPTURE_REC_LEN(gs_ring[off / 4 + 2]);
+    }
+    
+    return size;
+}
+
+/**
+ * @brief      app capture read the pcap file
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len buffer length
+ * @return     bytes read, 0 at the end of the file
+ * @note       reads follow each other from app_capture_open
+ */
+uint32_t app_capture_read(uint8_t *buf, uint32_t len)
+{
+    uint32_t n = 0;
+    uint32_t chunk;
+    uint32_t size;
+    
+    while (n < len)
+    {
+        if (gs_read_hdr < sizeof(app_capture_pcap_hdr_t))
+        {
+            chunk = sizeof(app_capture_pcap_hdr_t) - gs_read_hdr;
+            chunk = (chunk < (len - n)) ? chunk : (len - n);
+            memcpy(&buf[n], (uint8_t *)&gs_file + gs_read_hdr, chunk);
+            gs_read_hdr += chunk;
+            n += chunk;
+            
+            continue;
+        }
+        if (gs_read_left == 0)
+        {
+            break;
+        }
+        if (gs_read_off >= gs_lap_end)
+        {
+            gs_read_off = 0;
+        }
+        size = APP_CAPTURE_HDR_LEN + gs_ring[gs_read_off / 4 + 2];
+        chunk = size - gs_read_pos;
+        chunk = (chunk < (len - n)) ? chunk : (len - n);
+        memcpy(&buf[n], (uint8_t *)gs_ring + gs_read_off + gs_read_pos, chunk);
+        gs_read_pos += chunk;
+        n += chunk;
+        if (gs_read_pos == size)
+        {
+            gs_read_off += APP_CAPTURE_REC_LEN(size - APP_CAPTURE_HDR_LEN);
+            gs_read_pos = 0;
+            gs_read_left--;
+        }
+    }
+    
+    return n;
+}
+
+/**
+ * @brief      app capture get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_capture_get_stats(app_capture_stats_t *stats)
+{
+    stats->state = gs_state;
+    stats->reason = gs_reason;
+    stats->frames = gs_frames;
+    stats->overwritten = gs_overwritten;
+    stats->ring_frames = gs_count;
+    stats->ring_bytes = gs_bytes;
+    if (gs_state == APP_CAPTURE_STATE_ARMED)
+    {
+        stats->pre = gs_count;
+    }
+    else
+    {
+        stats->pre = ((gs_seq_trigger - gs_seq_head) <= gs_count) ? (gs_seq_trigger - gs_seq_head) : 0;
+    }
+    stats->post = gs_post;
+}
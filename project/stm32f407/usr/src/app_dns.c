@@ -0,0 +1,386 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_dns.c
+ * @brief     app dns source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_dns.h"
+#include "app_lwip.h"
+#include <string.h>
+
+/**
+ * @brief app dns entry state definition
+ */
+#define APP_DNS_FREE       0        /**< unused */
+#define APP_DNS_PENDING    1        /**< first query in flight */
+#define APP_DNS_VALID      2        /**< address cached */
+
+/**
+ * @brief app dns entry structure definition
+ */
+typedef struct app_dns_entry_s
+{
+    char name[APP_DNS_NAME_LEN];        /**< host name */
+    ip_addr_t addr;                     /**< cached address */
+    uint32_t use;                       /**< lru stamp */
+    uint32_t hits;                      /**< hits since the last answer */
+    uint32_t start;                     /**< query start tick */
+    uint8_t state;                      /**< entry state */
+} app_dns_entry_t;
+
+/**
+ * @brief app dns request structure definition
+ */
+typedef struct app_dns_request_s
+{
+    app_dns_entry_t *entry;             /**< waited entry, NULL is unused */
+    app_dns_callback_t callback;        /**< completion callback */
+    void *arg;                          /**< callback argument */
+} app_dns_request_t;
+
+static app_dns_entry_t gs_entry[APP_DNS_CACHE_SIZE];        /**< cache */
+static app_dns_request_t gs_request[APP_DNS_REQUEST_CNT];   /**< waiting callbacks */
+static app_dns_stats_t gs_stats;                            /**< stats */
+static uint32_t gs_use;                                     /**< lru clock */
+static timer_wheel_timer_t gs_prefetch_timer;               /**< prefetch timer */
+
+/**
+ * @brief     app dns find a name
+ * @param[in] *name pointer to a host name
+ * @return    pointer to the entry, NULL if the name is not cached
+ * @note      the names are compared without case
+ */
+static app_dns_entry_t *a_app_dns_find(const char *name)
+{
+    uint32_t i;
+    
+    for (i = 0; i < APP_DNS_CACHE_SIZE; i++)
+    {
+        if ((gs_entry[i].state != APP_DNS_FREE) &&
+            (lwip_strnicmp(gs_entry[i].name, name, APP_DNS_NAME_LEN) == 0))
+        {
+            return &gs_entry[i];
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief  app dns allocate an entry
+ * @return pointer to the entry, NULL if all the entries wait for an answer
+ * @note   a free entry is taken first, then the least recently used one
+ */
+static app_dns_entry_t *a_app_dns_alloc(void)
+{
+    app_dns_entry_t *lru = NULL;
+    uint32_t i;
+    
+    for (i = 0; i < APP_DNS_CACHE_SIZE; i++)
+    {
+        if (gs_entry[i].state == APP_DNS_FREE)
+        {
+            return &gs_entry[i];
+        }
+        if ((gs_entry[i].state == APP_DNS_VALID) && ((lru == NULL) || ((int32_t)(gs_entry[i].use - lru->use) < 0)))
+        {
+            lru = &gs_entry[i];
+        }
+    }
+    if (lru != NULL)
+    {
+        gs_stats.evictions++;
+        lru->state = APP_DNS_FREE;
+    }
+    
+    return lru;
+}
+
+/**
+ * @brief     app dns lwip found callback
+ * @param[in] *name pointer to the host name
+ * @param[in] *ipaddr pointer to the address, NULL on a failure
+ * @param[in] *arg pointer to the entry
+ * @note      none
+ */
+static void a_app_dns_found(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+    app_dns_entry_t *entry = (app_dns_entry_t *)arg;
+    uint32_t now = HAL_GetTick();
+    uint32_t latency;
+    uint32_t i;
+    
+    (void)name;
+    
+    /* the entry may have been flushed or answered by an earlier callback */
+    if (entry->state != APP_DNS_PENDING)
+    {
+        return;
+    }
+    latency = now - entry->start;
+    if (ipaddr != NULL)
+    {
+        gs_stats.answers++;
+        gs_stats.latency_sum += latency;
+        if (latency > gs_stats.latency_max)
+        {
+            gs_stats.latency_max = latency;
+        }
+        ip_addr_copy(entry->addr, *ipaddr);
+        entry->hits = 0;
+        entry->state = APP_DNS_VALID;
+    }
+    else
+    {
+        gs_stats.failures++;
+        entry->state = APP_DNS_FREE;
+    }
+    
+    /* complete the waiting callbacks */
+    for (i = 0; i < APP_DNS_REQUEST_CNT; i++)
+    {
+        if (gs_request[i].entry == entry)
+        {
+            gs_request[i].entry = NULL;
+            gs_request[i].callback(entry->name, ipaddr, gs_request[i].arg);
+        }
+    }
+}
+
+/**
+ * @brief     app dns ask lwip for a name
+ * @param[in] *entry pointer to an entry
+ * @return    lwip error code
+ *            - ERR_OK the record is valid, the address is in the entry
+ *            - ERR_INPROGRESS the record is not in the lwip table or its ttl has run out, the entry waits
+ *              for the answer
+ * @note      lwip keeps each record in its table for the record ttl, so it decides whether a cached
+ *            address may still be used
+ */
+static err_t a_app_dns_query(app_dns_entry_t *entry)
+{
+    ip_addr_t addr;
+    err_t err;
+    
+    err = dns_gethostbyname(entry->name, &addr, a_app_dns_found, entry);
+    if (err == ERR_OK)
+    {
+        /* answered from the lwip table or from the local host list */
+        ip_addr_copy(entry->addr, addr);
+        entry->state = APP_DNS_VALID;
+    }
+    else if (err == ERR_INPROGRESS)
+    {
+        entry->state = APP_DNS_PENDING;
+        entry->start = HAL_GetTick();
+    }
+    else
+    {
+        entry->state = APP_DNS_FREE;
+    }
+    
+    return err;
+}
+
+/**
+ * @brief     app dns prefetch the used names
+ * @param[in] *arg unused
+ * @note      a name used since its last answer is queried again as soon as lwip drops its record
+ */
+static void a_app_dns_prefetch(void *arg)
+{
+    uint32_t i;
+    
+    (void)arg;
+    
+    for (i = 0; i < APP_DNS_CACHE_SIZE; i++)
+    {
+        if ((gs_entry[i].state != APP_DNS_VALID) || (gs_entry[i].hits == 0))
+        {
+            continue;
+        }
+        if (a_app_dns_query(&gs_entry[i]) == ERR_INPROGRESS)
+        {
+            gs_stats.prefetches++;
+        }
+    }
+}
+
+/**
+ * @brief app dns init
+ * @note  the prefetch runs from the lwip server timer wheel
+ */
+void app_dns_init(void)
+{
+    memset(gs_entry, 0, sizeof(gs_entry));
+    memset(gs_request, 0, sizeof(gs_request));
+    timer_wheel_add(lwip_server_get_wheel(), &gs_prefetch_timer, 1000, 1000, a_app_dns_prefetch, NULL);
+}
+
+/**
+ * @brief      app dns resolve a name
+ * @param[in]  *name pointer to a host name
+ * @param[out] *addr pointer to an address buffer
+ * @param[in]  callback called with the answer if the name is not cached
+ * @param[in]  *arg callback argument
+ * @return     status code
+ *             - ERR_OK the address is in addr
+ *             - ERR_INPROGRESS the callback is called later
+ *             - other the name can not be resolved
+ * @note       none
+ */
+err_t app_dns_resolve(const char *name, ip_addr_t *addr, app_dns_callback_t callback, void *arg)
+{
+    app_dns_entry_t *entry;
+    err_t err;
+    uint32_t i;
+    
+    if ((name == NULL) || (addr == NULL) || (callback == NULL) || (strlen(name) >= APP_DNS_NAME_LEN))
+    {
+        return ERR_ARG;
+    }
+    
+    /* an address literal is not cached */
+    if (ipaddr_aton(name, addr) != 0)
+    {
+        return ERR_OK;
+    }
+    gs_stats.lookups++;
+    
+    /* a request slot holds the callback of a name which waits for the server */
+    for (i = 0; i < APP_DNS_REQUEST_CNT; i++)
+    {
+        if (gs_request[i].entry == NULL)
+        {
+            break;
+        }
+    }
+    
+    /* a cached name is a hit while lwip still holds its record */
+    entry = a_app_dns_find(name);
+    if ((entry != NULL) && (entry->state == APP_DNS_VALID))
+    {
+        entry->use = ++gs_use;
+        err = a_app_dns_query(entry);
+        if (err == ERR_OK)
+        {
+            gs_stats.hits++;
+            entry->hits++;
+            ip_addr_copy(*addr, entry->addr);
+            
+            return ERR_OK;
+        }
+        
+        /* the record has expired, the entry is filled by the new query without a callback if no slot is free */
+        gs_stats.misses++;
+        if (err != ERR_INPROGRESS)
+        {
+            return err;
+        }
+        if (i == APP_DNS_REQUEST_CNT)
+        {
+            return ERR_MEM;
+        }
+    }
+    else
+    {
+        if (i == APP_DNS_REQUEST_CNT)
+        {
+            return ERR_MEM;
+        }
+        if (entry == NULL)
+        {
+            entry = a_app_dns_alloc();
+            if (entry == NULL)
+            {
+                return ERR_MEM;
+            }
+            gs_stats.misses++;
+            strcpy(entry->name, name);
+            entry->use = ++gs_use;
+            err = a_app_dns_query(entry);
+            if (err == ERR_OK)
+            {
+                /* answered at once */
+                ip_addr_copy(*addr, entry->addr);
+                
+                return ERR_OK;
+            }
+            if (err != ERR_INPROGRESS)
+            {
+                return err;
+            }
+        }
+    }
+    
+    /* wait for the query in flight */
+    gs_request[i].entry = entry;
+    gs_request[i].callback = callback;
+    gs_request[i].arg = arg;
+    
+    return ERR_INPROGRESS;
+}
+
+/**
+ * @brief app dns flush the cache
+ * @note  names waiting for an answer are kept
+ */
+void app_dns_flush(void)
+{
+    uint32_t i;
+    
+    for (i = 0; i < APP_DNS_CACHE_SIZE; i++)
+    {
+        if (gs_entry[i].state == APP_DNS_VALID)
+        {
+            gs_entry[i].state = APP_DNS_FREE;
+        }
+    }
+}
+
+/**
+ * @brief      app dns get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_dns_get_stats(app_dns_stats_t *stats)
+{
+    *stats = gs_stats;
+}
+
+/**
+ * @brief app dns reset the stats
+ */
+void app_dns_reset_stats(void)
+{
+    memset(&gs_stats, 0, sizeof(gs_stats));
+}
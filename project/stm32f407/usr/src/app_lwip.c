@@ -36,6 +36,11 @@
 
 #include "app_lwip.h"
 
+/* dhcp_start_reboot() writes the struct dhcp and relies on the dhcp state machine of lwip 2.1 */
+#if LWIP_DHCP && ((LWIP_VERSION_MAJOR != 2) || (LWIP_VERSION_MINOR != 1))
+  #error "check dhcp_start_reboot() against the new lwip dhcp before the upgrade"
+#endif
+
 /*static IP ADDRESS: IP_ADDR0.IP_ADDR1.IP_ADDR2.IP_ADDR3 */
 #define IP_ADDR0   (uint8_t) 192
 #define IP_ADDR1   (uint8_t) 168
@@ -62,13 +67,49 @@
 #define DHCP_TIMEOUT               (uint8_t) 4
 #define DHCP_LINK_DOWN             (uint8_t) 5
 
+/* periodic work */
+#define LINK_TIMER_MSECS           100
+#define STATS_TIMER_MSECS          1000
+#define ARP_TIMER_MSECS            100
+#define ARP_ANNOUNCE_MSECS         2000
+
 #if LWIP_DHCP
   #define MAX_DHCP_TRIES  4
-  uint32_t DHCPfineTimer = 0;
   uint8_t DHCP_state = DHCP_OFF;
+  static timer_wheel_timer_t gs_dhcp_timer;
+  static lwip_server_lease_load_t gs_lease_load = NULL;
+  static lwip_server_lease_save_t gs_lease_save = NULL;
+  static lwip_server_lease_clock_t gs_lease_clock = NULL;
+  static uint8_t gs_dhcp_started = 0;
+  static uint8_t gs_dhcp_reboot = 0;
+  static uint32_t gs_dhcp_tick;
+  static uint32_t gs_dhcp_bound_tick;
+  static uint32_t gs_link_down_tick;
+  static uint16_t gs_lease_used;
+  static uint32_t gs_lease_addr;
 #endif
 struct netif g_netif;
-uint32_t ethernet_link_timer;
+static timer_wheel_t gs_wheel;
+#if LWIP_NETIF_LINK_CALLBACK
+static timer_wheel_timer_t gs_link_timer;
+#endif
+static timer_wheel_timer_t gs_stats_timer;
+static uint32_t gs_stats_rx_frames;
+static uint32_t gs_stats_tx_frames;
+static uint32_t gs_stats_rx_bytes;
+static uint32_t gs_stats_tx_bytes;
+static lwip_server_rate_t gs_rate;
+static timer_wheel_timer_t gs_arp_timer;
+static ip4_addr_t gs_arp_peer[LWIP_SERVER_ARP_PEER_CNT];
+static uint8_t gs_arp_peer_cnt = 0;
+static uint32_t gs_arp_tick;
+static uint8_t gs_arp_announce;
+static uint8_t gs_arp_gateway_wait;
+static lwip_server_arp_stats_t gs_arp_stats;
+#if LWIP_SERVER_WATCHDOG_MS
+static IWDG_HandleTypeDef gs_iwdg;
+static timer_wheel_timer_t gs_watchdog_timer;
+#endif
 
 /**
  * @brief netif get handle
@@ -79,24 +120,136 @@ struct netif *netif_get_handle(void)
     return &g_netif;
 }
 
+/**
+ * @brief ethernet arp periodic check
+ * @param arg pointer to the netif
+ */
+static void ethernet_arp_periodic_handle(void *arg)
+{
+    struct netif *netif = (struct netif *)arg;
+    struct eth_addr *eth;
+    const ip4_addr_t *ip;
+    uint32_t elapsed = HAL_GetTick() - gs_arp_tick;
+    
+    /* first packet to the gateway no longer waits for arp */
+    if (gs_arp_gateway_wait != 0)
+    {
+        if (etharp_find_addr(netif, netif_ip4_gw(netif), &eth, &ip) >= 0)
+        {
+            gs_arp_stats.gateway_ms = elapsed;
+            gs_arp_gateway_wait = 0;
+        }
+        else if (elapsed >= ARP_ANNOUNCE_MSECS)
+        {
+            gs_arp_stats.gateway_timeouts++;
+            gs_arp_gateway_wait = 0;
+        }
+    }
+    
+    /* repeat the announcement, lwip sent the first one */
+    if ((gs_arp_announce != 0) &&
+        (elapsed >= ARP_ANNOUNCE_MSECS * (uint32_t)(LWIP_SERVER_ARP_ANNOUNCE - gs_arp_announce + 1)))
+    {
+        (void)etharp_gratuitous(netif);
+        gs_arp_stats.announces++;
+        gs_arp_announce--;
+    }
+    
+    if ((gs_arp_gateway_wait == 0) && (gs_arp_announce == 0))
+    {
+        timer_wheel_remove(&gs_wheel, &gs_arp_timer);
+    }
+}
+
+/**
+ * @brief ethernet arp start on link up or a new address
+ * @param *netif pointer to a netif struct
+ */
+static void ethernet_arp_start(struct netif *netif)
+{
+    uint8_t i;
+    
+    if (!netif_is_link_up(netif) || ip4_addr_isany(netif_ip4_addr(netif)))
+    {
+        return;
+    }
+    
+    /* resolve the gateway and the peers before the first packet needs them */
+    gs_arp_tick = HAL_GetTick();
+    gs_arp_gateway_wait = 0;
+    if (!ip4_addr_isany(netif_ip4_gw(netif)))
+    {
+        (void)etharp_query(netif, netif_ip4_gw(netif), NULL);
+        gs_arp_stats.prewarms++;
+        gs_arp_gateway_wait = 1;
+    }
+    for (i = 0; i < gs_arp_peer_cnt; i++)
+    {
+        (void)etharp_query(netif, &gs_arp_peer[i], NULL);
+        gs_arp_stats.prewarms++;
+    }
+    gs_arp_announce = LWIP_SERVER_ARP_ANNOUNCE;
+    timer_wheel_add(&gs_wheel, &gs_arp_timer, ARP_TIMER_MSECS, ARP_TIMER_MSECS,
+                    ethernet_arp_periodic_handle, netif);
+}
+
+/**
+ * @brief ethernet status updated
+ * @param *netif pointer to a netif struct
+ */
+static void ethernet_status_updated(struct netif *netif)
+{
+    /* a new address is announced again and the gateway resolved */
+    ethernet_arp_start(netif);
+#if LWIP_DHCP
+    
+    /* the ack sets the address, time to ip ends here and not on the next dhcp_process */
+    if (!ip4_addr_isany_val(*netif_ip4_addr(netif)))
+    {
+        gs_dhcp_bound_tick = HAL_GetTick();
+    }
+#endif
+}
+
 /**
  * @brief ethernet link status updated
  * @param *netif pointer to a netif struct
  */
 static void ethernet_link_status_updated(struct netif *netif)
 {
+#if LWIP_DHCP
+  struct dhcp *dhcp;
+  ip4_addr_t any;
+#endif /* LWIP_DHCP */
+  
   if (netif_is_link_up(netif))
   {
 #if LWIP_DHCP
     /* Update DHCP state machine */
     DHCP_state = DHCP_START;
+    gs_dhcp_tick = HAL_GetTick();
+    
+    /* netif_set_link_up() has already sent the init-reboot request of a bound, renewing
+     * or rebooting client, the path is decided now as the ack may be in before dhcp_process */
+    dhcp = (struct dhcp *)netif_get_client_data(netif, LWIP_NETIF_CLIENT_DATA_INDEX_DHCP);
+    if ((gs_dhcp_started == 0) && (dhcp != NULL))
+    {
+      gs_dhcp_reboot = (dhcp->state == DHCP_STATE_REBOOTING) ? 1 : 0;
+      if ((gs_dhcp_reboot != 0) && ((gs_dhcp_tick - gs_link_down_tick) > LWIP_SERVER_FLAP_HOLD_MS))
+      {
+        ip4_addr_set_zero(&any);
+        netif_set_addr(netif, &any, &any, &any);
+      }
+    }
 #endif /* LWIP_DHCP */
+    ethernet_arp_start(netif);
   }
   else
   {
 #if LWIP_DHCP
-    /* Update DHCP state machine */
+    /* Update DHCP state machine, the address is kept */
     DHCP_state = DHCP_LINK_DOWN;
+    gs_link_down_tick = HAL_GetTick();
 #endif /* LWIP_DHCP */
   }
 }
@@ -104,21 +257,33 @@ static void ethernet_link_status_updated(struct netif *netif)
 #if LWIP_NETIF_LINK_CALLBACK
 /**
  * @brief  Ethernet Link periodic check
- * @param  netif
+ * @param  arg pointer to the netif
  * @retval None
  */
-static void ethernet_link_periodic_handle(struct netif *netif)
+static void ethernet_link_periodic_handle(void *arg)
 {
   /* Ethernet Link every 100ms */
-  if (HAL_GetTick() - ethernet_link_timer >= 100)
-  {
-    ethernet_link_timer = HAL_GetTick();
-    ethernet_link_check_state(netif);
-  }
+  ethernet_link_check_state((struct netif *)arg);
 }
 #endif
 
 #if LWIP_DHCP
+/**
+ * @brief  DHCP lease time left
+ * @param  time lease time in seconds
+ * @param  elapsed seconds elapsed
+ * @retval seconds left, 0 if the time has run out
+ */
+static uint32_t dhcp_lease_left(uint32_t time, uint32_t elapsed)
+{
+  if (time == 0xFFFFFFFFUL)
+  {
+    return time;
+  }
+  
+  return (time > elapsed) ? (time - elapsed) : 0;
+}
+
 /**
  * @brief  DHCP_Process_Handle
  * @param  None
@@ -136,11 +301,37 @@ static void dhcp_process(struct netif *netif)
   {
     case DHCP_START:
     {
-      lan8720_interface_debug_print("state: looking for dhcp server ...\n");
-      ip_addr_set_zero_ip4(&netif->ip_addr);
-      ip_addr_set_zero_ip4(&netif->netmask);
-      ip_addr_set_zero_ip4(&netif->gw);
-      dhcp_start(netif);
+      dhcp = (struct dhcp *)netif_get_client_data(netif, LWIP_NETIF_CLIENT_DATA_INDEX_DHCP);
+      if (gs_dhcp_started != 0)
+      {
+        /* the first link up runs the client started by netif_config */
+        gs_dhcp_started = 0;
+      }
+      else if (gs_dhcp_reboot != 0)
+      {
+        /* the lease is confirmed by the link up callback, the gratuitous arp is already out */
+        sprintf((char *)iptxt, "%s", ip4addr_ntoa(&dhcp->offered_ip_addr));
+        if ((gs_dhcp_tick - gs_link_down_tick) > LWIP_SERVER_FLAP_HOLD_MS)
+        {
+          lan8720_interface_debug_print("state: link back after %u ms, requesting %s again ...\n",
+                                        (unsigned int)(gs_dhcp_tick - gs_link_down_tick), iptxt);
+        }
+        else
+        {
+          lan8720_interface_debug_print("state: link back after %u ms, keeping %s ...\n",
+                                        (unsigned int)(gs_dhcp_tick - gs_link_down_tick), iptxt);
+        }
+      }
+      else
+      {
+        /* no lease is held, the client starts over with discover */
+        lan8720_interface_debug_print("state: looking for dhcp server ...\n");
+        ip_addr_set_zero_ip4(&netif->ip_addr);
+        ip_addr_set_zero_ip4(&netif->netmask);
+        ip_addr_set_zero_ip4(&netif->gw);
+        gs_dhcp_reboot = 0;
+        dhcp_start(netif);
+      }
       DHCP_state = DHCP_WAIT_ADDRESS;
     }
     break;
@@ -152,6 +343,14 @@ static void dhcp_process(struct netif *netif)
         DHCP_state = DHCP_ADDRESS_ASSIGNED;
         sprintf((char *)iptxt, "%s", ip4addr_ntoa(netif_ip4_addr(netif)));
         lan8720_interface_debug_print("ip address assigned by a dhcp server: %s\n", iptxt);
+        if ((int32_t)(gs_dhcp_bound_tick - gs_dhcp_tick) < 0)
+        {
+          /* a kept address is not set again */
+          gs_dhcp_bound_tick = HAL_GetTick();
+        }
+        lan8720_interface_debug_print("time to ip: %u ms (%s).\n", (unsigned int)(gs_dhcp_bound_tick - gs_dhcp_tick),
+                                      (gs_dhcp_reboot != 0) ? "init-reboot" : "discover");
+        gs_dhcp_reboot = 0;
       }
       else
       {
@@ -182,22 +381,153 @@ static void dhcp_process(struct netif *netif)
     break;
   default: break;
   }
+  
+  /* persist every new lease, lease_used restarts on each ack */
+  dhcp = (struct dhcp *)netif_get_client_data(netif, LWIP_NETIF_CLIENT_DATA_INDEX_DHCP);
+  if ((gs_lease_save != NULL) && (dhcp != NULL) && (dhcp->state == DHCP_STATE_BOUND) &&
+      ((dhcp->lease_used < gs_lease_used) || (ip4_addr_get_u32(&dhcp->offered_ip_addr) != gs_lease_addr)))
+  {
+    lwip_server_lease_t lease;
+    uint32_t used = (uint32_t)dhcp->lease_used * DHCP_COARSE_TIMER_SECS;
+    
+    /* the times left with the time stamp, an infinite lease stays infinite */
+    lease.addr = ip4_addr_get_u32(&dhcp->offered_ip_addr);
+    lease.netmask = ip4_addr_get_u32(&dhcp->offered_sn_mask);
+    lease.gw = ip4_addr_get_u32(&dhcp->offered_gw_addr);
+    lease.server = ip4_addr_get_u32(ip_2_ip4(&dhcp->server_ip_addr));
+    lease.lease = dhcp_lease_left(dhcp->offered_t0_lease, used);
+    lease.t1 = dhcp_lease_left(dhcp->offered_t1_renew, used);
+    lease.t2 = dhcp_lease_left(dhcp->offered_t2_rebind, used);
+    if ((gs_lease_clock == NULL) || (gs_lease_clock(&lease.time) != 0))
+    {
+      /* a lease which can not be aged is not requested again */
+      lease.lease = 0;
+      lease.time = 0;
+    }
+    if (gs_lease_save(&lease) != 0)
+    {
+      lan8720_interface_debug_print("dhcp lease save failed.\n");
+    }
+    gs_lease_addr = lease.addr;
+  }
+  if (dhcp != NULL)
+  {
+    gs_lease_used = (dhcp->state == DHCP_STATE_BOUND) ? dhcp->lease_used : 0xFFFFU;
+  }
 }
 
 /**
- * @brief  DHCP periodic check
+ * @brief  DHCP start with the stored lease
  * @param  netif
  * @retval None
  */
-static void dhcp_periodic_handle(struct netif *netif)
+static void dhcp_start_reboot(struct netif *netif)
 {
-  /* Fine DHCP periodic process every 500ms */
-  if (HAL_GetTick() - DHCPfineTimer >= DHCP_FINE_TIMER_MSECS)
+  struct dhcp *dhcp;
+  lwip_server_lease_t lease;
+  uint32_t now;
+  
+  /* the link is still down, the client waits in init for the link up */
+  netif_set_up(netif);
+  if (dhcp_start(netif) != ERR_OK)
+  {
+    return;
+  }
+  gs_dhcp_started = 1;
+  gs_lease_used = 0xFFFFU;
+  gs_lease_addr = 0;
+  lan8720_interface_debug_print("state: looking for dhcp server ...\n");
+  
+  /* a stored lease which has not expired is requested again with init-reboot,
+   * a clock behind the save time was reset and counts as expired */
+  if ((gs_lease_load == NULL) || (gs_lease_clock == NULL) || (gs_lease_load(&lease) != 0) || (lease.addr == 0))
   {
-    DHCPfineTimer =  HAL_GetTick();
-    /* process DHCP state machine */
-    dhcp_process(netif);
+    return;
   }
+  if ((gs_lease_clock(&now) != 0) || (dhcp_lease_left(lease.lease, now - lease.time) == 0))
+  {
+    lan8720_interface_debug_print("state: the stored lease has expired.\n");
+    
+    return;
+  }
+  lease.lease = dhcp_lease_left(lease.lease, now - lease.time);
+  lease.t1 = dhcp_lease_left(lease.t1, now - lease.time);
+  lease.t2 = dhcp_lease_left(lease.t2, now - lease.time);
+  dhcp = (struct dhcp *)netif_get_client_data(netif, LWIP_NETIF_CLIENT_DATA_INDEX_DHCP);
+  
+  /* lwip 2.1 has no public init-reboot entry, dhcp_renew() leaves init and
+   * dhcp_network_changed() moves the renewing client to rebooting, both
+   * requests are dropped as the mac only starts at the link up */
+  ip4_addr_set_u32(&dhcp->offered_ip_addr, lease.addr);
+  (void)dhcp_renew(netif);
+  dhcp_network_changed(netif);
+  ip4_addr_set_u32(&dhcp->offered_sn_mask, lease.netmask);
+  ip4_addr_set_u32(&dhcp->offered_gw_addr, lease.gw);
+  ip_addr_set_ip4_u32_val(dhcp->server_ip_addr, lease.server);
+  
+  /* netif_set_link_up() calls dhcp_network_changed(), which sends the
+   * init-reboot request for the stored address at once */
+  gs_dhcp_reboot = 1;
+  gs_lease_addr = lease.addr;
+  lan8720_interface_debug_print("state: requesting the stored lease %s, %u s left, renew in %u s, rebind in %u s ...\n",
+                                ip4addr_ntoa(&dhcp->offered_ip_addr), (unsigned int)lease.lease,
+                                (unsigned int)lease.t1, (unsigned int)lease.t2);
+}
+
+/**
+ * @brief  DHCP periodic check
+ * @param  arg pointer to the netif
+ * @retval None
+ */
+static void dhcp_periodic_handle(void *arg)
+{
+  /* Fine DHCP periodic process every 500ms */
+  dhcp_process((struct netif *)arg);
+}
+#endif
+
+/**
+ * @brief  Interface statistics sampling
+ * @param  arg pointer to the netif
+ * @retval None
+ */
+static void stats_periodic_handle(void *arg)
+{
+    const ethernetif_stats_t *stats;
+    
+    (void)arg;
+    
+    /* the counters are free running, the deltas over one period are the rates */
+    stats = ethernetif_get_stats();
+    if ((stats->rx_frames < gs_stats_rx_frames) || (stats->tx_frames < gs_stats_tx_frames))
+    {
+        /* the statistics were reset, restart from the new baseline */
+        gs_stats_rx_frames = 0;
+        gs_stats_tx_frames = 0;
+        gs_stats_rx_bytes = 0;
+        gs_stats_tx_bytes = 0;
+    }
+    gs_rate.rx_frames = stats->rx_frames - gs_stats_rx_frames;
+    gs_rate.tx_frames = stats->tx_frames - gs_stats_tx_frames;
+    gs_rate.rx_bytes = stats->rx_bytes - gs_stats_rx_bytes;
+    gs_rate.tx_bytes = stats->tx_bytes - gs_stats_tx_bytes;
+    gs_stats_rx_frames = stats->rx_frames;
+    gs_stats_tx_frames = stats->tx_frames;
+    gs_stats_rx_bytes = stats->rx_bytes;
+    gs_stats_tx_bytes = stats->tx_bytes;
+}
+
+#if LWIP_SERVER_WATCHDOG_MS
+/**
+ * @brief  Watchdog refresh
+ * @param  arg unused
+ * @retval None
+ */
+static void watchdog_periodic_handle(void *arg)
+{
+    (void)arg;
+    
+    (void)HAL_IWDG_Refresh(&gs_iwdg);
 }
 #endif
 
@@ -231,6 +561,133 @@ void netif_config(void)
 #if LWIP_NETIF_LINK_CALLBACK
     netif_set_link_callback(&g_netif, ethernet_link_status_updated);
 #endif
+#if LWIP_NETIF_STATUS_CALLBACK
+    netif_set_status_callback(&g_netif, ethernet_status_updated);
+#endif
+    
+#if LWIP_DHCP
+    dhcp_start_reboot(&g_netif);
+#endif
+    
+    /* register the periodic work */
+    timer_wheel_init(&gs_wheel, HAL_GetTick());
+#if LWIP_NETIF_LINK_CALLBACK
+    timer_wheel_add(&gs_wheel, &gs_link_timer, LINK_TIMER_MSECS, LINK_TIMER_MSECS,
+                    ethernet_link_periodic_handle, &g_netif);
+#endif
+#if LWIP_DHCP
+    timer_wheel_add(&gs_wheel, &gs_dhcp_timer, DHCP_FINE_TIMER_MSECS, DHCP_FINE_TIMER_MSECS,
+                    dhcp_periodic_handle, &g_netif);
+#endif
+    timer_wheel_add(&gs_wheel, &gs_stats_timer, STATS_TIMER_MSECS, STATS_TIMER_MSECS,
+                    stats_periodic_handle, &g_netif);
+#if LWIP_SERVER_WATCHDOG_MS
+    /* lsi 32khz / 256, the 4095 reload gives about 32s */
+    gs_iwdg.Instance = IWDG;
+    gs_iwdg.Init.Prescaler = IWDG_PRESCALER_256;
+    gs_iwdg.Init.Reload = 4095;
+    if (HAL_IWDG_Init(&gs_iwdg) == HAL_OK)
+    {
+        timer_wheel_add(&gs_wheel, &gs_watchdog_timer, LWIP_SERVER_WATCHDOG_MS, LWIP_SERVER_WATCHDOG_MS,
+                        watchdog_periodic_handle, NULL);
+    }
+#endif
+}
+
+/**
+ * @brief     set the dhcp lease storage
+ * @param[in] load pointer to a lease load function, NULL disables init-reboot
+ * @param[in] save pointer to a lease save function, NULL disables the lease saving
+ * @param[in] clock pointer to a clock which keeps running over a reset, NULL disables init-reboot
+ * @note      call it before netif_config, a lease whose time has run out on the clock is not requested again
+ */
+void lwip_server_set_lease_storage(lwip_server_lease_load_t load, lwip_server_lease_save_t save,
+                                   lwip_server_lease_clock_t clock)
+{
+#if LWIP_DHCP
+    gs_lease_load = load;
+    gs_lease_save = save;
+    gs_lease_clock = clock;
+#else
+    (void)load;
+    (void)save;
+    (void)clock;
+#endif
+}
+
+/**
+ * @brief     add a peer resolved at link up
+ * @param[in] *addr pointer to the peer address
+ * @return    lwip error code
+ * @note      call it after netif_config
+ */
+err_t lwip_server_add_arp_peer(const ip4_addr_t *addr)
+{
+    if (gs_arp_peer_cnt >= LWIP_SERVER_ARP_PEER_CNT)
+    {
+        return ERR_MEM;
+    }
+    ip4_addr_copy(gs_arp_peer[gs_arp_peer_cnt], *addr);
+    gs_arp_peer_cnt++;
+    
+    /* resolve it now if the link is already up */
+    if (netif_is_link_up(&g_netif) && !ip4_addr_isany(netif_ip4_addr(&g_netif)))
+    {
+        (void)etharp_query(&g_netif, addr, NULL);
+        gs_arp_stats.prewarms++;
+    }
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     add a static arp entry for a fixed peer
+ * @param[in] *addr pointer to the peer address
+ * @param[in] *mac pointer to the peer mac address
+ * @return    lwip error code
+ * @note      call it after netif_config, the entry survives link flaps
+ */
+err_t lwip_server_add_static_arp(const ip4_addr_t *addr, const uint8_t mac[6])
+{
+#if ETHARP_SUPPORT_STATIC_ENTRIES
+    struct eth_addr eth;
+    
+    memcpy(eth.addr, mac, ETH_HWADDR_LEN);
+    
+    return etharp_add_static_entry(addr, &eth);
+#else
+    (void)addr;
+    (void)mac;
+    
+    return ERR_VAL;
+#endif
+}
+
+/**
+ * @brief      get the arp stats
+ * @param[out] *stats pointer to an arp stats structure
+ */
+void lwip_server_get_arp_stats(lwip_server_arp_stats_t *stats)
+{
+    *stats = gs_arp_stats;
+}
+
+/**
+ * @brief  get the wheel which runs the periodic work of the lwip server
+ * @return pointer to the timer wheel, the tick is HAL_GetTick()
+ */
+timer_wheel_t *lwip_server_get_wheel(void)
+{
+    return &gs_wheel;
+}
+
+/**
+ * @brief      get the interface rates of the last sampling period
+ * @param[out] *rate pointer to a rate structure
+ */
+void lwip_server_get_rate(lwip_server_rate_t *rate)
+{
+    *rate = gs_rate;
 }
 
 /**
@@ -238,15 +695,37 @@ void netif_config(void)
  */
 void lwip_server(void)
 {
+    /* Read the frames left by the rx interrupt */
+    (void)ethernetif_poll(&g_netif);
+
     /* Handle timeouts */
     sys_check_timeouts();
 
-#if LWIP_NETIF_LINK_CALLBACK
-    ethernet_link_periodic_handle(&g_netif);
-#endif
-
-#if LWIP_DHCP
-    dhcp_periodic_handle(&g_netif);
-#endif
+    /* link check, dhcp, statistics and watchdog */
+    timer_wheel_run(&gs_wheel, HAL_GetTick());
 }
 
+/**
+ * @brief  get the time until the next lwip server deadline
+ * @return milliseconds until lwip_server() has timed work to do
+ */
+uint32_t lwip_server_sleeptime(void)
+{
+    uint32_t sleep;
+    uint32_t elapsed;
+
+    /* lwip timeouts, the interface timers and the periodic work */
+    sleep = sys_timeouts_sleeptime();
+    elapsed = ethernetif_sleeptime();
+    if (elapsed < sleep)
+    {
+        sleep = elapsed;
+    }
+    elapsed = timer_wheel_sleeptime(&gs_wheel, HAL_GetTick());
+    if (elapsed < sleep)
+    {
+        sleep = elapsed;
+    }
+
+    return sleep;
+}
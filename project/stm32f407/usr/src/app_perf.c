@@ -0,0 +1,333 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_perf.c
+ * @brief     app perf source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_perf.h"
+#include "app_lwip.h"
+#include "lwip/stats.h"
+#include "lwip/tcp.h"
+#include <string.h>
+
+/**
+ * @brief app perf settings structure definition
+ * @note  the iperf 2 client header leads the stream, all the fields are big endian
+ */
+typedef struct app_perf_settings_s
+{
+    uint32_t flags;                     /**< answer test flags */
+    uint32_t num_threads;               /**< parallel streams */
+    uint32_t remote_port;               /**< port of an answer test */
+    uint32_t buffer_len;                /**< unused */
+    uint32_t win_band;                  /**< unused */
+    uint32_t amount;                    /**< bytes, negative values are a time in 10 ms */
+} app_perf_settings_t;
+
+/**
+ * @brief app perf client structure definition
+ */
+typedef struct app_perf_client_s
+{
+    struct tcp_pcb *pcb;                /**< connection, NULL if no client runs */
+    lwiperf_report_fn report_fn;        /**< report function */
+    void *report_arg;                   /**< report argument */
+    ip_addr_t local_addr;               /**< local address */
+    ip_addr_t remote_addr;              /**< server address */
+    uint16_t local_port;                /**< local port */
+    uint16_t remote_port;               /**< server port */
+    app_perf_settings_t settings;       /**< header */
+    uint32_t start;                     /**< connect tick */
+    uint32_t duration;                  /**< send time in ms */
+    uint32_t bytes;                     /**< bytes handed to tcp */
+    uint8_t poll_count;                 /**< polls without an ack */
+    uint8_t nrtx;                       /**< retransmissions of the pcb at the last poll */
+} app_perf_client_t;
+
+static app_perf_client_t gs_client;         /**< client */
+static uint32_t gs_timeouts;                /**< retransmission timeouts */
+static uint8_t gs_txbuf[TCP_MSS + 10];      /**< payload pattern, sent without a copy */
+
+/**
+ * @brief     app perf close the client
+ * @param[in] type report type
+ * @param[in] report 1 calls the report function
+ * @return    ERR_ABRT if the pcb was aborted, else ERR_OK
+ * @note      none
+ */
+static err_t a_app_perf_close(enum lwiperf_report_type type, uint8_t report)
+{
+    struct tcp_pcb *pcb = gs_client.pcb;
+    uint32_t ms;
+    err_t err = ERR_OK;
+    
+    gs_client.pcb = NULL;
+    if (pcb != NULL)
+    {
+        tcp_sent(pcb, NULL);
+        tcp_poll(pcb, NULL, 0);
+        tcp_err(pcb, NULL);
+        if (tcp_close(pcb) != ERR_OK)
+        {
+            /* don't wait for free memory */
+            tcp_abort(pcb);
+            err = ERR_ABRT;
+        }
+    }
+    if ((report != 0) && (gs_client.report_fn != NULL))
+    {
+        ms = HAL_GetTick() - gs_client.start;
+        gs_client.report_fn(gs_client.report_arg, type, &gs_client.local_addr, gs_client.local_port,
+                            &gs_client.remote_addr, gs_client.remote_port, gs_client.bytes, ms,
+                            (ms != 0) ? ((gs_client.bytes / ms) * 8U) : 0);
+    }
+    
+    return err;
+}
+
+/**
+ * @brief  app perf send until the send buffer is full
+ * @return lwip error code
+ * @note   none
+ */
+static err_t a_app_perf_send(void)
+{
+    struct tcp_pcb *pcb = gs_client.pcb;
+    uint16_t len;
+    
+    /* the send time is over */
+    if ((HAL_GetTick() - gs_client.start) >= gs_client.duration)
+    {
+        return a_app_perf_close(LWIPERF_TCP_DONE_CLIENT, 1);
+    }
+    
+    /* the header leads the stream */
+    if (gs_client.bytes < sizeof(app_perf_settings_t))
+    {
+        if (tcp_write(pcb, &gs_client.settings, sizeof(app_perf_settings_t),
+                      TCP_WRITE_FLAG_COPY | TCP_WRITE_FLAG_MORE) != ERR_OK)
+        {
+            return ERR_OK;
+        }
+        gs_client.bytes = sizeof(app_perf_settings_t);
+    }
+    
+    /* full segments of the pattern, the first one completes the header segment */
+    while (1)
+    {
+        len = (gs_client.bytes < TCP_MSS) ? (uint16_t)(TCP_MSS - gs_client.bytes) : TCP_MSS;
+        if ((tcp_sndbuf(pcb) < len) || (tcp_write(pcb, &gs_txbuf[gs_client.bytes % 10], len, 0) != ERR_OK))
+        {
+            break;
+        }
+        gs_client.bytes += len;
+    }
+    (void)tcp_output(pcb);
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     app perf connected callback
+ * @param[in] *arg unused
+ * @param[in] *tpcb pointer to the pcb
+ * @param[in] err always ERR_OK
+ * @return    lwip error code
+ * @note      none
+ */
+static err_t a_app_perf_connected(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    (void)arg;
+    (void)err;
+    
+    gs_client.start = HAL_GetTick();
+    gs_client.poll_count = 0;
+    gs_client.nrtx = tpcb->nrtx;
+    
+    return a_app_perf_send();
+}
+
+/**
+ * @brief     app perf sent callback
+ * @param[in] *arg unused
+ * @param[in] *tpcb pointer to the pcb
+ * @param[in] len acked bytes
+ * @return    lwip error code
+ * @note      none
+ */
+static err_t a_app_perf_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    (void)arg;
+    (void)len;
+    
+    /* the ack has reset nrtx */
+    gs_client.nrtx = tpcb->nrtx;
+    gs_client.poll_count = 0;
+    
+    return a_app_perf_send();
+}
+
+/**
+ * @brief     app perf poll callback
+ * @param[in] *arg unused
+ * @param[in] *tpcb pointer to the pcb
+ * @return    lwip error code
+ * @note      the slow timer polls right after a retransmission timeout, before an ack can reset nrtx
+ */
+static err_t a_app_perf_poll(void *arg, struct tcp_pcb *tpcb)
+{
+    (void)arg;
+    
+    if (tpcb->nrtx > gs_client.nrtx)
+    {
+        gs_timeouts += (uint32_t)(tpcb->nrtx - gs_client.nrtx);
+    }
+    gs_client.nrtx = tpcb->nrtx;
+    
+    /* one poll every 500 ms */
+    if (++gs_client.poll_count >= (APP_PERF_MAX_IDLE_S * 2U))
+    {
+        return a_app_perf_close(LWIPERF_TCP_ABORTED_LOCAL, 1);
+    }
+    if (tpcb->state != ESTABLISHED)
+    {
+        return ERR_OK;
+    }
+    
+    return a_app_perf_send();
+}
+
+/**
+ * @brief     app perf error callback
+ * @param[in] *arg unused
+ * @param[in] err lwip error code
+ * @note      the pcb is already freed
+ */
+static void a_app_perf_err(void *arg, err_t err)
+{
+    (void)arg;
+    (void)err;
+    
+    gs_client.pcb = NULL;
+    (void)a_app_perf_close(LWIPERF_TCP_ABORTED_REMOTE, 1);
+}
+
+/**
+ * @brief     app perf start a client
+ * @param[in] *remote_addr pointer to the server address
+ * @param[in] remote_port server port
+ * @param[in] duration_ms send time in ms
+ * @param[in] report_fn called once the client is done or aborted
+ * @param[in] *report_arg report argument
+ * @return    lwip error code
+ * @note      one client runs at a time, it talks iperf 2 like lwiperf_start_tcp_client,
+ *            which always sends for 10 s
+ */
+err_t app_perf_client_start(const ip_addr_t *remote_addr, uint16_t remote_port, uint32_t duration_ms,
+                            lwiperf_report_fn report_fn, void *report_arg)
+{
+    struct tcp_pcb *pcb;
+    uint32_t i;
+    err_t err;
+    
+    if ((remote_addr == NULL) || (duration_ms == 0))
+    {
+        return ERR_ARG;
+    }
+    if (gs_client.pcb != NULL)
+    {
+        return ERR_USE;
+    }
+    pcb = tcp_new_ip_type(IP_GET_TYPE(remote_addr));
+    if (pcb == NULL)
+    {
+        return ERR_MEM;
+    }
+    for (i = 0; i < sizeof(gs_txbuf); i++)
+    {
+        gs_txbuf[i] = (uint8_t)('0' + (i % 10));
+    }
+    memset(&gs_client, 0, sizeof(gs_client));
+    gs_client.settings.num_threads = lwip_htonl(1);
+    gs_client.settings.remote_port = lwip_htonl(LWIPERF_TCP_PORT_DEFAULT);
+    gs_client.settings.amount = lwip_htonl((uint32_t)(-(int32_t)(duration_ms / 10)));
+    gs_client.report_fn = report_fn;
+    gs_client.report_arg = report_arg;
+    gs_client.duration = duration_ms;
+    gs_client.start = HAL_GetTick();
+    ip_addr_copy(gs_client.remote_addr, *remote_addr);
+    gs_client.remote_port = remote_port;
+    
+    /* poll on every slow timer pass to catch each retransmission timeout */
+    tcp_sent(pcb, a_app_perf_sent);
+    tcp_poll(pcb, a_app_perf_poll, 1);
+    tcp_err(pcb, a_app_perf_err);
+    err = tcp_connect(pcb, remote_addr, remote_port, a_app_perf_connected);
+    if (err != ERR_OK)
+    {
+        (void)tcp_close(pcb);
+        
+        return err;
+    }
+    gs_client.pcb = pcb;
+    ip_addr_copy(gs_client.local_addr, pcb->local_ip);
+    gs_client.local_port = pcb->local_port;
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief app perf abort the client
+ * @note  the report function is not called
+ */
+void app_perf_client_abort(void)
+{
+    (void)a_app_perf_close(LWIPERF_TCP_ABORTED_LOCAL, 0);
+}
+
+/**
+ * @brief      app perf get the retransmissions
+ * @param[out] *rexmit pointer to a retransmission structure
+ * @note       both counters are free running
+ */
+void app_perf_get_rexmit(app_perf_rexmit_t *rexmit)
+{
+#if MIB2_STATS
+    rexmit->fast = lwip_stats.mib2.tcpretranssegs;
+    rexmit->fast_valid = 1;
+#else
+    rexmit->fast = 0;
+    rexmit->fast_valid = 0;
+#endif
+    rexmit->timeouts = gs_timeouts;
+}
@@ -0,0 +1,613 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_pktgen.c
+ * @brief     app pktgen source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_pktgen.h"
+#include "app_lwip.h"
+#include "trace.h"
+#include "lwip/memp.h"
+#include "lwip/udp.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/prot/ethernet.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/udp.h"
+#include <string.h>
+
+/**
+ * @brief app pktgen frame definition
+ */
+#define APP_PKTGEN_MAGIC       0x504B5447U        /**< "PKTG" after the ethernet header */
+#define APP_PKTGEN_FCS_LEN     4U                 /**< fcs added by the mac */
+#define APP_PKTGEN_UDP_LEN     (IP_HLEN + UDP_HLEN)  /**< ip and udp headers of the udp mode */
+
+/**
+ * @brief app pktgen state definition
+ */
+#define APP_PKTGEN_IDLE        0        /**< no run */
+#define APP_PKTGEN_SETTLE      1        /**< loopback set, waiting for the phy */
+#define APP_PKTGEN_SEND        2        /**< sending */
+#define APP_PKTGEN_DRAIN       3        /**< waiting for the frames in flight */
+
+/**
+ * @brief app pktgen header structure definition
+ * @note  network order, it follows the ethernet header
+ */
+typedef struct app_pktgen_hdr_s
+{
+    uint32_t magic;                     /**< APP_PKTGEN_MAGIC */
+    uint32_t run;                       /**< run id, a new id restarts the receiver */
+    uint32_t seq;                       /**< sequence number from 0 */
+    uint32_t stamp;                     /**< trace tick of the sender */
+} app_pktgen_hdr_t;
+
+/**
+ * @brief app pktgen buffer structure definition
+ */
+typedef struct app_pktgen_buf_s
+{
+    struct pbuf_custom pc;                                                  /**< custom pbuf */
+    uint8_t buf[(APP_PKTGEN_SIZE_MAX - APP_PKTGEN_FCS_LEN + 3) & ~3];      /**< frame without the fcs */
+} app_pktgen_buf_t;
+
+/* the pool only ever holds pktgen frames, the padding goes out as it is */
+LWIP_MEMPOOL_DECLARE(PKTGEN_POOL, APP_PKTGEN_FRAME_CNT, sizeof(app_pktgen_buf_t), "pktgen frame pool");
+
+static app_pktgen_config_t gs_config;           /**< run config */
+static app_pktgen_stats_t gs_stats;             /**< stats */
+static app_pktgen_report_t gs_report;           /**< report callback */
+static void *gs_report_arg;                     /**< report argument */
+static uint8_t gs_state;                        /**< run state */
+static uint32_t gs_tick;                        /**< state start tick */
+static uint32_t gs_run;                         /**< tx run id */
+static uint32_t gs_seq;                         /**< next tx sequence number */
+static uint32_t gs_in_flight;                   /**< frames owned by the interface */
+static uint8_t gs_rx_valid;                     /**< a stream is being received */
+static uint32_t gs_rx_run;                      /**< rx run id */
+static uint32_t gs_rx_next;                     /**< next expected rx sequence number */
+static uint32_t gs_rx_first;                    /**< tick of the first frame of the stream */
+static uint32_t gs_tick_per_us;                 /**< trace ticks in a microsecond */
+static struct udp_pcb *gs_udp_pcb;              /**< udp mode receiver */
+static uint8_t gs_udp_hdr[APP_PKTGEN_UDP_LEN];  /**< ip and udp headers of the run */
+static uint16_t gs_hdr_offset;                  /**< pktgen header offset in the frame */
+
+/**
+ * @brief     app pktgen frame free callback
+ * @param[in] *p pointer to the custom pbuf
+ * @note      called once the dma has sent the frame
+ */
+static void a_app_pktgen_free(struct pbuf *p)
+{
+    LWIP_MEMPOOL_FREE(PKTGEN_POOL, p);
+    gs_in_flight--;
+}
+
+/**
+ * @brief     app pktgen send a frame
+ * @param[in] *netif pointer to the netif
+ * @return    lwip error code, ERR_MEM if all the frames are in flight
+ * @note      the frame goes to linkoutput, the stack is not involved
+ */
+static err_t a_app_pktgen_send(struct netif *netif)
+{
+    app_pktgen_buf_t *b;
+    app_pktgen_hdr_t hdr;
+    struct pbuf *p;
+    err_t err;
+    
+    b = (app_pktgen_buf_t *)LWIP_MEMPOOL_ALLOC(PKTGEN_POOL);
+    if (b == NULL)
+    {
+        return ERR_MEM;
+    }
+    gs_in_flight++;
+    b->pc.custom_free_function = a_app_pktgen_free;
+    p = pbuf_alloced_custom(PBUF_RAW, (u16_t)(gs_config.size - APP_PKTGEN_FCS_LEN), PBUF_REF,
+                            &b->pc, b->buf, sizeof(b->buf));
+    
+    /* the ethernet header and the pktgen header, the payload is not touched */
+    memcpy(&b->buf[0], gs_config.dst, ETH_HWADDR_LEN);
+    memcpy(&b->buf[ETH_HWADDR_LEN], netif->hwaddr, ETH_HWADDR_LEN);
+    if (gs_config.udp != 0)
+    {
+        /* the headers are built once per run, the stack checks them on the way in */
+        b->buf[12] = (uint8_t)(ETHTYPE_IP >> 8);
+        b->buf[13] = (uint8_t)(ETHTYPE_IP & 0xFF);
+        memcpy(&b->buf[SIZEOF_ETH_HDR], gs_udp_hdr, APP_PKTGEN_UDP_LEN);
+    }
+    else
+    {
+        b->buf[12] = (uint8_t)(APP_PKTGEN_ETHTYPE >> 8);
+        b->buf[13] = (uint8_t)(APP_PKTGEN_ETHTYPE & 0xFF);
+    }
+    hdr.magic = lwip_htonl(APP_PKTGEN_MAGIC);
+    hdr.run = lwip_htonl(gs_run);
+    hdr.seq = lwip_htonl(gs_seq);
+    hdr.stamp = lwip_htonl(trace_get_tick());
+    memcpy(&b->buf[gs_hdr_offset], &hdr, sizeof(hdr));
+    err = netif->linkoutput(netif, p);
+    
+    /* the interface keeps its own reference */
+    pbuf_free(p);
+    
+    return err;
+}
+
+/**
+ * @brief     app pktgen build the ip and udp headers of the udp mode
+ * @param[in] *netif pointer to the netif
+ * @note      the ip id stays 0 with df set, the udp checksum is left to the mac or off
+ */
+static void a_app_pktgen_udp_header(struct netif *netif)
+{
+    struct ip_hdr *iphdr = (struct ip_hdr *)&gs_udp_hdr[0];
+    struct udp_hdr *udphdr = (struct udp_hdr *)&gs_udp_hdr[IP_HLEN];
+    uint16_t len = (uint16_t)(gs_config.size - APP_PKTGEN_FCS_LEN - SIZEOF_ETH_HDR);
+    
+    IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+    IPH_TOS_SET(iphdr, 0);
+    IPH_LEN_SET(iphdr, lwip_htons(len));
+    IPH_ID_SET(iphdr, 0);
+    IPH_OFFSET_SET(iphdr, PP_HTONS(IP_DF));
+    IPH_TTL_SET(iphdr, UDP_TTL);
+    IPH_PROTO_SET(iphdr, IP_PROTO_UDP);
+    IPH_CHKSUM_SET(iphdr, 0);
+    ip4_addr_copy(iphdr->src, *netif_ip4_addr(netif));
+    iphdr->dest.addr = (gs_config.ip != 0) ? gs_config.ip : ip4_addr_get_u32(netif_ip4_addr(netif));
+    IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, IP_HLEN));
+    udphdr->src = PP_HTONS(APP_PKTGEN_UDP_PORT);
+    udphdr->dest = PP_HTONS(APP_PKTGEN_UDP_PORT);
+    udphdr->len = lwip_htons((uint16_t)(len - IP_HLEN));
+    udphdr->chksum = 0;
+}
+
+/**
+ * @brief     app pktgen get the frames released by the rate
+ * @param[in] elapsed time since the send start in ms
+ * @return    sequence number up to which the frames may be sent
+ * @note      the credit is released a burst at a time
+ */
+static uint32_t a_app_pktgen_allowed(uint32_t elapsed)
+{
+    uint64_t allowed;
+    
+    if (gs_config.rate == 0)
+    {
+        allowed = 0xFFFFFFFFU;
+    }
+    else
+    {
+        allowed = ((uint64_t)gs_config.rate * elapsed / 1000U / gs_config.burst + 1U) * gs_config.burst;
+    }
+    if ((gs_config.count != 0) && (allowed > gs_config.count))
+    {
+        allowed = gs_config.count;
+    }
+    
+    return (allowed > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)allowed;
+}
+
+/**
+ * @brief     app pktgen end the send phase
+ * @param[in] now current tick
+ * @note      none
+ */
+static void a_app_pktgen_drain(uint32_t now)
+{
+    gs_stats.tx_ms = now - gs_tick;
+    gs_state = APP_PKTGEN_DRAIN;
+    gs_tick = now;
+}
+
+/**
+ * @brief app pktgen end the run
+ * @note  the loopback is released before the report
+ */
+static void a_app_pktgen_end(void)
+{
+    gs_state = APP_PKTGEN_IDLE;
+    if (gs_config.loopback != 0)
+    {
+        (void)ethernetif_set_loopback(netif_get_handle(), 0U);
+        
+        /* the sender knows the tail, the frames missing after the last one received count too */
+        if ((gs_rx_valid == 0) || (gs_rx_run != gs_run))
+        {
+            gs_stats.rx_frames = 0;
+            gs_stats.rx_bytes = 0;
+            gs_stats.rx_reordered = 0;
+            gs_stats.rx_ms = 0;
+            gs_stats.latency_cnt = 0;
+            gs_stats.latency_min = 0;
+            gs_stats.latency_max = 0;
+            gs_stats.latency_sum = 0;
+        }
+        gs_stats.rx_lost = (gs_seq > gs_stats.rx_frames) ? (gs_seq - gs_stats.rx_frames) : 0;
+    }
+    if (gs_report != NULL)
+    {
+        gs_report(&gs_stats, gs_report_arg);
+    }
+}
+
+/**
+ * @brief     app pktgen count a received frame
+ * @param[in] *p pointer to the received frame
+ * @param[in] offset pktgen header offset in p
+ * @param[in] bytes frame size with the fcs
+ * @param[in] own 1 if this board sent the frame
+ * @return    ERR_OK if it is a pktgen frame, ERR_VAL otherwise
+ * @note      the latency is only measured on the own frames, another board stamps its own clock
+ */
+static err_t a_app_pktgen_count(struct pbuf *p, uint16_t offset, uint32_t bytes, uint8_t own)
+{
+    app_pktgen_hdr_t hdr;
+    uint32_t stamp = trace_get_tick();
+    uint32_t now = HAL_GetTick();
+    uint32_t seq;
+    uint32_t latency;
+    
+    if ((pbuf_copy_partial(p, &hdr, sizeof(hdr), offset) != sizeof(hdr)) ||
+        (lwip_ntohl(hdr.magic) != APP_PKTGEN_MAGIC))
+    {
+        return ERR_VAL;
+    }
+    if ((gs_rx_valid == 0) || (lwip_ntohl(hdr.run) != gs_rx_run))
+    {
+        /* a new stream, the receiver restarts */
+        gs_rx_valid = 1;
+        gs_rx_run = lwip_ntohl(hdr.run);
+        gs_rx_next = 0;
+        gs_rx_first = now;
+        gs_stats.rx_frames = 0;
+        gs_stats.rx_bytes = 0;
+        gs_stats.rx_lost = 0;
+        gs_stats.rx_reordered = 0;
+        gs_stats.latency_cnt = 0;
+        gs_stats.latency_min = 0xFFFFFFFFU;
+        gs_stats.latency_max = 0;
+        gs_stats.latency_sum = 0;
+    }
+    gs_stats.rx_frames++;
+    gs_stats.rx_bytes += bytes;
+    gs_stats.rx_ms = now - gs_rx_first;
+    
+    /* a gap counts as lost until the missing frames turn up late */
+    seq = lwip_ntohl(hdr.seq);
+    if (seq >= gs_rx_next)
+    {
+        gs_stats.rx_lost += seq - gs_rx_next;
+        gs_rx_next = seq + 1U;
+    }
+    else
+    {
+        gs_stats.rx_reordered++;
+        if (gs_stats.rx_lost != 0)
+        {
+            gs_stats.rx_lost--;
+        }
+    }
+    if (own != 0)
+    {
+        latency = (uint32_t)((uint64_t)(stamp - lwip_ntohl(hdr.stamp)) * 1000U / gs_tick_per_us);
+        gs_stats.latency_cnt++;
+        gs_stats.latency_sum += latency;
+        if (latency < gs_stats.latency_min)
+        {
+            gs_stats.latency_min = latency;
+        }
+        if (latency > gs_stats.latency_max)
+        {
+            gs_stats.latency_max = latency;
+        }
+    }
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     app pktgen raw frame handler
+ * @param[in] *p pointer to a received frame with its ethernet header
+ * @param[in] *netif pointer to the receiving netif
+ * @param[in] *arg unused
+ * @return    ERR_OK if the frame was a pktgen frame and is freed, other values leave it to lwip
+ * @note      called by the ethernetif rx drain loop for APP_PKTGEN_ETHTYPE
+ */
+static err_t a_app_pktgen_input(struct pbuf *p, struct netif *netif, void *arg)
+{
+    struct eth_hdr *eth = (struct eth_hdr *)p->payload;
+    uint16_t offset = SIZEOF_ETH_HDR;
+    
+    LWIP_UNUSED_ARG(arg);
+    
+    if (eth->type == PP_HTONS(ETHTYPE_VLAN))
+    {
+        offset += SIZEOF_VLAN_HDR;
+    }
+    if (a_app_pktgen_count(p, offset, p->tot_len + APP_PKTGEN_FCS_LEN,
+                           (memcmp(eth->src.addr, netif->hwaddr, ETH_HWADDR_LEN) == 0) ? 1 : 0) != ERR_OK)
+    {
+        return ERR_VAL;
+    }
+    pbuf_free(p);
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief     app pktgen udp receive callback
+ * @param[in] *arg unused
+ * @param[in] *pcb pointer to the udp pcb
+ * @param[in] *p pointer to the udp payload
+ * @param[in] *addr pointer to the source address
+ * @param[in] port source port
+ * @note      the same stream as the raw frames, after ip and udp input
+ */
+static void a_app_pktgen_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    struct netif *netif = netif_get_handle();
+    
+    LWIP_UNUSED_ARG(arg);
+    LWIP_UNUSED_ARG(pcb);
+    LWIP_UNUSED_ARG(port);
+    
+    (void)a_app_pktgen_count(p, 0, p->tot_len + SIZEOF_ETH_HDR + APP_PKTGEN_UDP_LEN + APP_PKTGEN_FCS_LEN,
+                             ip4_addr_cmp(ip_2_ip4(addr), netif_ip4_addr(netif)) ? 1 : 0);
+    pbuf_free(p);
+}
+
+/**
+ * @brief app pktgen init
+ * @note  call it after netif_config, the raw frames are received by an ethernetif fast path handler
+ */
+void app_pktgen_init(void)
+{
+    LWIP_MEMPOOL_INIT(PKTGEN_POOL);
+    gs_state = APP_PKTGEN_IDLE;
+    gs_in_flight = 0;
+    gs_tick_per_us = trace_get_tick_per_us();
+    app_pktgen_reset_stats();
+    
+    /* the raw frames skip the stack, the udp mode goes through it for comparison */
+    (void)ethernetif_add_rx_handler(APP_PKTGEN_ETHTYPE, a_app_pktgen_input, NULL);
+    gs_udp_pcb = udp_new();
+    if (gs_udp_pcb != NULL)
+    {
+        (void)udp_bind(gs_udp_pcb, IP4_ADDR_ANY, APP_PKTGEN_UDP_PORT);
+        udp_recv(gs_udp_pcb, a_app_pktgen_udp_recv, NULL);
+    }
+}
+
+/**
+ * @brief     app pktgen start a run
+ * @param[in] *config pointer to a config structure
+ * @param[in] report called once the run ends
+ * @param[in] *arg report argument
+ * @return    status code
+ *            - ERR_OK the run is started
+ *            - ERR_VAL the config is invalid
+ *            - ERR_CONN the link is down or the udp mode has no address
+ *            - ERR_IF the loopback can not be set
+ * @note      a running run is stopped first, the tx stats restart
+ */
+err_t app_pktgen_start(const app_pktgen_config_t *config, app_pktgen_report_t report, void *arg)
+{
+    struct netif *netif = netif_get_handle();
+    uint32_t run;
+    
+    if ((config->size < APP_PKTGEN_SIZE_MIN) || (config->size > APP_PKTGEN_SIZE_MAX) ||
+        (config->burst == 0) || ((config->count == 0) && (config->duration_ms == 0)))
+    {
+        return ERR_VAL;
+    }
+    app_pktgen_stop();
+    if ((config->loopback == 0) && (!netif_is_link_up(netif)))
+    {
+        return ERR_CONN;
+    }
+    if ((config->udp != 0) && ((gs_udp_pcb == NULL) || ip4_addr_isany_val(*netif_ip4_addr(netif))))
+    {
+        return ERR_CONN;
+    }
+    if ((config->loopback != 0) && (ethernetif_set_loopback(netif, 1U) != ERR_OK))
+    {
+        return ERR_IF;
+    }
+    gs_config = *config;
+    gs_hdr_offset = SIZEOF_ETH_HDR;
+    if (config->udp != 0)
+    {
+        a_app_pktgen_udp_header(netif);
+        gs_hdr_offset += APP_PKTGEN_UDP_LEN;
+    }
+    gs_report = report;
+    gs_report_arg = arg;
+    gs_stats.tx_frames = 0;
+    gs_stats.tx_bytes = 0;
+    gs_stats.tx_busy = 0;
+    gs_stats.tx_errors = 0;
+    gs_stats.tx_ms = 0;
+    
+    /* the trace tick gives a run id which differs across the runs and the boards */
+    run = trace_get_tick();
+    gs_run = (run == gs_run) ? (run + 1U) : run;
+    gs_seq = 0;
+    gs_state = (config->loopback != 0) ? APP_PKTGEN_SETTLE : APP_PKTGEN_SEND;
+    gs_tick = HAL_GetTick();
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief app pktgen stop the run
+ * @note  the report is called at once
+ */
+void app_pktgen_stop(void)
+{
+    if (gs_state == APP_PKTGEN_IDLE)
+    {
+        return;
+    }
+    if (gs_state == APP_PKTGEN_SEND)
+    {
+        gs_stats.tx_ms = HAL_GetTick() - gs_tick;
+    }
+    a_app_pktgen_end();
+}
+
+/**
+ * @brief app pktgen send the frames which are due
+ * @note  call it from the main loop after lwip_server
+ */
+void app_pktgen_poll(void)
+{
+    struct netif *netif = netif_get_handle();
+    uint32_t now = HAL_GetTick();
+    uint32_t allowed;
+    err_t err;
+    
+    if (gs_state == APP_PKTGEN_SETTLE)
+    {
+        if ((now - gs_tick) < APP_PKTGEN_SETTLE_MS)
+        {
+            return;
+        }
+        gs_state = APP_PKTGEN_SEND;
+        gs_tick = now;
+    }
+    if (gs_state == APP_PKTGEN_SEND)
+    {
+        if ((gs_config.duration_ms != 0) && ((now - gs_tick) >= gs_config.duration_ms))
+        {
+            a_app_pktgen_drain(now);
+        }
+        else
+        {
+            allowed = a_app_pktgen_allowed(now - gs_tick);
+            while (gs_seq < allowed)
+            {
+                err = a_app_pktgen_send(netif);
+                if (err == ERR_MEM)
+                {
+                    /* all the frames are in flight, the tx interrupt wakes the loop */
+                    gs_stats.tx_busy++;
+                    
+                    break;
+                }
+                if (err == ERR_OK)
+                {
+                    gs_stats.tx_frames++;
+                    gs_stats.tx_bytes += gs_config.size;
+                }
+                else
+                {
+                    gs_stats.tx_errors++;
+                }
+                
+                /* a refused frame keeps its number, the receiver counts it as lost */
+                gs_seq++;
+            }
+            if ((gs_config.count != 0) && (gs_seq >= gs_config.count))
+            {
+                a_app_pktgen_drain(HAL_GetTick());
+            }
+        }
+    }
+    if ((gs_state == APP_PKTGEN_DRAIN) && ((now - gs_tick) >= APP_PKTGEN_DRAIN_MS))
+    {
+        a_app_pktgen_end();
+    }
+}
+
+/**
+ * @brief  app pktgen get the time until app_pktgen_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no run is active
+ * @note   a generator waiting for the frames in flight is woken by the tx interrupt
+ */
+uint32_t app_pktgen_sleeptime(void)
+{
+    uint32_t elapsed = HAL_GetTick() - gs_tick;
+    uint32_t sleep;
+    uint32_t next;
+    
+    if (gs_state == APP_PKTGEN_SETTLE)
+    {
+        return (elapsed < APP_PKTGEN_SETTLE_MS) ? (APP_PKTGEN_SETTLE_MS - elapsed) : 0;
+    }
+    if (gs_state == APP_PKTGEN_DRAIN)
+    {
+        return (elapsed < APP_PKTGEN_DRAIN_MS) ? (APP_PKTGEN_DRAIN_MS - elapsed) : 0;
+    }
+    if (gs_state != APP_PKTGEN_SEND)
+    {
+        return 0xFFFFFFFFU;
+    }
+    sleep = 0xFFFFFFFFU;
+    if (gs_config.duration_ms != 0)
+    {
+        sleep = (elapsed < gs_config.duration_ms) ? (gs_config.duration_ms - elapsed) : 0;
+    }
+    if ((gs_in_flight >= APP_PKTGEN_FRAME_CNT) || (sleep == 0))
+    {
+        return sleep;
+    }
+    if (gs_seq < a_app_pktgen_allowed(elapsed))
+    {
+        return 0;
+    }
+    
+    /* the next burst starts at its first frame time */
+    next = (uint32_t)(((uint64_t)(gs_seq / gs_config.burst) * gs_config.burst * 1000U +
+                       gs_config.rate - 1U) / gs_config.rate);
+    
+    return (next > elapsed) ? (((next - elapsed) < sleep) ? (next - elapsed) : sleep) : 0;
+}
+
+/**
+ * @brief      app pktgen get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_pktgen_get_stats(app_pktgen_stats_t *stats)
+{
+    *stats = gs_stats;
+}
+
+/**
+ * @brief app pktgen reset the stats
+ */
+void app_pktgen_reset_stats(void)
+{
+    memset(&gs_stats, 0, sizeof(app_pktgen_stats_t));
+    gs_rx_valid = 0;
+}
@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_telemetry.c
+ * @brief     app telemetry source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_telemetry.h"
+#include "app_lwip.h"
+#include "app_udp_zc.h"
+#include "lwip/etharp.h"
+#include "lwip/udp.h"
+
+/**
+ * @brief app telemetry structure definition
+ */
+typedef struct app_telemetry_s
+{
+    struct udp_pcb *pcb;                /**< telemetry pcb */
+    ip_addr_t dst;                      /**< destination address */
+    ip4_addr_t hop;                     /**< next hop address */
+    app_telemetry_report_t report;      /**< report callback */
+    void *arg;                          /**< report argument */
+    uint16_t size;                      /**< block size */
+    uint32_t count;                     /**< blocks to send */
+    uint32_t duration;                  /**< send time in ms */
+    uint32_t query;                     /**< tick of the last arp request */
+    uint32_t start;                     /**< tick at the stream start */
+    uint32_t end;                       /**< tick at the stream end */
+    uint32_t retry;                     /**< tick of the next send after a refused block */
+    uint8_t backoff;                    /**< a refused block holds the stream until the retry tick */
+    uint8_t resolved;                   /**< next hop in the arp table */
+    uint8_t run;                        /**< stream running */
+    app_telemetry_stats_t stats;        /**< stats of the stream */
+} app_telemetry_t;
+
+static app_telemetry_t gs_telemetry;                                      /**< stream */
+static uint32_t gs_buf[2][APP_TELEMETRY_SIZE_MAX / 4];                    /**< double buffer of blocks */
+static volatile uint8_t gs_busy[2];                                       /**< block owned by lwip or the dma */
+
+/**
+ * @brief     app telemetry done callback
+ * @param[in] *buf pointer to the released block
+ * @param[in] *arg block index
+ * @note      the block may be written again
+ */
+static void a_app_telemetry_done(void *buf, void *arg)
+{
+    (void)buf;
+    
+    gs_busy[(uint32_t)(uintptr_t)arg] = 0;
+}
+
+/**
+ * @brief  app telemetry check the stream end
+ * @return 1 if the count or the duration is reached, else 0
+ * @note   none
+ */
+static uint8_t a_app_telemetry_ended(void)
+{
+    if ((gs_telemetry.count != 0) && (gs_telemetry.stats.blocks >= gs_telemetry.count))
+    {
+        return 1;
+    }
+    if ((int32_t)(HAL_GetTick() - gs_telemetry.end) >= 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     app telemetry start a stream
+ * @param[in] *dst pointer to a unicast ipv4 destination address
+ * @param[in] size block size
+ * @param[in] count blocks to send, 0 sends until the duration ends
+ * @param[in] duration_ms send time in ms
+ * @param[in] report called once the stream ends
+ * @param[in] *arg report argument
+ * @return    status code
+ *            - ERR_OK the stream is started
+ *            - ERR_VAL the size or the destination is invalid
+ *            - ERR_CONN the interface has no address
+ *            - ERR_MEM the pcb can not be allocated
+ * @note      the blocks are sent from two static buffers without a copy, the stream waits for the
+ *            arp reply of the next hop first, a running stream is restarted
+ */
+err_t app_telemetry_start(const ip_addr_t *dst, uint16_t size, uint32_t count, uint32_t duration_ms,
+                          app_telemetry_report_t report, void *arg)
+{
+    struct netif *netif = netif_get_handle();
+    
+    if ((dst == NULL) || (size < APP_TELEMETRY_SIZE_MIN) || (size > APP_TELEMETRY_SIZE_MAX))
+    {
+        return ERR_VAL;
+    }
+    if (ip4_addr_isany_val(*netif_ip4_addr(netif)))
+    {
+        return ERR_CONN;
+    }
+    if ((IP_IS_V4(dst) == 0) || ip_addr_isany(dst) || ip_addr_ismulticast(dst) || ip_addr_isbroadcast(dst, netif))
+    {
+        return ERR_VAL;
+    }
+    if (gs_telemetry.pcb == NULL)
+    {
+        gs_telemetry.pcb = udp_new();
+        if (gs_telemetry.pcb == NULL)
+        {
+            return ERR_MEM;
+        }
+    }
+    
+    /* a remote destination goes through the gateway */
+    ip_addr_copy(gs_telemetry.dst, *dst);
+    if (ip4_addr_netcmp(ip_2_ip4(dst), netif_ip4_addr(netif), netif_ip4_netmask(netif)))
+    {
+        ip4_addr_copy(gs_telemetry.hop, *ip_2_ip4(dst));
+    }
+    else
+    {
+        ip4_addr_copy(gs_telemetry.hop, *netif_ip4_gw(netif));
+    }
+    gs_telemetry.report = report;
+    gs_telemetry.arg = arg;
+    gs_telemetry.size = size;
+    gs_telemetry.count = count;
+    gs_telemetry.duration = duration_ms;
+    gs_telemetry.stats.blocks = 0;
+    gs_telemetry.stats.bytes = 0;
+    gs_telemetry.stats.errors = 0;
+    gs_telemetry.stats.ms = 0;
+    gs_telemetry.backoff = 0;
+    gs_telemetry.resolved = 0;
+    gs_telemetry.query = HAL_GetTick();
+    (void)etharp_query(netif, &gs_telemetry.hop, NULL);
+    gs_telemetry.run = 1;
+    
+    return ERR_OK;
+}
+
+/**
+ * @brief app telemetry send the blocks which are free
+ * @note  call it from the main loop after lwip_server
+ */
+void app_telemetry_poll(void)
+{
+    uint32_t i;
+    uint32_t *word;
+    struct eth_addr *eth;
+    const ip4_addr_t *hop;
+    err_t err;
+    
+    if (gs_telemetry.run == 0)
+    {
+        return;
+    }
+    
+    /* etharp keeps only the last datagram to an unresolved hop, so the stream waits for the reply */
+    if (gs_telemetry.resolved == 0)
+    {
+        if (etharp_find_addr(netif_get_handle(), &gs_telemetry.hop, &eth, &hop) < 0)
+        {
+            if ((HAL_GetTick() - gs_telemetry.query) >= APP_TELEMETRY_ARP_MS)
+            {
+                gs_telemetry.query = HAL_GetTick();
+                (void)etharp_query(netif_get_handle(), &gs_telemetry.hop, NULL);
+            }
+            
+            return;
+        }
+        gs_telemetry.resolved = 1;
+        gs_telemetry.start = HAL_GetTick();
+        gs_telemetry.end = gs_telemetry.start + gs_telemetry.duration;
+    }
+    if ((gs_telemetry.backoff != 0) && ((int32_t)(HAL_GetTick() - gs_telemetry.retry) >= 0))
+    {
+        gs_telemetry.backoff = 0;
+    }
+    for (i = 0; i < 2; i++)
+    {
+        if ((gs_busy[i] != 0) || (gs_telemetry.backoff != 0) || (a_app_telemetry_ended() != 0))
+        {
+            continue;
+        }
+        
+        /* the producer writes the block where it is sent from, the sample header leads */
+        word = gs_buf[i];
+        word[0] = lwip_htonl(gs_telemetry.stats.blocks);
+        word[1] = lwip_htonl(HAL_GetTick());
+        gs_busy[i] = 1;
+        err = app_udp_zc_sendto(gs_telemetry.pcb, &gs_telemetry.dst, APP_TELEMETRY_PORT, gs_buf[i],
+                                gs_telemetry.size, a_app_telemetry_done, (void *)(uintptr_t)i);
+        if (err == ERR_OK)
+        {
+            gs_telemetry.stats.blocks++;
+            gs_telemetry.stats.bytes += gs_telemetry.size;
+        }
+        else
+        {
+            /* a refused block was released already, a lost route or link refuses the next one as well,
+               so the stream holds before it is sent again */
+            gs_busy[i] = 0;
+            gs_telemetry.stats.errors++;
+            gs_telemetry.backoff = 1;
+            gs_telemetry.retry = HAL_GetTick() + APP_TELEMETRY_RETRY_MS;
+        }
+    }
+    
+    /* the stream ends once both blocks are back */
+    if ((gs_busy[0] == 0) && (gs_busy[1] == 0) && (a_app_telemetry_ended() != 0))
+    {
+        gs_telemetry.run = 0;
+        gs_telemetry.stats.ms = HAL_GetTick() - gs_telemetry.start;
+        if (gs_telemetry.report != NULL)
+        {
+            gs_telemetry.report(&gs_telemetry.stats, gs_telemetry.arg);
+        }
+    }
+}
+
+/**
+ * @brief  app telemetry get the time until app_telemetry_poll has work to do
+ * @return milliseconds, 0xFFFFFFFF if no stream is active
+ * @note   a released block wakes up the loop through the tx interrupt and the arp reply through the
+ *         rx interrupt, a refused block holds the stream for APP_TELEMETRY_RETRY_MS
+ */
+uint32_t app_telemetry_sleeptime(void)
+{
+    uint32_t elapsed;
+    uint32_t now;
+    uint32_t wait;
+    
+    if (gs_telemetry.run == 0)
+    {
+        return 0xFFFFFFFFU;
+    }
+    if (gs_telemetry.resolved == 0)
+    {
+        elapsed = HAL_GetTick() - gs_telemetry.query;
+        
+        return (elapsed < APP_TELEMETRY_ARP_MS) ? (APP_TELEMETRY_ARP_MS - elapsed) : 0;
+    }
+    if ((gs_busy[0] == 0) || (gs_busy[1] == 0))
+    {
+        /* a held stream wakes up at the retry or at its end, an ended one at once */
+        now = HAL_GetTick();
+        if ((gs_telemetry.backoff == 0) || ((int32_t)(gs_telemetry.retry - now) <= 0) ||
+            (a_app_telemetry_ended() != 0))
+        {
+            return 0;
+        }
+        wait = gs_telemetry.retry - now;
+        if ((gs_telemetry.end - now) < wait)
+        {
+            wait = gs_telemetry.end - now;
+        }
+        
+        return wait;
+    }
+    
+    return 0xFFFFFFFFU;
+}
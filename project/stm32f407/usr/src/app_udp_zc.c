@@ -0,0 +1,209 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      app_udp_zc.c
+ * @brief     app udp zero copy source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "app_udp_zc.h"
+#include "trace.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief app udp zc header room definition
+ * @note  udp, ip and link headers in front of the payload
+ */
+#define APP_UDP_ZC_HLEN    LWIP_MEM_ALIGN_SIZE(PBUF_LINK_ENCAPSULATION_HLEN + PBUF_LINK_HLEN + PBUF_IP_HLEN + PBUF_TRANSPORT_HLEN)
+
+/**
+ * @brief app udp zc wrapper structure definition
+ * @note  the header pbuf heads the chain, the payload pbuf refers to the caller buffer
+ */
+typedef struct app_udp_zc_wrap_s
+{
+    struct pbuf_custom hdr;                                   /**< header pbuf */
+    uint8_t hdr_buf[APP_UDP_ZC_HLEN];                         /**< header room, it must follow hdr */
+    struct pbuf_custom data;                                  /**< payload pbuf */
+    app_udp_zc_done_t done;                                   /**< done callback */
+    void *arg;                                                /**< done argument */
+    uint32_t stamp;                                           /**< trace tick of the send */
+} app_udp_zc_wrap_t;
+
+LWIP_MEMPOOL_DECLARE(UDP_ZC_POOL, APP_UDP_ZC_CNT, sizeof(app_udp_zc_wrap_t), "udp zero copy pool");
+
+static app_udp_zc_stats_t gs_stats;        /**< stats */
+static uint32_t gs_tick_per_us;            /**< trace ticks in a microsecond */
+
+/**
+ * @brief     app udp zc header free callback
+ * @param[in] *p pointer to the header pbuf
+ * @note      the wrapper is freed with the payload, which always comes later in the chain
+ */
+static void a_app_udp_zc_hdr_free(struct pbuf *p)
+{
+    LWIP_UNUSED_ARG(p);
+}
+
+/**
+ * @brief     app udp zc payload free callback
+ * @param[in] *p pointer to the payload pbuf
+ * @note      called once lwip and the dma have released the buffer
+ */
+static void a_app_udp_zc_data_free(struct pbuf *p)
+{
+    app_udp_zc_wrap_t *w = (app_udp_zc_wrap_t *)((uint8_t *)p - offsetof(app_udp_zc_wrap_t, data));
+    app_udp_zc_done_t done = w->done;
+    void *arg = w->arg;
+    void *buf = p->payload;
+    uint32_t us;
+    
+    us = (trace_get_tick() - w->stamp) / gs_tick_per_us;
+    gs_stats.release_cnt++;
+    gs_stats.release_sum_us += us;
+    if (us > gs_stats.release_max_us)
+    {
+        gs_stats.release_max_us = us;
+    }
+    gs_stats.in_flight--;
+    LWIP_MEMPOOL_FREE(UDP_ZC_POOL, w);
+    
+    /* the wrapper is free before the owner may send again */
+    if (done != NULL)
+    {
+        done(buf, arg);
+    }
+}
+
+/**
+ * @brief app udp zc init
+ * @note  none
+ */
+void app_udp_zc_init(void)
+{
+    LWIP_MEMPOOL_INIT(UDP_ZC_POOL);
+    gs_tick_per_us = trace_get_tick_per_us();
+    memset(&gs_stats, 0, sizeof(app_udp_zc_stats_t));
+}
+
+/**
+ * @brief     app udp zc send a caller owned buffer without a copy
+ * @param[in] *pcb pointer to a udp pcb
+ * @param[in] *dst pointer to the destination address, NULL uses the connected address
+ * @param[in] port destination port, ignored with a NULL dst
+ * @param[in] *buf pointer to the payload
+ * @param[in] len payload length
+ * @param[in] done called once the buffer is released
+ * @param[in] *arg done argument
+ * @return    status code
+ *            - ERR_OK the buffer is handed over, done is called once it is released
+ *            - ERR_WOULDBLOCK all the wrappers are in flight, the buffer is not used
+ *            - other values the send failed, done has already been called
+ * @note      the buffer must not be written until done is called, the headers are built in the wrapper
+ */
+err_t app_udp_zc_sendto(struct udp_pcb *pcb, const ip_addr_t *dst, u16_t port,
+                        const void *buf, u16_t len, app_udp_zc_done_t done, void *arg)
+{
+    app_udp_zc_wrap_t *w;
+    struct pbuf *h;
+    struct pbuf *d;
+    err_t err;
+    
+    w = (app_udp_zc_wrap_t *)LWIP_MEMPOOL_ALLOC(UDP_ZC_POOL);
+    if (w == NULL)
+    {
+        gs_stats.busy++;
+        
+        return ERR_WOULDBLOCK;
+    }
+    w->done = done;
+    w->arg = arg;
+    w->stamp = trace_get_tick();
+    w->hdr.custom_free_function = a_app_udp_zc_hdr_free;
+    w->data.custom_free_function = a_app_udp_zc_data_free;
+    
+    /* an empty PBUF_RAM head, udp and ip add their headers in front without a heap pbuf */
+    h = pbuf_alloced_custom(PBUF_TRANSPORT, 0, PBUF_RAM, &w->hdr, w->hdr_buf, sizeof(w->hdr_buf));
+    d = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &w->data, (void *)buf, len);
+    pbuf_cat(h, d);
+    gs_stats.in_flight++;
+    if (gs_stats.in_flight > gs_stats.in_flight_max)
+    {
+        gs_stats.in_flight_max = gs_stats.in_flight;
+    }
+    if (dst != NULL)
+    {
+        err = udp_sendto(pcb, h, dst, port);
+    }
+    else
+    {
+        err = udp_send(pcb, h);
+    }
+    if (err == ERR_OK)
+    {
+        gs_stats.sent++;
+        gs_stats.bytes += len;
+    }
+    else
+    {
+        gs_stats.errors++;
+    }
+    
+    /* the dma or the arp queue keeps its own reference */
+    pbuf_free(h);
+    
+    return err;
+}
+
+/**
+ * @brief      app udp zc get the stats
+ * @param[out] *stats pointer to a stats structure
+ */
+void app_udp_zc_get_stats(app_udp_zc_stats_t *stats)
+{
+    *stats = gs_stats;
+}
+
+/**
+ * @brief app udp zc reset the stats
+ * @note  the buffers in flight are kept
+ */
+void app_udp_zc_reset_stats(void)
+{
+    uint32_t in_flight = gs_stats.in_flight;
+    
+    memset(&gs_stats, 0, sizeof(app_udp_zc_stats_t));
+    gs_stats.in_flight = in_flight;
+    gs_stats.in_flight_max = in_flight;
+}
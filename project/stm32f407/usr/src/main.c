@@ -37,11 +37,19 @@
 #include "driver_lan8720_register_test.h"
 #include "driver_lan8720_basic.h"
 #include "app_lwip.h"
+#include "app_dns.h"
+#include "app_pktgen.h"
+#include "app_udp_zc.h"
+#include "app_capture.h"
+#include "app_perf.h"
+#include "app_telemetry.h"
+#include "lwip/apps/lwiperf.h"
 #include "shell.h"
 #include "clock.h"
 #include "delay.h"
 #include "uart.h"
 #include "getopt.h"
+#include "trace.h"
 #include <stdlib.h>
 
 /**
@@ -50,6 +58,542 @@
 uint8_t g_buf[256];             /**< uart buffer */
 volatile uint16_t g_len;        /**< uart buffer length */
 
+/**
+ * @brief main loop metrics definition
+ */
+static uint32_t gs_loop_start;         /**< metrics start tick */
+static uint32_t gs_loop_wakeups;       /**< main loop passes */
+static uint32_t gs_loop_idle_ms;       /**< time spent in wfi */
+static uint32_t gs_loop_deadlines;     /**< deadline wake ups */
+static uint32_t gs_loop_late_sum;      /**< total deadline lateness */
+static uint32_t gs_loop_late_max;      /**< max deadline lateness */
+
+/**
+ * @brief perf test definition
+ */
+static void *gs_perf_session;          /**< lwiperf server */
+static uint32_t gs_perf_start;         /**< tick at the test start */
+static uint32_t gs_perf_idle;          /**< loop idle time at the test start */
+static app_perf_rexmit_t gs_perf_rexmit;   /**< tcp retransmissions at the test start */
+
+/**
+ * @brief dhcp lease backup sram definition
+ */
+#define LEASE_MAGIC    0x4C454153U        /**< lease record magic */
+static RTC_HandleTypeDef gs_rtc_handle;   /**< backup domain rtc, the lease clock */
+static uint8_t gs_rtc_ready;              /**< rtc is running */
+
+/**
+ * @brief lease record structure definition
+ */
+typedef struct lease_record_s
+{
+    uint32_t magic;                        /**< LEASE_MAGIC */
+    lwip_server_lease_t lease;             /**< saved lease */
+    uint32_t check;                        /**< xor of the lease words */
+} lease_record_t;
+
+/**
+ * @brief     lease record checksum
+ * @param[in] *lease pointer to a lease structure
+ * @return    xor of the lease words
+ * @note      none
+ */
+static uint32_t a_lease_check(const lwip_server_lease_t *lease)
+{
+    const uint32_t *p = (const uint32_t *)lease;
+    uint32_t check = LEASE_MAGIC;
+    uint32_t i;
+    
+    for (i = 0; i < sizeof(lwip_server_lease_t) / sizeof(uint32_t); i++)
+    {
+        check ^= p[i];
+    }
+    
+    return check;
+}
+
+/**
+ * @brief      lease load from the backup sram
+ * @param[out] *lease pointer to a lease structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 no valid lease
+ * @note       the backup sram keeps the lease over a reset and on vbat
+ */
+static uint8_t a_lease_load(lwip_server_lease_t *lease)
+{
+    volatile lease_record_t *record = (volatile lease_record_t *)BKPSRAM_BASE;
+    
+    *lease = *(const lwip_server_lease_t *)&record->lease;
+    if ((record->magic != LEASE_MAGIC) || (record->check != a_lease_check(lease)))
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  lease clock init
+ * @return status code
+ *         - 0 success
+ *         - 1 rtc init failed
+ * @note   the rtc runs from the lse in the backup domain next to the backup sram and keeps counting
+ *         over a reset and on vbat, only a cold backup domain is configured
+ */
+static uint8_t a_lease_clock_init(void)
+{
+    RCC_OscInitTypeDef osc = {0};
+    RCC_PeriphCLKInitTypeDef clk = {0};
+    
+    gs_rtc_handle.Instance = RTC;
+    if ((RCC->BDCR & RCC_BDCR_RTCEN) == 0)
+    {
+        osc.OscillatorType = RCC_OSCILLATORTYPE_LSE;
+        osc.LSEState = RCC_LSE_ON;
+        osc.PLL.PLLState = RCC_PLL_NONE;
+        if (HAL_RCC_OscConfig(&osc) != HAL_OK)
+        {
+            return 1;
+        }
+        clk.PeriphClockSelection = RCC_PERIPHCLK_RTC;
+        clk.RTCClockSelection = RCC_RTCCLKSOURCE_LSE;
+        if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK)
+        {
+            return 1;
+        }
+        __HAL_RCC_RTC_ENABLE();
+        gs_rtc_handle.Init.HourFormat = RTC_HOURFORMAT_24;
+        gs_rtc_handle.Init.AsynchPrediv = 127;
+        gs_rtc_handle.Init.SynchPrediv = 255;
+        gs_rtc_handle.Init.OutPut = RTC_OUTPUT_DISABLE;
+        gs_rtc_handle.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+        gs_rtc_handle.Init.OutPutType = RTC_OUTPUT_TYPE_OPENDRAIN;
+        if (HAL_RTC_Init(&gs_rtc_handle) != HAL_OK)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        /* the shadow registers are stale after a reset */
+        if (HAL_RTC_WaitForSynchro(&gs_rtc_handle) != HAL_OK)
+        {
+            return 1;
+        }
+    }
+    gs_rtc_ready = 1;
+    
+    return 0;
+}
+
+/**
+ * @brief      lease clock read
+ * @param[out] *seconds pointer to a seconds buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 rtc is not running
+ * @note       seconds since the rtc calendar start, only the differences are used
+ */
+static uint8_t a_lease_clock(uint32_t *seconds)
+{
+    const uint16_t month_days[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    RTC_TimeTypeDef time;
+    RTC_DateTypeDef date;
+    uint32_t days;
+    
+    if (gs_rtc_ready == 0)
+    {
+        return 1;
+    }
+    
+    /* the date read unlocks the shadow registers after the time read */
+    if ((HAL_RTC_GetTime(&gs_rtc_handle, &time, RTC_FORMAT_BIN) != HAL_OK) ||
+        (HAL_RTC_GetDate(&gs_rtc_handle, &date, RTC_FORMAT_BIN) != HAL_OK) ||
+        (date.Month < 1) || (date.Month > 12) || (date.Date < 1))
+    {
+        return 1;
+    }
+    days = (uint32_t)date.Year * 365U + ((uint32_t)date.Year + 3U) / 4U +
+           month_days[date.Month - 1] + (uint32_t)date.Date - 1U;
+    if (((date.Year % 4U) == 0) && (date.Month > 2))
+    {
+        days++;
+    }
+    *seconds = ((days * 24U + time.Hours) * 60U + time.Minutes) * 60U + time.Seconds;
+    
+    return 0;
+}
+
+/**
+ * @brief     lease save to the backup sram
+ * @param[in] *lease pointer to a lease structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_lease_save(const lwip_server_lease_t *lease)
+{
+    volatile lease_record_t *record = (volatile lease_record_t *)BKPSRAM_BASE;
+    
+    record->magic = 0;
+    *(lwip_server_lease_t *)&record->lease = *lease;
+    record->check = a_lease_check(lease);
+    record->magic = LEASE_MAGIC;
+    
+    return 0;
+}
+
+/**
+ * @brief     dns found callback
+ * @param[in] *name pointer to the host name
+ * @param[in] *addr pointer to the address, NULL on a failure
+ * @param[in] *arg unused
+ * @note      none
+ */
+static void a_dns_found(const char *name, const ip_addr_t *addr, void *arg)
+{
+    char output[32] = {0};
+    
+    (void)arg;
+    
+    if (addr != NULL)
+    {
+        ipaddr_ntoa_r(addr, output, 32);
+        lan8720_interface_debug_print("%s dns: %s\n", name, output);
+    }
+    else
+    {
+        lan8720_interface_debug_print("dns error.\n");
+    }
+}
+
+/**
+ * @brief mark the start of a perf test
+ * @note  none
+ */
+static void a_perf_mark(void)
+{
+    gs_perf_start = HAL_GetTick();
+    gs_perf_idle = gs_loop_idle_ms;
+    app_perf_get_rexmit(&gs_perf_rexmit);
+}
+
+/**
+ * @brief     perf report callback
+ * @param[in] *arg unused
+ * @param[in] report_type test result
+ * @param[in] *local_addr pointer to the local address
+ * @param[in] local_port local port
+ * @param[in] *remote_addr pointer to the remote address
+ * @param[in] remote_port remote port
+ * @param[in] bytes_transferred transferred bytes
+ * @param[in] ms_duration test time
+ * @param[in] bandwidth_kbitpsec rounded bandwidth of lwiperf
+ * @note      the idle share and the retransmissions cover the time since the test start,
+ *            for a server since its start or its previous report
+ */
+static void a_perf_report(void *arg, enum lwiperf_report_type report_type,
+                          const ip_addr_t *local_addr, u16_t local_port,
+                          const ip_addr_t *remote_addr, u16_t remote_port,
+                          u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec)
+{
+    const char *result[] = {"server done", "client done", "local abort", "local data error",
+                            "local tx error", "remote abort"};
+    char remote[32] = {0};
+    char fast[12] = "n/a";
+    app_perf_rexmit_t rexmit;
+    uint32_t elapsed;
+    uint32_t idle;
+    uint32_t centi;
+    
+    (void)arg;
+    (void)local_addr;
+    (void)local_port;
+    (void)bandwidth_kbitpsec;
+    
+    elapsed = HAL_GetTick() - gs_perf_start;
+    idle = gs_loop_idle_ms - gs_perf_idle;
+    app_perf_get_rexmit(&rexmit);
+    centi = (ms_duration != 0) ? (uint32_t)((uint64_t)bytes_transferred * 8U / ms_duration / 10U) : 0;
+    ipaddr_ntoa_r(remote_addr, remote, 32);
+    
+    /* the fast retransmissions are only counted with the lwip mib2 stats */
+    if (rexmit.fast_valid != 0)
+    {
+        snprintf(fast, 12, "%u", (unsigned int)(rexmit.fast - gs_perf_rexmit.fast));
+    }
+    lan8720_interface_debug_print("lan8720: perf %s with %s:%u, %u bytes in %u ms.\n",
+                                  (report_type <= LWIPERF_TCP_ABORTED_REMOTE) ? result[report_type] : "unknown",
+                                  remote, (unsigned int)remote_port, (unsigned int)bytes_transferred,
+                                  (unsigned int)ms_duration);
+    lan8720_interface_debug_print("lan8720: perf %u.%02u Mbit/s retransmissions %s timeouts %u cpu idle %u%%.\n",
+                                  (unsigned int)(centi / 100), (unsigned int)(centi % 100), fast,
+                                  (unsigned int)(rexmit.timeouts - gs_perf_rexmit.timeouts),
+                                  (unsigned int)((elapsed != 0) ? ((uint64_t)idle * 100U / elapsed) : 0));
+    a_perf_mark();
+}
+
+/**
+ * @brief     start a perf test
+ * @param[in] client 1 runs a client, 0 runs a server
+ * @param[in] *ip pointer to the server address of a client, empty for the gateway
+ * @param[in] duration client send time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a running test is aborted first
+ */
+static uint8_t a_perf_start(uint8_t client, const char *ip, uint32_t duration)
+{
+    ip_addr_t remote;
+    void *session;
+    char output[32] = {0};
+    
+    if (gs_perf_session != NULL)
+    {
+        session = gs_perf_session;
+        gs_perf_session = NULL;
+        lwiperf_abort(session);
+    }
+    app_perf_client_abort();
+    a_perf_mark();
+    if (client == 0)
+    {
+        gs_perf_session = lwiperf_start_tcp_server_default(a_perf_report, NULL);
+        if (gs_perf_session == NULL)
+        {
+            lan8720_interface_debug_print("lan8720: start perf server failed.\n");
+            
+            return 1;
+        }
+        lan8720_interface_debug_print("lan8720: perf server listens on port %d.\n", LWIPERF_TCP_PORT_DEFAULT);
+    }
+    else
+    {
+        if (ip[0] == 0)
+        {
+            ip_addr_copy_from_ip4(remote, *netif_ip4_gw(netif_get_handle()));
+        }
+        else if (ipaddr_aton(ip, &remote) == 0)
+        {
+            return 5;
+        }
+        if (app_perf_client_start(&remote, LWIPERF_TCP_PORT_DEFAULT, duration * 1000U, a_perf_report, NULL) != ERR_OK)
+        {
+            lan8720_interface_debug_print("lan8720: start perf client failed.\n");
+            
+            return 1;
+        }
+        ipaddr_ntoa_r(&remote, output, 32);
+        lan8720_interface_debug_print("lan8720: perf client sends to %s for %u s.\n", output, (unsigned int)duration);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      parse a mac address
+ * @param[in]  *str pointer to a "xx:xx:xx:xx:xx:xx" string
+ * @param[out] *mac pointer to a mac address buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 the address is invalid
+ * @note       none
+ */
+static uint8_t a_mac_parse(const char *str, uint8_t *mac)
+{
+    char *end;
+    uint32_t i;
+    
+    for (i = 0; i < 6; i++)
+    {
+        mac[i] = (uint8_t)strtoul(str, &end, 16);
+        if ((end == str) || ((end - str) > 2) || (*end != ((i < 5) ? ':' : '\0')))
+        {
+            return 1;
+        }
+        str = end + 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     print the pktgen stats
+ * @param[in] *stats pointer to a stats structure
+ * @note      the rates cover the time from the first frame to the last one
+ */
+static void a_pktgen_print(const app_pktgen_stats_t *stats)
+{
+    lan8720_interface_debug_print("lan8720: pktgen tx %u frames %u bytes errors %u busy %u in %u ms, %u pps %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->tx_frames, (unsigned int)stats->tx_bytes,
+                                  (unsigned int)stats->tx_errors, (unsigned int)stats->tx_busy, (unsigned int)stats->tx_ms,
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_frames * 1000U / stats->tx_ms) : 0),
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_bytes * 8U / stats->tx_ms / 1000U) : 0),
+                                  (unsigned int)((stats->tx_ms != 0) ? ((uint64_t)stats->tx_bytes * 8U / stats->tx_ms / 10U % 100U) : 0));
+    lan8720_interface_debug_print("lan8720: pktgen rx %u frames %u bytes lost %u reordered %u in %u ms, %u pps %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->rx_frames, (unsigned int)stats->rx_bytes,
+                                  (unsigned int)stats->rx_lost, (unsigned int)stats->rx_reordered, (unsigned int)stats->rx_ms,
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_frames * 1000U / stats->rx_ms) : 0),
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_bytes * 8U / stats->rx_ms / 1000U) : 0),
+                                  (unsigned int)((stats->rx_ms != 0) ? ((uint64_t)stats->rx_bytes * 8U / stats->rx_ms / 10U % 100U) : 0));
+    if (stats->latency_cnt != 0)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen latency min %u avg %u max %u ns.\n",
+                                      (unsigned int)stats->latency_min,
+                                      (unsigned int)(stats->latency_sum / stats->latency_cnt),
+                                      (unsigned int)stats->latency_max);
+    }
+}
+
+/**
+ * @brief     pktgen report callback
+ * @param[in] *stats pointer to the stats of the run
+ * @param[in] *arg unused
+ * @note      none
+ */
+static void a_pktgen_report(const app_pktgen_stats_t *stats, void *arg)
+{
+    (void)arg;
+    
+    lan8720_interface_debug_print("lan8720: pktgen done.\n");
+    a_pktgen_print(stats);
+}
+
+/**
+ * @brief     start a pktgen run
+ * @param[in] *config pointer to a pktgen config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a running run is stopped first
+ */
+static uint8_t a_pktgen_start(const app_pktgen_config_t *config)
+{
+    err_t err;
+    
+    err = app_pktgen_start(config, a_pktgen_report, NULL);
+    if (err == ERR_VAL)
+    {
+        return 5;
+    }
+    else if (err == ERR_CONN)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen link is down or the udp mode has no address.\n");
+        
+        return 1;
+    }
+    else if (err != ERR_OK)
+    {
+        lan8720_interface_debug_print("lan8720: pktgen set loopback failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        lan8720_interface_debug_print("lan8720: pktgen sends %u byte%s frames to %02x:%02x:%02x:%02x:%02x:%02x%s.\n",
+                                      (unsigned int)config->size, (config->udp != 0) ? " udp" : "",
+                                      config->dst[0], config->dst[1], config->dst[2],
+                                      config->dst[3], config->dst[4], config->dst[5],
+                                      (config->loopback != 0) ? " over the loopback" : "");
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     telemetry report callback
+ * @param[in] *stats pointer to the stats of the stream
+ * @param[in] *arg unused
+ * @note      the rate covers the time from the arp reply to the last block released
+ */
+static void a_telemetry_report(const app_telemetry_stats_t *stats, void *arg)
+{
+    (void)arg;
+    
+    lan8720_interface_debug_print("lan8720: telemetry done, %u blocks %u bytes errors %u in %u ms, %u.%02u Mbit/s.\n",
+                                  (unsigned int)stats->blocks, (unsigned int)stats->bytes,
+                                  (unsigned int)stats->errors, (unsigned int)stats->ms,
+                                  (unsigned int)((stats->ms != 0) ? ((uint64_t)stats->bytes * 8U / stats->ms / 1000U) : 0),
+                                  (unsigned int)((stats->ms != 0) ? ((uint64_t)stats->bytes * 8U / stats->ms / 10U % 100U) : 0));
+}
+
+/**
+ * @brief     start a telemetry stream
+ * @param[in] *ip pointer to the destination address, an empty string sends to the gateway
+ * @param[in] size block size
+ * @param[in] count blocks to send, 0 sends until the duration ends
+ * @param[in] duration send time in seconds
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ *            - 5 param is invalid
+ * @note      a unicast ipv4 destination is needed for the arp wait
+ */
+static uint8_t a_telemetry_start(const char *ip, uint16_t size, uint32_t count, uint32_t duration)
+{
+    ip_addr_t dst;
+    char output[32];
+    err_t err;
+    
+    if (ip[0] == 0)
+    {
+        ip_addr_copy_from_ip4(dst, *netif_ip4_gw(netif_get_handle()));
+    }
+    else if (ipaddr_aton(ip, &dst) == 0)
+    {
+        return 5;
+    }
+    err = app_telemetry_start(&dst, size, count, duration * 1000U, a_telemetry_report, NULL);
+    if (err == ERR_VAL)
+    {
+        return 5;
+    }
+    else if (err == ERR_CONN)
+    {
+        lan8720_interface_debug_print("lan8720: telemetry has no address.\n");
+        
+        return 1;
+    }
+    else if (err != ERR_OK)
+    {
+        lan8720_interface_debug_print("lan8720: telemetry udp_new failed.\n");
+        
+        return 1;
+    }
+    else
+    {
+        ipaddr_ntoa_r(&dst, output, 32);
+        lan8720_interface_debug_print("lan8720: telemetry sends %u byte blocks to %s:%u.\n",
+                                      (unsigned int)size, output, (unsigned int)APP_TELEMETRY_PORT);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief print the capture state
+ * @note  none
+ */
+static void a_capture_print(void)
+{
+    const char *state[] = {"idle", "armed", "triggered", "done"};
+    app_capture_stats_t stats;
+    
+    app_capture_get_stats(&stats);
+    lan8720_interface_debug_print("lan8720: capture %s frames %u overwritten %u ring %u frames %u bytes pre %u post %u trigger %s.\n",
+                                  state[stats.state], (unsigned int)stats.frames, (unsigned int)stats.overwritten,
+                                  (unsigned int)stats.ring_frames, (unsigned int)stats.ring_bytes,
+                                  (unsigned int)stats.pre, (unsigned int)stats.post,
+                                  (stats.reason == APP_CAPTURE_TRIGGER_LINK_DOWN) ? "link" :
+                                  (stats.reason == APP_CAPTURE_TRIGGER_CRC) ? "crc" :
+                                  (stats.reason == APP_CAPTURE_TRIGGER_MANUAL) ? "manual" : "none");
+}
+
 /**
  * @brief     lan8720 full function
  * @param[in] argc arg numbers
@@ -75,12 +619,35 @@ uint8_t lan8720(uint8_t argc, char **argv)
         {"addr", required_argument, NULL, 1},
         {"name", required_argument, NULL, 2},
         {"operate", required_argument, NULL, 3},
+        {"stats", optional_argument, NULL, 4},
+        {"trace", optional_argument, NULL, 5},
+        {"mode", required_argument, NULL, 6},
+        {"ip", required_argument, NULL, 7},
+        {"duration", required_argument, NULL, 8},
+        {"size", required_argument, NULL, 9},
+        {"rate", required_argument, NULL, 10},
+        {"burst", required_argument, NULL, 11},
+        {"count", required_argument, NULL, 12},
+        {"dst", required_argument, NULL, 13},
+        {"loopback", no_argument, NULL, 14},
+        {"udp", no_argument, NULL, 15},
+        {"capture", required_argument, NULL, 16},
+        {"snaplen", required_argument, NULL, 17},
+        {"pre", required_argument, NULL, 18},
+        {"post", required_argument, NULL, 19},
+        {"event", required_argument, NULL, 20},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
     char name[33] = "www.bing.com";
     uint8_t addr = 0x01;
-    uint8_t operate = 0x02;
+    uint8_t operate = 0xFF;
+    char ip[17] = {0};
+    uint8_t client = 0;
+    uint32_t duration = 10;
+    app_pktgen_config_t pktgen = {{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}, 64, 0, 1, 0, 0, 0, 0, 0};
+    uint8_t dst = 0;
+    app_capture_config_t capture = {APP_CAPTURE_SNAPLEN, 0, 0, 0};
 
     /* if no params */
     if (argc == 1)
@@ -181,6 +748,238 @@ uint8_t lan8720(uint8_t argc, char **argv)
                 {
                     operate = 1;
                 }
+                else if (strcmp(optarg, "perf") == 0)
+                {
+                    operate = 2;
+                }
+                else if (strcmp(optarg, "pktgen") == 0)
+                {
+                    operate = 3;
+                }
+                else if (strcmp(optarg, "telemetry") == 0)
+                {
+                    operate = 4;
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* stats */
+            case 4 :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                if (optarg == NULL)
+                {
+                    snprintf(type, 32, "s");
+                }
+                else if (strcmp(optarg, "reset") == 0)
+                {
+                    snprintf(type, 32, "s_reset");
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* trace */
+            case 5 :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                if (optarg == NULL)
+                {
+                    snprintf(type, 32, "r");
+                }
+                else if (strcmp(optarg, "reset") == 0)
+                {
+                    snprintf(type, 32, "r_reset");
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* mode */
+            case 6 :
+            {
+                if (strcmp(optarg, "server") == 0)
+                {
+                    client = 0;
+                }
+                else if (strcmp(optarg, "client") == 0)
+                {
+                    client = 1;
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* ip */
+            case 7 :
+            {
+                /* set the perf server address */
+                memset(ip, 0, sizeof(char) * 17);
+                snprintf(ip, 16, "%s", optarg);
+
+                break;
+            }
+
+            /* duration */
+            case 8 :
+            {
+                /* set the perf client or the pktgen time */
+                duration = atoi(optarg);
+
+                break;
+            }
+
+            /* size */
+            case 9 :
+            {
+                /* set the pktgen frame size */
+                pktgen.size = (uint16_t)atoi(optarg);
+
+                break;
+            }
+
+            /* rate */
+            case 10 :
+            {
+                /* set the pktgen frames per second */
+                pktgen.rate = (uint32_t)atoi(optarg);
+
+                break;
+            }
+
+            /* burst */
+            case 11 :
+            {
+                /* set the pktgen frames sent back to back */
+                pktgen.burst = (uint32_t)atoi(optarg);
+
+                break;
+            }
+
+            /* count */
+            case 12 :
+            {
+                /* set the pktgen frames to send */
+                pktgen.count = (uint32_t)atoi(optarg);
+
+                break;
+            }
+
+            /* dst */
+            case 13 :
+            {
+                /* set the pktgen destination */
+                if (a_mac_parse(optarg, pktgen.dst) != 0)
+                {
+                    return 5;
+                }
+                dst = 1;
+
+                break;
+            }
+
+            /* loopback */
+            case 14 :
+            {
+                /* send over the phy near end loopback */
+                pktgen.loopback = 1;
+
+                break;
+            }
+
+            /* udp */
+            case 15 :
+            {
+                /* send udp datagrams to the stack receiver */
+                pktgen.udp = 1;
+
+                break;
+            }
+
+            /* capture */
+            case 16 :
+            {
+                /* set the type */
+                memset(type, 0, sizeof(char) * 33);
+                if ((strcmp(optarg, "arm") == 0) || (strcmp(optarg, "trigger") == 0) ||
+                    (strcmp(optarg, "stop") == 0) || (strcmp(optarg, "dump") == 0))
+                {
+                    snprintf(type, 32, "c_%s", optarg);
+                }
+                else
+                {
+                    return 5;
+                }
+
+                break;
+            }
+
+            /* snaplen */
+            case 17 :
+            {
+                /* set the capture bytes kept of a frame */
+                capture.snaplen = (uint16_t)atoi(optarg);
+
+                break;
+            }
+
+            /* pre */
+            case 18 :
+            {
+                /* set the capture frames kept before the trigger */
+                capture.pre = (uint32_t)atoi(optarg);
+
+                break;
+            }
+
+            /* post */
+            case 19 :
+            {
+                /* set the capture frames recorded after the trigger */
+                capture.post = (uint32_t)atoi(optarg);
+
+                break;
+            }
+
+            /* event */
+            case 20 :
+            {
+                /* set the capture trigger */
+                if (strcmp(optarg, "none") == 0)
+                {
+                    capture.trigger = 0;
+                }
+                else if (strcmp(optarg, "link") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_LINK_DOWN;
+                }
+                else if (strcmp(optarg, "crc") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_CRC;
+                }
+                else if (strcmp(optarg, "all") == 0)
+                {
+                    capture.trigger = APP_CAPTURE_TRIGGER_LINK_DOWN | APP_CAPTURE_TRIGGER_CRC;
+                }
                 else
                 {
                     return 5;
@@ -218,10 +1017,25 @@ uint8_t lan8720(uint8_t argc, char **argv)
     {
         if (operate == 0)
         {
+            /* keep the dhcp lease in the backup sram */
+            __HAL_RCC_PWR_CLK_ENABLE();
+            HAL_PWR_EnableBkUpAccess();
+            __HAL_RCC_BKPSRAM_CLK_ENABLE();
+            (void)HAL_PWREx_EnableBkUpReg();
+            if (a_lease_clock_init() != 0)
+            {
+                lan8720_interface_debug_print("lan8720: lease clock init failed, no init-reboot.\n");
+            }
+            lwip_server_set_lease_storage(a_lease_load, a_lease_save, a_lease_clock);
+            
             /* initialize the lwip stack */
             eth_set_address(addr);
             lwip_init();
             netif_config();
+            app_dns_init();
+            app_pktgen_init();
+            app_udp_zc_init();
+            app_capture_init();
             
             lan8720_interface_debug_print("start dhcp.\n");
             
@@ -231,22 +1045,52 @@ uint8_t lan8720(uint8_t argc, char **argv)
         {
             ip_addr_t ip_addr;
             
-            /* run dns */
-            err_t err = dns_gethostbyname(name, &ip_addr, NULL, NULL);
+            /* run dns, a cached name is answered at once */
+            err_t err = app_dns_resolve(name, &ip_addr, a_dns_found, NULL);
             if (err == ERR_OK)
             {
-                char output[32] = {0};
-                
-                ipaddr_ntoa_r(&ip_addr, output, 32);
-                lan8720_interface_debug_print("%s dns: %s\n", name, output);
+                a_dns_found(name, &ip_addr, NULL);
             }
-            else
+            else if (err != ERR_INPROGRESS)
             {
                 lan8720_interface_debug_print("dns error.\n");
             }
             
             return 0;
         }
+        else if (operate == 2)
+        {
+            /* run the lwiperf server or client */
+            return a_perf_start(client, ip, duration);
+        }
+        else if (operate == 3)
+        {
+            /* a loopback run sends to itself unless told otherwise */
+            if ((pktgen.loopback != 0) && (dst == 0))
+            {
+                memcpy(pktgen.dst, netif_get_handle()->hwaddr, 6);
+            }
+            pktgen.duration_ms = duration * 1000U;
+            if (ip[0] != 0)
+            {
+                ip4_addr_t ip4;
+                
+                /* the udp destination, the own address by default */
+                if (ip4addr_aton(ip, &ip4) == 0)
+                {
+                    return 5;
+                }
+                pktgen.ip = ip4_addr_get_u32(&ip4);
+            }
+            
+            /* run the packet generator */
+            return a_pktgen_start(&pktgen);
+        }
+        else if (operate == 4)
+        {
+            /* stream the telemetry blocks */
+            return a_telemetry_start(ip, pktgen.size, pktgen.count, duration);
+        }
         else
         {
             lan8720_interface_debug_print("operate is invalid:\n");
@@ -254,6 +1098,220 @@ uint8_t lan8720(uint8_t argc, char **argv)
             return 5;
         }
     }
+    else if (strcmp("s", type) == 0)
+    {
+        const ethernetif_stats_t *stats = ethernetif_get_stats();
+        lwip_server_rate_t rate;
+        app_dns_stats_t dns;
+        lwip_server_arp_stats_t arp;
+        app_pktgen_stats_t pktgen_stats;
+        app_udp_zc_stats_t zc;
+        uart_tx_stats_t log;
+        uint32_t i;
+
+        /* print the interface statistics */
+        lan8720_interface_debug_print("lan8720: rx frames %u bytes %u copybreak %u.\n",
+                                      (unsigned int)stats->rx_frames, (unsigned int)stats->rx_bytes,
+                                      (unsigned int)stats->rx_copybreak);
+        lan8720_interface_debug_print("lan8720: rx fast path frames %u bytes %u passed %u.\n",
+                                      (unsigned int)stats->rx_fastpath, (unsigned int)stats->rx_fastpath_bytes,
+                                      (unsigned int)stats->rx_fastpath_pass);
+        lan8720_interface_debug_print("lan8720: rx drop no buffer %u overflow %u stack %u.\n",
+                                      (unsigned int)stats->rx_drop_no_buffer, (unsigned int)stats->rx_drop_overflow,
+                                      (unsigned int)stats->rx_drop_stack);
+        lan8720_interface_debug_print("lan8720: rx pool in use %u max %u low %u empty %u refill %u stall %u.\n",
+                                      (unsigned int)stats->rx_pool_in_use, (unsigned int)stats->rx_pool_max,
+                                      (unsigned int)stats->rx_pool_low, (unsigned int)stats->rx_pool_empty,
+                                      (unsigned int)stats->rx_refill, (unsigned int)stats->rx_stall);
+        lan8720_interface_debug_print("lan8720: rx irq %u poll %u exhausted %u ring empty %u.\n",
+                                      (unsigned int)stats->rx_irq, (unsigned int)stats->rx_poll,
+                                      (unsigned int)stats->rx_poll_exhausted, (unsigned int)stats->rx_ring_empty);
+        lan8720_interface_debug_print("lan8720: tx frames %u bytes %u errors %u zero copy %u linearized %u.\n",
+                                      (unsigned int)stats->tx_frames, (unsigned int)stats->tx_bytes,
+                                      (unsigned int)stats->tx_errors, (unsigned int)stats->tx_zero_copy,
+                                      (unsigned int)stats->tx_linearized);
+        lan8720_interface_debug_print("lan8720: tx ring in use %u max %u full %u bounce busy %u.\n",
+                                      (unsigned int)stats->tx_ring_in_use, (unsigned int)stats->tx_ring_max,
+                                      (unsigned int)stats->tx_ring_full, (unsigned int)stats->tx_bounce_busy);
+        lan8720_interface_debug_print("lan8720: tx queue depth %u max %u queued %u full %u.\n",
+                                      (unsigned int)stats->tx_queue_depth, (unsigned int)stats->tx_queue_max,
+                                      (unsigned int)stats->tx_queued, (unsigned int)stats->tx_queue_full);
+        for (i = 0; i < ETH_TX_PRIO_CNT; i++)
+        {
+            lan8720_interface_debug_print("lan8720: tx prio %u frames %u depth %u max %u queued %u full %u wait avg %u max %u us.\n",
+                                          (unsigned int)i, (unsigned int)stats->tx_prio[i].frames,
+                                          (unsigned int)stats->tx_prio[i].depth, (unsigned int)stats->tx_prio[i].depth_max,
+                                          (unsigned int)stats->tx_prio[i].queued, (unsigned int)stats->tx_prio[i].full,
+                                          (unsigned int)((stats->tx_prio[i].queued != 0) ?
+                                                         (stats->tx_prio[i].wait_sum_us / stats->tx_prio[i].queued) : 0),
+                                          (unsigned int)stats->tx_prio[i].wait_max_us);
+        }
+        lan8720_interface_debug_print("lan8720: tx bulk ring bytes %u held %u.\n",
+                                      (unsigned int)stats->tx_bulk_ring_bytes, (unsigned int)stats->tx_bulk_held);
+        lan8720_interface_debug_print("lan8720: mmc tx good %u collisions %u rx good unicast %u crc %u alignment %u.\n",
+                                      (unsigned int)stats->mmc_tx_good, (unsigned int)stats->mmc_tx_collisions,
+                                      (unsigned int)stats->mmc_rx_good_unicast, (unsigned int)stats->mmc_rx_crc_errors,
+                                      (unsigned int)stats->mmc_rx_alignment_errors);
+        lan8720_interface_debug_print("lan8720: phy symbol errors %u link up %u down %u.\n",
+                                      (unsigned int)stats->phy_symbol_errors, (unsigned int)stats->link_up,
+                                      (unsigned int)stats->link_down);
+        lan8720_interface_debug_print("lan8720: link outage %u ms traffic %u ms flap penalty %u held %u suppressed %u.\n",
+                                      (unsigned int)stats->link_outage_ms, (unsigned int)stats->link_traffic_ms,
+                                      (unsigned int)stats->flap_penalty, (unsigned int)stats->flap_held,
+                                      (unsigned int)stats->flap_suppressed);
+        lan8720_interface_debug_print("lan8720: pause tx %u rx %u frames %u resume %u.\n",
+                                      (unsigned int)stats->pause_tx_enabled, (unsigned int)stats->pause_rx_enabled,
+                                      (unsigned int)stats->pause_frames, (unsigned int)stats->pause_resume_frames);
+        lan8720_interface_debug_print("lan8720: duplex half %u parallel %u fault %u collisions %u errors %u mismatch %u/%u forced %u.\n",
+                                      (unsigned int)stats->duplex_half, (unsigned int)stats->duplex_parallel_detect,
+                                      (unsigned int)stats->duplex_pd_fault, (unsigned int)stats->duplex_collisions,
+                                      (unsigned int)stats->duplex_rx_errors, (unsigned int)stats->duplex_mismatch,
+                                      (unsigned int)stats->duplex_mismatch_events, (unsigned int)stats->duplex_forced);
+        lan8720_interface_debug_print("lan8720: multicast groups %u overflow %u errors %u.\n",
+                                      (unsigned int)stats->mcast_groups, (unsigned int)stats->mcast_overflow,
+                                      (unsigned int)stats->mcast_filter_errors);
+        lwip_server_get_arp_stats(&arp);
+        lan8720_interface_debug_print("lan8720: arp announces %u prewarms %u gateway %u ms timeouts %u.\n",
+                                      (unsigned int)arp.announces, (unsigned int)arp.prewarms,
+                                      (unsigned int)arp.gateway_ms, (unsigned int)arp.gateway_timeouts);
+        app_dns_get_stats(&dns);
+        lan8720_interface_debug_print("lan8720: dns lookups %u hits %u misses %u prefetches %u failures %u evictions %u latency avg %u max %u ms.\n",
+                                      (unsigned int)dns.lookups, (unsigned int)dns.hits, (unsigned int)dns.misses,
+                                      (unsigned int)dns.prefetches, (unsigned int)dns.failures, (unsigned int)dns.evictions,
+                                      (unsigned int)((dns.answers != 0) ? (dns.latency_sum / dns.answers) : 0),
+                                      (unsigned int)dns.latency_max);
+        lwip_server_get_rate(&rate);
+        lan8720_interface_debug_print("lan8720: rate rx %u fps %u Bps tx %u fps %u Bps.\n",
+                                      (unsigned int)rate.rx_frames, (unsigned int)rate.rx_bytes,
+                                      (unsigned int)rate.tx_frames, (unsigned int)rate.tx_bytes);
+        app_pktgen_get_stats(&pktgen_stats);
+        a_pktgen_print(&pktgen_stats);
+        app_udp_zc_get_stats(&zc);
+        lan8720_interface_debug_print("lan8720: udp zc sent %u bytes %u busy %u errors %u in flight %u max %u release avg %u max %u us.\n",
+                                      (unsigned int)zc.sent, (unsigned int)zc.bytes, (unsigned int)zc.busy,
+                                      (unsigned int)zc.errors, (unsigned int)zc.in_flight, (unsigned int)zc.in_flight_max,
+                                      (unsigned int)((zc.release_cnt != 0) ? (zc.release_sum_us / zc.release_cnt) : 0),
+                                      (unsigned int)zc.release_max_us);
+        a_capture_print();
+        uart_get_tx_stats(&log);
+        lan8720_interface_debug_print("lan8720: log bytes %u dropped %u/%u bytes ring %u max %u/%u.\n",
+                                      (unsigned int)log.bytes, (unsigned int)log.dropped, (unsigned int)log.dropped_bytes,
+                                      (unsigned int)log.level, (unsigned int)log.level_max, (unsigned int)UART_TX_RING_LEN);
+        lan8720_interface_debug_print("lan8720: loop wakeups %u idle %u/%u ms deadline late avg %u max %u ms.\n",
+                                      (unsigned int)gs_loop_wakeups, (unsigned int)gs_loop_idle_ms,
+                                      (unsigned int)(HAL_GetTick() - gs_loop_start),
+                                      (unsigned int)((gs_loop_deadlines != 0) ? (gs_loop_late_sum / gs_loop_deadlines) : 0),
+                                      (unsigned int)gs_loop_late_max);
+
+        return 0;
+    }
+    else if (strcmp("s_reset", type) == 0)
+    {
+        /* reset the interface statistics */
+        ethernetif_reset_stats();
+        app_dns_reset_stats();
+        app_pktgen_reset_stats();
+        app_udp_zc_reset_stats();
+        uart_reset_tx_stats();
+        gs_loop_start = HAL_GetTick();
+        gs_loop_wakeups = 0;
+        gs_loop_idle_ms = 0;
+        gs_loop_deadlines = 0;
+        gs_loop_late_sum = 0;
+        gs_loop_late_max = 0;
+        lan8720_interface_debug_print("lan8720: stats reset.\n");
+
+        return 0;
+    }
+    else if (strcmp("r", type) == 0)
+    {
+#if TRACE_ENABLE
+        trace_stat_t stat;
+        uint32_t probe;
+
+        /* print the trace probes */
+        lan8720_interface_debug_print("lan8720: trace unit is %s, probe overhead is %u.\n",
+                                      trace_get_unit(), (unsigned int)trace_get_overhead());
+        for (probe = 0; probe < TRACE_PROBE_MAX; probe++)
+        {
+            (void)trace_get((trace_probe_t)probe, &stat);
+            lan8720_interface_debug_print("lan8720: %s count %u min %u avg %u max %u.\n",
+                                          trace_get_name((trace_probe_t)probe), (unsigned int)stat.count,
+                                          (unsigned int)stat.min,
+                                          (unsigned int)((stat.count != 0) ? (stat.sum / stat.count) : 0),
+                                          (unsigned int)stat.max);
+        }
+#else
+        lan8720_interface_debug_print("lan8720: trace is disabled, build with TRACE_ENABLE 1.\n");
+#endif
+
+        return 0;
+    }
+    else if (strcmp("r_reset", type) == 0)
+    {
+        /* reset the trace probes */
+        trace_reset();
+        lan8720_interface_debug_print("lan8720: trace reset.\n");
+
+        return 0;
+    }
+    else if (strcmp("c_arm", type) == 0)
+    {
+        /* record the frames into the ring until the trigger */
+        if (app_capture_arm(&capture) != ERR_OK)
+        {
+            return 5;
+        }
+        lan8720_interface_debug_print("lan8720: capture armed, snaplen %u pre %u post %u.\n",
+                                      (unsigned int)capture.snaplen, (unsigned int)capture.pre,
+                                      (unsigned int)capture.post);
+
+        return 0;
+    }
+    else if (strcmp("c_trigger", type) == 0)
+    {
+        /* trigger by hand */
+        app_capture_trigger(APP_CAPTURE_TRIGGER_MANUAL);
+        a_capture_print();
+
+        return 0;
+    }
+    else if (strcmp("c_stop", type) == 0)
+    {
+        /* stop recording, the ring is kept */
+        app_capture_stop();
+        a_capture_print();
+
+        return 0;
+    }
+    else if (strcmp("c_dump", type) == 0)
+    {
+        const char hex[] = "0123456789abcdef";
+        uint8_t buf[32];
+        char line[65];
+        uint32_t size;
+        uint32_t len;
+        uint32_t i;
+
+        /* print the pcap file as plain hex, xxd -r -p turns it back into the file */
+        size = app_capture_open();
+        a_capture_print();
+        lan8720_interface_debug_print("lan8720: capture pcap %u bytes, convert the lines below with xxd -r -p.\n",
+                                      (unsigned int)size);
+        while ((len = app_capture_read(buf, 32)) != 0)
+        {
+            for (i = 0; i < len; i++)
+            {
+                line[i * 2] = hex[buf[i] >> 4];
+                line[i * 2 + 1] = hex[buf[i] & 0xF];
+            }
+            line[len * 2] = '\0';
+            lan8720_interface_debug_print("%s\n", line);
+        }
+        lan8720_interface_debug_print("lan8720: capture dump done.\n");
+
+        return 0;
+    }
     else if (strcmp("h", type) == 0)
     {
         help:
@@ -263,16 +1321,48 @@ uint8_t lan8720(uint8_t argc, char **argv)
         lan8720_interface_debug_print("  lan8720 (-p | --port)\n");
         lan8720_interface_debug_print("  lan8720 (-t reg | --test=reg) [--addr=<num>]\n");
         lan8720_interface_debug_print("  lan8720 (-e net | --example=net) (--operate=<init | dns>) [--addr=<num>] [--name=<domain>]\n");
+        lan8720_interface_debug_print("  lan8720 (-e net | --example=net) --operate=perf [--mode=<server | client>] [--ip=<address>] [--duration=<s>]\n");
+        lan8720_interface_debug_print("  lan8720 (-e net | --example=net) --operate=pktgen [--size=<64 - 1518>] [--rate=<pps>] [--burst=<num>]\n");
+        lan8720_interface_debug_print("          [--count=<num>] [--duration=<s>] [--dst=<mac>] [--loopback] [--udp [--ip=<address>]]\n");
+        lan8720_interface_debug_print("  lan8720 (-e net | --example=net) --operate=telemetry [--size=<8 - 1472>] [--count=<num>] [--duration=<s>] [--ip=<address>]\n");
+        lan8720_interface_debug_print("  lan8720 --capture=<arm | trigger | stop | dump> [--snaplen=<14 - 1514>] [--pre=<num>] [--post=<num>]\n");
+        lan8720_interface_debug_print("          [--event=<none | link | crc | all>]\n");
+        lan8720_interface_debug_print("  lan8720 --stats[=reset]\n");
+        lan8720_interface_debug_print("  lan8720 --trace[=reset]\n");
         lan8720_interface_debug_print("\n");
         lan8720_interface_debug_print("Options:\n");
         lan8720_interface_debug_print("      --addr=<num>                  Set the chip address number.([default: 1])\n");
+        lan8720_interface_debug_print("      --burst=<num>                 Set the pktgen frames sent back to back at the rate.([default: 1])\n");
+        lan8720_interface_debug_print("      --capture=<arm | trigger | stop | dump>\n");
+        lan8720_interface_debug_print("                                    Arm the capture ring, trigger it by hand, stop it or dump it as pcap hex.\n");
+        lan8720_interface_debug_print("      --count=<num>                 Set the pktgen frames or telemetry blocks to send, 0 sends until the duration ends.([default: 0])\n");
+        lan8720_interface_debug_print("      --dst=<mac>                   Set the pktgen destination.([default: ff:ff:ff:ff:ff:ff, the own address with --loopback])\n");
+        lan8720_interface_debug_print("      --duration=<s>                Set the perf client, pktgen or telemetry send time.([default: 10])\n");
         lan8720_interface_debug_print("  -e <net>, --example=<net>         Run the driver example.\n");
+        lan8720_interface_debug_print("      --event=<none | link | crc | all>\n");
+        lan8720_interface_debug_print("                                    Set the capture trigger.([default: none])\n");
         lan8720_interface_debug_print("  -h, --help                        Show the help.\n");
         lan8720_interface_debug_print("  -i, --information                 Show the chip information.\n");
+        lan8720_interface_debug_print("      --ip=<address>                Set the perf server address of the client or the pktgen or telemetry udp destination.\n");
+        lan8720_interface_debug_print("                                    ([default: the gateway, the own address for pktgen])\n");
+        lan8720_interface_debug_print("      --loopback                    Send the pktgen frames over the phy near end loopback.\n");
+        lan8720_interface_debug_print("      --mode=<server | client>      Set the perf mode.([default: server])\n");
         lan8720_interface_debug_print("      --name=<domain>               Set domain name.([default: www.bing.com])\n");
-        lan8720_interface_debug_print("      --operate=<init | dns>        Set operate, init is init the net and dns is running the dns.\n");
+        lan8720_interface_debug_print("      --operate=<init | dns | perf | pktgen | telemetry>\n");
+        lan8720_interface_debug_print("                                    Set operate, init is init the net, dns is running the dns, perf is running lwiperf\n");
+        lan8720_interface_debug_print("                                    pktgen is running the raw frame generator and telemetry is streaming udp blocks\n");
+        lan8720_interface_debug_print("                                    without a copy.\n");
         lan8720_interface_debug_print("  -p, --port                        Display the pins used by this device to connect the chip.\n");
+        lan8720_interface_debug_print("      --post=<num>                  Set the capture frames recorded after the trigger.([default: 0])\n");
+        lan8720_interface_debug_print("      --pre=<num>                   Set the capture frames kept before the trigger, 0 keeps the whole ring.([default: 0])\n");
+        lan8720_interface_debug_print("      --rate=<pps>                  Set the pktgen frames per second, 0 sends at the line rate.([default: 0])\n");
+        lan8720_interface_debug_print("      --size=<64 - 1518>            Set the pktgen frame size with the fcs.([default: 64])\n");
+        lan8720_interface_debug_print("                                    The telemetry block size is 8 - 1472.\n");
+        lan8720_interface_debug_print("      --snaplen=<14 - 1514>         Set the capture bytes kept of a frame.([default: 128])\n");
+        lan8720_interface_debug_print("      --stats[=reset]               Show the interface statistics, reset clears them.\n");
+        lan8720_interface_debug_print("      --trace[=reset]               Show the hot path trace probes, reset clears them.\n");
         lan8720_interface_debug_print("  -t <reg>, --test=<reg>            Run the driver test.\n");
+        lan8720_interface_debug_print("      --udp                         Send the pktgen frames as udp datagrams through the lwip receiver.\n");
 
         return 0;
     }
@@ -323,6 +1413,10 @@ uint8_t lan8720(uint8_t argc, char **argv)
 int main(void)
 {
     uint8_t res;
+    uint32_t start;
+    uint32_t sleep;
+    uint32_t wake;
+    uint32_t late;
 
     /* stm32f407 clock init and hal init */
     clock_init();
@@ -330,6 +1424,9 @@ int main(void)
     /* delay init */
     delay_init();
 
+    /* trace init */
+    trace_init();
+
     /* uart init */
     uart_init(115200);
 
@@ -337,13 +1434,17 @@ int main(void)
     shell_init();
     shell_register("lan8720", lan8720);
     uart_print("lan8720: welcome to libdriver lan8720.\n");
+    gs_loop_start = HAL_GetTick();
     
     while (1)
     {
-        /* read uart */
-        g_len = uart_read(g_buf, 256);
+        /* read uart once a byte has arrived */
+        g_len = (uart_get_rx_len() != 0) ? uart_read(g_buf, 256) : 0;
         if (g_len != 0)
         {
+            /* the shell output may fill the log ring, so wait for room instead of dropping it */
+            uart_set_tx_wait(1);
+            
             /* run shell */
             res = shell_parse((char *)g_buf, g_len);
             if (res == 0)
@@ -374,9 +1475,56 @@ int main(void)
             {
                 uart_print("lan8720: unknown status code.\n");
             }
+            uart_set_tx_wait(0);
             uart_flush();
         }
         lwip_server();
-        delay_ms(100);
+        app_pktgen_poll();
+        app_telemetry_poll();
+        app_capture_poll();
+        gs_loop_wakeups++;
+        
+        /* sleep until the next lwip, pktgen, telemetry or capture deadline, the eth and uart interrupts wake up early */
+        start = HAL_GetTick();
+        sleep = lwip_server_sleeptime();
+        wake = app_pktgen_sleeptime();
+        if (wake < sleep)
+        {
+            sleep = wake;
+        }
+        wake = app_telemetry_sleeptime();
+        if (wake < sleep)
+        {
+            sleep = wake;
+        }
+        wake = app_capture_sleeptime();
+        if (wake < sleep)
+        {
+            sleep = wake;
+        }
+        while ((HAL_GetTick() - start) < sleep)
+        {
+            /* check with the interrupts masked, a pending interrupt still ends wfi */
+            __disable_irq();
+            if ((ethernetif_pending() != 0) || (uart_get_rx_len() != 0))
+            {
+                __enable_irq();
+                
+                break;
+            }
+            __WFI();
+            __enable_irq();
+        }
+        gs_loop_idle_ms += HAL_GetTick() - start;
+        if ((HAL_GetTick() - start) >= sleep)
+        {
+            late = HAL_GetTick() - start - sleep;
+            gs_loop_deadlines++;
+            gs_loop_late_sum += late;
+            if (late > gs_loop_late_max)
+            {
+                gs_loop_late_max = late;
+            }
+        }
     }
 }
@@ -37,6 +37,7 @@
 #include "stm32f4xx_it.h"
 #include "app_lwip.h"
 #include "eth.h"
+#include "trace.h"
 #include "uart.h"
 
 /**
@@ -220,7 +221,10 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
  */
 void ETH_IRQHandler(void)
 {
+    TRACE_BEGIN(TRACE_PROBE_ETH_IRQ);
+    
     HAL_ETH_IRQHandler(eth_get_handle());
+    TRACE_END(TRACE_PROBE_ETH_IRQ);
 }
 
 /**
@@ -230,5 +234,25 @@ void ETH_IRQHandler(void)
  */
 void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
 {
-    ethernetif_input(netif_get_handle());
+    ethernetif_rx_irq(netif_get_handle());
+}
+
+/**
+ * @brief     eth tx complete callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_TxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    ethernetif_tx_irq();
+}
+
+/**
+ * @brief     eth error callback
+ * @param[in] *heth pointer to an eth handle
+ * @note      none
+ */
+void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth)
+{
+    ethernetif_error_irq(heth->DMAErrorCode);
 }
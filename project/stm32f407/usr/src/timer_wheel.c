@@ -0,0 +1,329 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      timer_wheel.c
+ * @brief     timer wheel source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2026-10-18
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2026/10/18  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "timer_wheel.h"
+#include <string.h>
+
+/**
+ * @brief     timer wheel find the first non empty slot
+ * @param[in] bitmap slot bitmap
+ * @param[in] start first slot to look at
+ * @return    slot distance from start, TIMER_WHEEL_SLOT if the bitmap is empty
+ * @note      none
+ */
+static uint32_t a_timer_wheel_first(uint64_t bitmap, uint32_t start)
+{
+    uint32_t i;
+    
+    if (bitmap == 0)
+    {
+        return TIMER_WHEEL_SLOT;
+    }
+    
+    /* rotate the start slot to bit 0 */
+    bitmap = (bitmap >> start) | ((start != 0) ? (bitmap << (TIMER_WHEEL_SLOT - start)) : 0);
+    
+    /* count the trailing zeros */
+#if defined(__GNUC__)
+    i = (uint32_t)__builtin_ctzll(bitmap);
+#else
+    for (i = 0; (bitmap & 1) == 0; i++)
+    {
+        bitmap >>= 1;
+    }
+#endif
+    
+    return i;
+}
+
+/**
+ * @brief     timer wheel insert a timer into its slot
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @note      the level comes from the distance between the wheel tick and the expiry
+ */
+static void a_timer_wheel_insert(timer_wheel_t *wheel, timer_wheel_timer_t *timer)
+{
+    uint32_t delta;
+    uint32_t expire;
+    uint8_t level;
+    uint8_t slot;
+    
+    /* pick the level */
+    expire = timer->expire;
+    delta = expire - wheel->now;
+    if (delta < (1UL << TIMER_WHEEL_SLOT_BITS))
+    {
+        level = 0;
+    }
+    else if (delta < (1UL << (2 * TIMER_WHEEL_SLOT_BITS)))
+    {
+        level = 1;
+    }
+    else
+    {
+        level = 2;
+        if (delta >= (1UL << (3 * TIMER_WHEEL_SLOT_BITS)))
+        {
+            /* park in the last slot of the rotation, it is cascaded again */
+            expire = wheel->now + (1UL << (3 * TIMER_WHEEL_SLOT_BITS)) - 1;
+        }
+    }
+    slot = (uint8_t)((expire >> (level * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOT - 1));
+    
+    /* push to the slot list */
+    timer->level = level;
+    timer->slot = slot;
+    timer->prev = NULL;
+    timer->next = wheel->slot[level][slot];
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer;
+    }
+    wheel->slot[level][slot] = timer;
+    wheel->bitmap[level] |= 1ULL << slot;
+    timer->active = 1;
+}
+
+/**
+ * @brief     timer wheel unlink a timer from its slot
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @note      none
+ */
+static void a_timer_wheel_unlink(timer_wheel_t *wheel, timer_wheel_timer_t *timer)
+{
+    if (timer->prev != NULL)
+    {
+        timer->prev->next = timer->next;
+    }
+    else
+    {
+        wheel->slot[timer->level][timer->slot] = timer->next;
+    }
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+    if (wheel->slot[timer->level][timer->slot] == NULL)
+    {
+        wheel->bitmap[timer->level] &= ~(1ULL << timer->slot);
+    }
+    timer->next = NULL;
+    timer->prev = NULL;
+    timer->active = 0;
+}
+
+/**
+ * @brief     timer wheel cascade an upper level slot
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] level upper level
+ * @param[in] slot slot index
+ * @note      the timers move to the lower levels
+ */
+static void a_timer_wheel_cascade(timer_wheel_t *wheel, uint8_t level, uint8_t slot)
+{
+    timer_wheel_timer_t *timer;
+    
+    while ((timer = wheel->slot[level][slot]) != NULL)
+    {
+        a_timer_wheel_unlink(wheel, timer);
+        a_timer_wheel_insert(wheel, timer);
+    }
+}
+
+/**
+ * @brief     timer wheel get the ticks from the wheel tick to the next work
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @return    ticks to the next expiry or cascade, TIMER_WHEEL_NONE if no timer is pending
+ * @note      none
+ */
+static uint32_t a_timer_wheel_next(timer_wheel_t *wheel)
+{
+    uint32_t next = TIMER_WHEEL_NONE;
+    uint32_t block;
+    uint32_t delta;
+    uint32_t k;
+    uint8_t level;
+    
+    /* level 0 holds the exact expiries of the next 63 ticks */
+    k = a_timer_wheel_first(wheel->bitmap[0], (wheel->now + 1) & (TIMER_WHEEL_SLOT - 1));
+    if (k < TIMER_WHEEL_SLOT)
+    {
+        next = k + 1;
+    }
+    
+    /* the upper levels report their cascade ticks */
+    for (level = 1; level < TIMER_WHEEL_LEVEL; level++)
+    {
+        block = (wheel->now >> (level * TIMER_WHEEL_SLOT_BITS)) + 1;
+        k = a_timer_wheel_first(wheel->bitmap[level], block & (TIMER_WHEEL_SLOT - 1));
+        if (k < TIMER_WHEEL_SLOT)
+        {
+            delta = ((block + k) << (level * TIMER_WHEEL_SLOT_BITS)) - wheel->now;
+            if (delta < next)
+            {
+                next = delta;
+            }
+        }
+    }
+    
+    return next;
+}
+
+/**
+ * @brief     timer wheel init
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @note      none
+ */
+void timer_wheel_init(timer_wheel_t *wheel, uint32_t now)
+{
+    memset(wheel, 0, sizeof(timer_wheel_t));
+    wheel->now = now;
+}
+
+/**
+ * @brief     timer wheel add a timer
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @param[in] delay ticks until the first expiry, 0 runs at the next tick
+ * @param[in] period reload period in ticks, 0 is one shot
+ * @param[in] callback expire callback
+ * @param[in] *arg callback argument
+ * @note      an active timer is moved, the cost is O(1)
+ */
+void timer_wheel_add(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint32_t delay, uint32_t period,
+                     timer_wheel_callback_t callback, void *arg)
+{
+    if (timer->active != 0)
+    {
+        a_timer_wheel_unlink(wheel, timer);
+    }
+    
+    /* a timer expires one tick after the wheel at the earliest */
+    timer->expire = wheel->now + ((delay != 0) ? delay : 1);
+    timer->period = period;
+    timer->callback = callback;
+    timer->arg = arg;
+    a_timer_wheel_insert(wheel, timer);
+}
+
+/**
+ * @brief     timer wheel remove a timer
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] *timer pointer to a timer structure
+ * @note      an inactive timer is ignored, the cost is O(1)
+ */
+void timer_wheel_remove(timer_wheel_t *wheel, timer_wheel_timer_t *timer)
+{
+    if (timer->active != 0)
+    {
+        a_timer_wheel_unlink(wheel, timer);
+    }
+}
+
+/**
+ * @brief     timer wheel run the expired timers
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @note      the wheel jumps over the ticks without work, callbacks may add and remove timers
+ */
+void timer_wheel_run(timer_wheel_t *wheel, uint32_t now)
+{
+    timer_wheel_timer_t *timer;
+    uint32_t next;
+    uint32_t t;
+    uint8_t slot;
+    
+    while (1)
+    {
+        /* jump to the next tick with work */
+        next = a_timer_wheel_next(wheel);
+        if ((next == TIMER_WHEEL_NONE) || (next > (now - wheel->now)))
+        {
+            break;
+        }
+        wheel->now += next;
+        t = wheel->now;
+        
+        /* cascade the upper levels, the highest first */
+        if ((t & ((1UL << (2 * TIMER_WHEEL_SLOT_BITS)) - 1)) == 0)
+        {
+            a_timer_wheel_cascade(wheel, 2, (uint8_t)((t >> (2 * TIMER_WHEEL_SLOT_BITS)) & (TIMER_WHEEL_SLOT - 1)));
+        }
+        if ((t & ((1UL << TIMER_WHEEL_SLOT_BITS) - 1)) == 0)
+        {
+            a_timer_wheel_cascade(wheel, 1, (uint8_t)((t >> TIMER_WHEEL_SLOT_BITS) & (TIMER_WHEEL_SLOT - 1)));
+        }
+        
+        /* expire the timers of this tick, a reloaded timer never lands in this slot again */
+        slot = (uint8_t)(t & (TIMER_WHEEL_SLOT - 1));
+        while ((timer = wheel->slot[0][slot]) != NULL)
+        {
+            a_timer_wheel_unlink(wheel, timer);
+            if (timer->period != 0)
+            {
+                timer->expire = t + timer->period;
+                a_timer_wheel_insert(wheel, timer);
+            }
+            timer->callback(timer->arg);
+        }
+    }
+    wheel->now = now;
+}
+
+/**
+ * @brief     timer wheel get the ticks until the next expiry
+ * @param[in] *wheel pointer to a timer wheel structure
+ * @param[in] now current tick
+ * @return    ticks until timer_wheel_run() has work, TIMER_WHEEL_NONE if no timer is pending
+ * @note      a timer in an upper level reports its cascade tick, which is never later than its expiry
+ */
+uint32_t timer_wheel_sleeptime(timer_wheel_t *wheel, uint32_t now)
+{
+    uint32_t next;
+    uint32_t elapsed;
+    
+    next = a_timer_wheel_next(wheel);
+    if (next == TIMER_WHEEL_NONE)
+    {
+        return TIMER_WHEEL_NONE;
+    }
+    elapsed = now - wheel->now;
+    
+    return (next > elapsed) ? (next - elapsed) : 0;
+}